@@ -36,9 +36,13 @@ struct lid_switch_dispatch {
 	bool lid_is_closed;
 	bool lid_is_closed_client_state;
 
+	/* The listener is only attached while the lid reports closed and
+	 * no key press has contradicted that yet */
 	struct {
 		struct evdev_device *keyboard;
 		struct libinput_event_listener listener;
+		bool listening;
+		unsigned int ncalls; /* listener invocations */
 	} keyboard;
 };
 
@@ -64,6 +68,10 @@ lid_switch_notify_toggle(struct lid_switch_dispatch *dispatch,
 	}
 }
 
+static void
+lid_switch_toggle_keyboard_listener(struct lid_switch_dispatch *dispatch,
+				    bool is_closed);
+
 static void
 lid_switch_keyboard_event(uint64_t time,
 			  struct libinput_event *event,
@@ -72,10 +80,9 @@ lid_switch_keyboard_event(uint64_t time,
 	struct lid_switch_dispatch *dispatch = lid_dispatch(data);
 	unsigned int temp;
 
-	if (!dispatch->lid_is_closed)
-		return;
+	dispatch->keyboard.ncalls++;
 
-	if (event->type != LIBINPUT_EVENT_KEYBOARD_KEY)
+	if (!dispatch->lid_is_closed)
 		return;
 
 	if (dispatch->reliability == RELIABILITY_WRITE_OPEN) {
@@ -97,6 +104,11 @@ lid_switch_keyboard_event(uint64_t time,
 	 */
 	dispatch->lid_is_closed = false;
 	lid_switch_notify_toggle(dispatch, dispatch->device, time);
+
+	/* The state is known again, stop looking at every key until the
+	 * lid closes next time. The listener list is walked with
+	 * list_for_each_safe, so we can remove ourselves here. */
+	lid_switch_toggle_keyboard_listener(dispatch, false);
 }
 
 static void
@@ -106,10 +118,14 @@ lid_switch_toggle_keyboard_listener(struct lid_switch_dispatch *dispatch,
 	if (!dispatch->keyboard.keyboard)
 		return;
 
+	if (dispatch->keyboard.listening == is_closed)
+		return;
+
 	if (is_closed) {
 		libinput_device_add_event_listener(
 					&dispatch->keyboard.keyboard->base,
 					&dispatch->keyboard.listener,
+					event_listener_mask(LIBINPUT_EVENT_KEYBOARD_KEY),
 					lid_switch_keyboard_event,
 					dispatch);
 	} else {
@@ -118,6 +134,8 @@ lid_switch_toggle_keyboard_listener(struct lid_switch_dispatch *dispatch,
 		libinput_device_init_event_listener(
 					&dispatch->keyboard.listener);
 	}
+
+	dispatch->keyboard.listening = is_closed;
 }
 
 static void
@@ -192,10 +210,12 @@ lid_switch_remove(struct evdev_dispatch *evdev_dispatch)
 {
 	struct lid_switch_dispatch *dispatch = lid_dispatch(evdev_dispatch);
 
-	if (!dispatch->keyboard.keyboard)
-		return;
+	if (dispatch->keyboard.ncalls > 0)
+		evdev_log_debug(dispatch->device,
+				"lid: keyboard listener called %u times\n",
+				dispatch->keyboard.ncalls);
 
-	libinput_device_remove_event_listener(&dispatch->keyboard.listener);
+	lid_switch_toggle_keyboard_listener(dispatch, false);
 }
 
 static void
@@ -248,10 +268,7 @@ lid_switch_interface_device_removed(struct evdev_device *device,
 	struct lid_switch_dispatch *dispatch = lid_dispatch(device->dispatch);
 
 	if (removed_device == dispatch->keyboard.keyboard) {
-		libinput_device_remove_event_listener(
-					&dispatch->keyboard.listener);
-		libinput_device_init_event_listener(
-					&dispatch->keyboard.listener);
+		lid_switch_toggle_keyboard_listener(dispatch, false);
 		dispatch->keyboard.keyboard = NULL;
 	}
 }
@@ -85,32 +85,6 @@ is_inside_bottom_button_area(const struct tp_dispatch *tp,
 	return t->point.y >= tp->buttons.bottom_area.top_edge;
 }
 
-static inline bool
-is_inside_bottom_right_area(const struct tp_dispatch *tp,
-			    const struct tp_touch *t)
-{
-	return is_inside_bottom_button_area(tp, t) &&
-	       t->point.x > tp->buttons.bottom_area.rightbutton_left_edge;
-}
-
-static inline bool
-is_inside_bottom_middle_area(const struct tp_dispatch *tp,
-			   const struct tp_touch *t)
-{
-	return is_inside_bottom_button_area(tp, t) &&
-	       !is_inside_bottom_right_area(tp, t) &&
-	       t->point.x > tp->buttons.bottom_area.middlebutton_left_edge;
-}
-
-static inline bool
-is_inside_bottom_left_area(const struct tp_dispatch *tp,
-			   const struct tp_touch *t)
-{
-	return is_inside_bottom_button_area(tp, t) &&
-	       !is_inside_bottom_middle_area(tp, t) &&
-	       !is_inside_bottom_right_area(tp, t);
-}
-
 static inline bool
 is_inside_top_button_area(const struct tp_dispatch *tp,
 			  const struct tp_touch *t)
@@ -118,43 +92,42 @@ is_inside_top_button_area(const struct tp_dispatch *tp,
 	return t->point.y <= tp->buttons.top_area.bottom_edge;
 }
 
-static inline bool
-is_inside_top_right_area(const struct tp_dispatch *tp,
-			 const struct tp_touch *t)
-{
-	return is_inside_top_button_area(tp, t) &&
-	       t->point.x > tp->buttons.top_area.rightbutton_left_edge;
-}
-
-static inline bool
-is_inside_top_left_area(const struct tp_dispatch *tp,
-			const struct tp_touch *t)
+static inline enum button_event
+tp_softbutton_columns_lookup(const struct tp_softbutton_columns *columns,
+			     int32_t x)
 {
-	return is_inside_top_button_area(tp, t) &&
-	       t->point.x < tp->buttons.top_area.leftbutton_right_edge;
+	return columns->events[(x > columns->edges[0]) +
+			       (x > columns->edges[1])];
 }
 
-static inline bool
-is_inside_top_middle_area(const struct tp_dispatch *tp,
-			  const struct tp_touch *t)
+static inline enum button_event
+tp_button_area_event(const struct tp_dispatch *tp,
+		     const struct tp_touch *t)
 {
-	return is_inside_top_button_area(tp, t) &&
-	       t->point.x >= tp->buttons.top_area.leftbutton_right_edge &&
-	       t->point.x <= tp->buttons.top_area.rightbutton_left_edge;
+	if (is_inside_bottom_button_area(tp, t))
+		return tp_softbutton_columns_lookup(&tp->buttons.bottom_columns,
+						    t->point.x);
+	if (is_inside_top_button_area(tp, t))
+		return tp_softbutton_columns_lookup(&tp->buttons.top_columns,
+						    t->point.x);
+
+	return BUTTON_EVENT_IN_AREA;
 }
 
 static void
 tp_button_set_enter_timer(struct tp_dispatch *tp, struct tp_touch *t)
 {
-	libinput_timer_set(&t->button.timer,
-			   t->time + DEFAULT_BUTTON_ENTER_TIMEOUT);
+	tp_touch_set_deadline(tp,
+			      &tp_touch_ext(t)->button_deadline,
+			      t->time + DEFAULT_BUTTON_ENTER_TIMEOUT);
 }
 
 static void
 tp_button_set_leave_timer(struct tp_dispatch *tp, struct tp_touch *t)
 {
-	libinput_timer_set(&t->button.timer,
-			   t->time + DEFAULT_BUTTON_LEAVE_TIMEOUT);
+	tp_touch_set_deadline(tp,
+			      &tp_touch_ext(t)->button_deadline,
+			      t->time + DEFAULT_BUTTON_LEAVE_TIMEOUT);
 }
 
 /*
@@ -167,7 +140,7 @@ tp_button_set_state(struct tp_dispatch *tp,
 		    enum button_state new_state,
 		    enum button_event event)
 {
-	libinput_timer_cancel(&t->button.timer);
+	tp_touch_cancel_deadline(tp, &tp_touch_ext(t)->button_deadline);
 
 	t->button.state = new_state;
 
@@ -456,31 +429,16 @@ tp_button_handle_state(struct tp_dispatch *tp, uint64_t time)
 {
 	struct tp_touch *t;
 
-	tp_for_each_touch(tp, t) {
+	tp_for_each_active_touch(tp, t) {
 		if (t->state == TOUCH_NONE || t->state == TOUCH_HOVERING)
 			continue;
 
 		if (t->state == TOUCH_END) {
 			tp_button_handle_event(tp, t, BUTTON_EVENT_UP, time);
 		} else if (t->dirty) {
-			enum button_event event;
-
-			if (is_inside_bottom_right_area(tp, t))
-				event = BUTTON_EVENT_IN_BOTTOM_R;
-			else if (is_inside_bottom_middle_area(tp, t))
-				event = BUTTON_EVENT_IN_BOTTOM_M;
-			else if (is_inside_bottom_left_area(tp, t))
-				event = BUTTON_EVENT_IN_BOTTOM_L;
-			else if (is_inside_top_right_area(tp, t))
-				event = BUTTON_EVENT_IN_TOP_R;
-			else if (is_inside_top_middle_area(tp, t))
-				event = BUTTON_EVENT_IN_TOP_M;
-			else if (is_inside_top_left_area(tp, t))
-				event = BUTTON_EVENT_IN_TOP_L;
-			else
-				event = BUTTON_EVENT_IN_AREA;
-
-			tp_button_handle_event(tp, t, event, time);
+			tp_button_handle_event(tp, t,
+					       tp_button_area_event(tp, t),
+					       time);
 		}
 		if (tp->queued & TOUCHPAD_EVENT_BUTTON_RELEASE)
 			tp_button_handle_event(tp, t, BUTTON_EVENT_RELEASE, time);
@@ -489,12 +447,12 @@ tp_button_handle_state(struct tp_dispatch *tp, uint64_t time)
 	}
 }
 
-static void
-tp_button_handle_timeout(uint64_t now, void *data)
+void
+tp_button_handle_timeout(struct tp_dispatch *tp,
+			 struct tp_touch *t,
+			 uint64_t now)
 {
-	struct tp_touch *t = data;
-
-	tp_button_handle_event(t->tp, t, BUTTON_EVENT_TIMEOUT, now);
+	tp_button_handle_event(tp, t, BUTTON_EVENT_TIMEOUT, now);
 }
 
 void
@@ -531,6 +489,41 @@ tp_release_all_buttons(struct tp_dispatch *tp,
 	}
 }
 
+static void
+tp_update_bottom_columns(struct tp_dispatch *tp)
+{
+	struct tp_softbutton_columns *columns = &tp->buttons.bottom_columns;
+	int32_t mb_le = tp->buttons.bottom_area.middlebutton_left_edge,
+		rb_le = tp->buttons.bottom_area.rightbutton_left_edge;
+
+	columns->events[0] = BUTTON_EVENT_IN_BOTTOM_L;
+
+	/* Without a middle button area the middlebutton edge is INT_MAX */
+	if (mb_le < rb_le) {
+		columns->edges[0] = mb_le;
+		columns->edges[1] = rb_le;
+		columns->events[1] = BUTTON_EVENT_IN_BOTTOM_M;
+	} else {
+		columns->edges[0] = rb_le;
+		columns->edges[1] = INT_MAX;
+		columns->events[1] = BUTTON_EVENT_IN_BOTTOM_R;
+	}
+	columns->events[2] = BUTTON_EVENT_IN_BOTTOM_R;
+}
+
+static void
+tp_update_top_columns(struct tp_dispatch *tp)
+{
+	struct tp_softbutton_columns *columns = &tp->buttons.top_columns;
+
+	/* The top left button ends *before* leftbutton_right_edge */
+	columns->edges[0] = tp->buttons.top_area.leftbutton_right_edge - 1;
+	columns->edges[1] = tp->buttons.top_area.rightbutton_left_edge;
+	columns->events[0] = BUTTON_EVENT_IN_TOP_L;
+	columns->events[1] = BUTTON_EVENT_IN_TOP_M;
+	columns->events[2] = BUTTON_EVENT_IN_TOP_R;
+}
+
 static void
 tp_init_softbuttons(struct tp_dispatch *tp,
 		    struct evdev_device *device)
@@ -557,8 +550,10 @@ tp_init_softbuttons(struct tp_dispatch *tp,
 	tp->buttons.bottom_area.middlebutton_left_edge = INT_MAX;
 
 	/* if middlebutton emulation is enabled, don't init a software area */
-	if (device->middlebutton.want_enabled)
+	if (device->middlebutton.want_enabled) {
+		tp_update_bottom_columns(tp);
 		return;
+	}
 
 	/* The middle button is 25% of the touchpad and centered. Many
 	 * touchpads don't have markings for the middle button at all so we
@@ -588,6 +583,7 @@ tp_init_softbuttons(struct tp_dispatch *tp,
 
 	tp->buttons.bottom_area.middlebutton_left_edge = mb_le;
 	tp->buttons.bottom_area.rightbutton_left_edge = mb_re;
+	tp_update_bottom_columns(tp);
 }
 
 void
@@ -617,6 +613,7 @@ tp_init_top_softbuttons(struct tp_dispatch *tp,
 		mm.x = width * 0.40;
 		edges = evdev_device_mm_to_units(device, &mm);
 		tp->buttons.top_area.leftbutton_right_edge = edges.x;
+		tp_update_top_columns(tp);
 	} else {
 		tp->buttons.top_area.bottom_edge = INT_MIN;
 	}
@@ -870,12 +867,8 @@ tp_init_buttons(struct tp_dispatch *tp,
 
 	tp_init_middlebutton_emulation(tp, device);
 
-	tp_for_each_touch(tp, t) {
+	tp_for_each_touch(tp, t)
 		t->button.state = BUTTON_STATE_NONE;
-		libinput_timer_init(&t->button.timer,
-				    tp_libinput_context(tp),
-				    tp_button_handle_timeout, t);
-	}
 }
 
 void
@@ -884,7 +877,7 @@ tp_remove_buttons(struct tp_dispatch *tp)
 	struct tp_touch *t;
 
 	tp_for_each_touch(tp, t)
-		libinput_timer_cancel(&t->button.timer);
+		tp_touch_cancel_deadline(tp, &tp_touch_ext(t)->button_deadline);
 }
 
 static int
@@ -992,7 +985,7 @@ tp_clickfinger_set_button(struct tp_dispatch *tp)
 
 	/* two fingers down on the touchpad. Check for distance
 	 * between the fingers. */
-	tp_for_each_touch(tp, t) {
+	tp_for_each_active_touch(tp, t) {
 		if (t->state != TOUCH_BEGIN && t->state != TOUCH_UPDATE)
 			continue;
 
@@ -102,8 +102,9 @@ tp_edge_scroll_set_timer(struct tp_dispatch *tp,
 	    LIBINPUT_CONFIG_CLICK_METHOD_BUTTON_AREAS)
 		return;
 
-	libinput_timer_set(&t->scroll.timer,
-			   t->time + DEFAULT_SCROLL_LOCK_TIMEOUT);
+	tp_touch_set_deadline(tp,
+			      &tp_touch_ext(t)->scroll_deadline,
+			      t->time + DEFAULT_SCROLL_LOCK_TIMEOUT);
 }
 
 static void
@@ -111,7 +112,7 @@ tp_edge_scroll_set_state(struct tp_dispatch *tp,
 			 struct tp_touch *t,
 			 enum tp_edge_scroll_touch_state state)
 {
-	libinput_timer_cancel(&t->scroll.timer);
+	tp_touch_cancel_deadline(tp, &tp_touch_ext(t)->scroll_deadline);
 
 	t->scroll.edge_state = state;
 
@@ -264,12 +265,12 @@ tp_edge_scroll_handle_event(struct tp_dispatch *tp,
 			edge_state_to_str(t->scroll.edge_state));
 }
 
-static void
-tp_edge_scroll_handle_timeout(uint64_t now, void *data)
+void
+tp_edge_scroll_handle_timeout(struct tp_dispatch *tp,
+			      struct tp_touch *t,
+			      uint64_t now)
 {
-	struct tp_touch *t = data;
-
-	tp_edge_scroll_handle_event(t->tp, t, SCROLL_EVENT_TIMEOUT);
+	tp_edge_scroll_handle_event(tp, t, SCROLL_EVENT_TIMEOUT);
 }
 
 void
@@ -302,12 +303,8 @@ tp_edge_scroll_init(struct tp_dispatch *tp, struct evdev_device *device)
 	else
 		tp->scroll.bottom_edge = INT_MAX;
 
-	tp_for_each_touch(tp, t) {
+	tp_for_each_touch(tp, t)
 		t->scroll.direction = -1;
-		libinput_timer_init(&t->scroll.timer,
-				    tp_libinput_context(tp),
-				    tp_edge_scroll_handle_timeout, t);
-	}
 }
 
 void
@@ -316,7 +313,7 @@ tp_remove_edge_scroll(struct tp_dispatch *tp)
 	struct tp_touch *t;
 
 	tp_for_each_touch(tp, t)
-		libinput_timer_cancel(&t->scroll.timer);
+		tp_touch_cancel_deadline(tp, &tp_touch_ext(t)->scroll_deadline);
 }
 
 void
@@ -325,7 +322,7 @@ tp_edge_scroll_handle_state(struct tp_dispatch *tp, uint64_t time)
 	struct tp_touch *t;
 
 	if (tp->scroll.method != LIBINPUT_CONFIG_SCROLL_EDGE) {
-		tp_for_each_touch(tp, t) {
+		tp_for_each_active_touch(tp, t) {
 			if (t->state == TOUCH_BEGIN)
 				t->scroll.edge_state =
 					EDGE_SCROLL_TOUCH_STATE_AREA;
@@ -336,10 +333,7 @@ tp_edge_scroll_handle_state(struct tp_dispatch *tp, uint64_t time)
 		return;
 	}
 
-	tp_for_each_touch(tp, t) {
-		if (!t->dirty)
-			continue;
-
+	tp_for_each_dirty_touch(tp, t) {
 		switch (t->state) {
 		case TOUCH_NONE:
 		case TOUCH_HOVERING:
@@ -368,10 +362,7 @@ tp_edge_scroll_post_events(struct tp_dispatch *tp, uint64_t time)
 	const struct normalized_coords zero = { 0.0, 0.0 };
 	const struct discrete_coords zero_discrete = { 0.0, 0.0 };
 
-	tp_for_each_touch(tp, t) {
-		if (!t->dirty)
-			continue;
-
+	tp_for_each_dirty_touch(tp, t) {
 		if (t->palm.state != PALM_NONE)
 			continue;
 
@@ -48,26 +48,8 @@ gesture_state_to_str(enum tp_gesture_state state)
 static struct normalized_coords
 tp_get_touches_delta(struct tp_dispatch *tp, bool average)
 {
-	struct tp_touch *t;
-	unsigned int i, nactive = 0;
-	struct normalized_coords normalized;
-	struct normalized_coords delta = {0.0, 0.0};
-
-	for (i = 0; i < tp->num_slots; i++) {
-		t = &tp->touches[i];
-
-		if (!tp_touch_active(tp, t))
-			continue;
-
-		nactive++;
-
-		if (t->dirty) {
-			normalized = tp_get_delta(t);
-
-			delta.x += normalized.x;
-			delta.y += normalized.y;
-		}
-	}
+	struct normalized_coords delta = tp->gesture.active.delta;
+	unsigned int nactive = tp->gesture.active.nslots;
 
 	if (!average || nactive == 0)
 		return delta;
@@ -153,18 +135,10 @@ tp_gesture_get_active_touches(const struct tp_dispatch *tp,
 			      struct tp_touch **touches,
 			      unsigned int count)
 {
-	unsigned int n = 0;
-	struct tp_touch *t;
+	unsigned int n = min(tp->gesture.active.ntouches, count);
 
 	memset(touches, 0, count * sizeof(struct tp_touch *));
-
-	tp_for_each_touch(tp, t) {
-		if (tp_touch_active(tp, t)) {
-			touches[n++] = t;
-			if (n == count)
-				return count;
-		}
-	}
+	memcpy(touches, tp->gesture.active.touches, n * sizeof(*touches));
 
 	/*
 	 * This can happen when the user does .e.g:
@@ -422,6 +396,11 @@ tp_gesture_handle_state_pinch(struct tp_dispatch *tp, uint64_t time)
 	struct device_float_coords center, fdelta;
 	struct normalized_coords delta, unaccel;
 
+	/* Distance, angle and center only depend on the two gesture
+	 * touches, if neither changed there is nothing to send */
+	if (!tp->gesture.touches[0]->dirty && !tp->gesture.touches[1]->dirty)
+		return GESTURE_STATE_PINCH;
+
 	tp_gesture_get_pinch_info(tp, &distance, &angle, &center);
 
 	scale = distance / tp->gesture.initial_distance;
@@ -592,11 +571,31 @@ tp_gesture_handle_state(struct tp_dispatch *tp, uint64_t time)
 {
 	unsigned int active_touches = 0;
 	struct tp_touch *t;
+	struct normalized_coords normalized;
+
+	tp->gesture.active.nslots = 0;
+	tp->gesture.active.delta.x = 0.0;
+	tp->gesture.active.delta.y = 0.0;
 
-	tp_for_each_touch(tp, t) {
-		if (tp_touch_active(tp, t))
-			active_touches++;
+	tp_for_each_active_touch(tp, t) {
+		if (!tp_touch_active(tp, t))
+			continue;
+
+		if (active_touches < ARRAY_LENGTH(tp->gesture.active.touches))
+			tp->gesture.active.touches[active_touches] = t;
+		active_touches++;
+
+		if (tp_touch_index(tp, t) >= tp->num_slots)
+			continue;
+
+		tp->gesture.active.nslots++;
+		if (t->dirty) {
+			normalized = tp_get_delta(t);
+			tp->gesture.active.delta.x += normalized.x;
+			tp->gesture.active.delta.y += normalized.y;
+		}
 	}
+	tp->gesture.active.ntouches = active_touches;
 
 	if (active_touches != tp->gesture.finger_count) {
 		/* If all fingers are lifted immediately end the gesture */
@@ -37,18 +37,12 @@
 #define DEFAULT_DRAG_TIMEOUT_PERIOD ms2us(300)
 #define DEFAULT_TAP_MOVE_THRESHOLD 1.3 /* mm */
 
-enum tap_event {
-	TAP_EVENT_TOUCH = 12,
-	TAP_EVENT_MOTION,
-	TAP_EVENT_RELEASE,
-	TAP_EVENT_BUTTON,
-	TAP_EVENT_TIMEOUT,
-	TAP_EVENT_THUMB,
-};
-
 /*****************************************
  * DO NOT EDIT THIS FILE!
  *
+ * The state machine itself is the TAP_TRANSITIONS table in
+ * evdev-mt-touchpad.h.
+ *
  * Look at the state diagram in doc/touchpad-tap-state-machine.svg, or
  * online at
  * https://drive.google.com/file/d/0B1NwWmji69noYTdMcU1kTUZuUVE/edit?usp=sharing
@@ -144,548 +138,292 @@ tp_tap_clear_timer(struct tp_dispatch *tp)
 	libinput_timer_cancel(&tp->tap.timer);
 }
 
-static void
-tp_tap_idle_handle_event(struct tp_dispatch *tp,
-			 struct tp_touch *t,
-			 enum tap_event event, uint64_t time)
+/* Transition actions, see TAP_TRANSITIONS. For TAP_EVENT_BUTTON and
+ * TAP_EVENT_TIMEOUT, t is NULL. */
+
+#define tp_tap_action_none NULL
+
+static enum tp_tap_state
+tp_tap_action_press(struct tp_dispatch *tp,
+		    struct tp_touch *t,
+		    uint64_t time,
+		    enum tp_tap_state next)
 {
-	switch (event) {
-	case TAP_EVENT_TOUCH:
-		tp->tap.state = TAP_STATE_TOUCH;
-		tp->tap.saved_press_time = time;
-		tp_tap_set_timer(tp, time);
-		break;
-	case TAP_EVENT_RELEASE:
-		break;
-	case TAP_EVENT_MOTION:
-		evdev_log_bug_libinput(tp->device,
-				 "invalid tap event, no fingers are down\n");
-		break;
-	case TAP_EVENT_TIMEOUT:
-		break;
-	case TAP_EVENT_BUTTON:
-		tp->tap.state = TAP_STATE_DEAD;
-		break;
-	case TAP_EVENT_THUMB:
-		evdev_log_bug_libinput(tp->device,
-				 "invalid tap event, no fingers down, no thumb\n");
-		break;
-	}
+	tp->tap.saved_press_time = time;
+	tp_tap_set_timer(tp, time);
+	return next;
 }
 
-static void
-tp_tap_touch_handle_event(struct tp_dispatch *tp,
-			  struct tp_touch *t,
-			  enum tap_event event, uint64_t time)
+static enum tp_tap_state
+tp_tap_action_set_timer(struct tp_dispatch *tp,
+			struct tp_touch *t,
+			uint64_t time,
+			enum tp_tap_state next)
 {
+	tp_tap_set_timer(tp, time);
+	return next;
+}
 
-	switch (event) {
-	case TAP_EVENT_TOUCH:
-		tp->tap.state = TAP_STATE_TOUCH_2;
-		tp->tap.saved_press_time = time;
-		tp_tap_set_timer(tp, time);
-		break;
-	case TAP_EVENT_RELEASE:
-		tp_tap_notify(tp,
-			      tp->tap.saved_press_time,
-			      1,
-			      LIBINPUT_BUTTON_STATE_PRESSED);
-		if (tp->tap.drag_enabled) {
-			tp->tap.state = TAP_STATE_TAPPED;
-			tp->tap.saved_release_time = time;
-			tp_tap_set_timer(tp, time);
-		} else {
-			tp_tap_notify(tp,
-				      time,
-				      1,
-				      LIBINPUT_BUTTON_STATE_RELEASED);
-			tp->tap.state = TAP_STATE_IDLE;
-		}
-		break;
-	case TAP_EVENT_TIMEOUT:
-	case TAP_EVENT_MOTION:
-		tp->tap.state = TAP_STATE_HOLD;
-		tp_tap_clear_timer(tp);
-		break;
-	case TAP_EVENT_BUTTON:
-		tp->tap.state = TAP_STATE_DEAD;
-		break;
-	case TAP_EVENT_THUMB:
-		tp->tap.state = TAP_STATE_IDLE;
-		t->tap.is_thumb = true;
-		t->tap.state = TAP_TOUCH_STATE_DEAD;
-		tp_tap_clear_timer(tp);
-		break;
-	}
+static enum tp_tap_state
+tp_tap_action_clear_timer(struct tp_dispatch *tp,
+			  struct tp_touch *t,
+			  uint64_t time,
+			  enum tp_tap_state next)
+{
+	tp_tap_clear_timer(tp);
+	return next;
 }
 
-static void
-tp_tap_hold_handle_event(struct tp_dispatch *tp,
-			 struct tp_touch *t,
-			 enum tap_event event, uint64_t time)
+static enum tp_tap_state
+tp_tap_action_release_timer(struct tp_dispatch *tp,
+			    struct tp_touch *t,
+			    uint64_t time,
+			    enum tp_tap_state next)
 {
+	tp->tap.saved_release_time = time;
+	tp_tap_set_timer(tp, time);
+	return next;
+}
 
-	switch (event) {
-	case TAP_EVENT_TOUCH:
-		tp->tap.state = TAP_STATE_TOUCH_2;
-		tp->tap.saved_press_time = time;
-		tp_tap_set_timer(tp, time);
-		break;
-	case TAP_EVENT_RELEASE:
-		tp->tap.state = TAP_STATE_IDLE;
-		break;
-	case TAP_EVENT_MOTION:
-	case TAP_EVENT_TIMEOUT:
-		break;
-	case TAP_EVENT_BUTTON:
-		tp->tap.state = TAP_STATE_DEAD;
-		break;
-	case TAP_EVENT_THUMB:
-		tp->tap.state = TAP_STATE_IDLE;
-		t->tap.is_thumb = true;
-		t->tap.state = TAP_TOUCH_STATE_DEAD;
-		break;
-	}
+static enum tp_tap_state
+tp_tap_action_bug_no_fingers(struct tp_dispatch *tp,
+			     struct tp_touch *t,
+			     uint64_t time,
+			     enum tp_tap_state next)
+{
+	evdev_log_bug_libinput(tp->device,
+			 "invalid tap event, no fingers are down\n");
+	return next;
 }
 
-static void
-tp_tap_tapped_handle_event(struct tp_dispatch *tp,
+static enum tp_tap_state
+tp_tap_action_bug_no_thumb(struct tp_dispatch *tp,
 			   struct tp_touch *t,
-			   enum tap_event event, uint64_t time)
+			   uint64_t time,
+			   enum tp_tap_state next)
 {
-	switch (event) {
-	case TAP_EVENT_MOTION:
-	case TAP_EVENT_RELEASE:
-		evdev_log_bug_libinput(tp->device,
-				 "invalid tap event when fingers are up\n");
-		break;
-	case TAP_EVENT_TOUCH:
-		tp->tap.state = TAP_STATE_DRAGGING_OR_DOUBLETAP;
-		tp->tap.saved_press_time = time;
-		tp_tap_set_timer(tp, time);
-		break;
-	case TAP_EVENT_TIMEOUT:
-		tp->tap.state = TAP_STATE_IDLE;
-		tp_tap_notify(tp,
-			      tp->tap.saved_release_time,
-			      1,
-			      LIBINPUT_BUTTON_STATE_RELEASED);
-		break;
-	case TAP_EVENT_BUTTON:
-		tp->tap.state = TAP_STATE_DEAD;
-		tp_tap_notify(tp,
-			      tp->tap.saved_release_time,
-			      1,
-			      LIBINPUT_BUTTON_STATE_RELEASED);
-		break;
-	case TAP_EVENT_THUMB:
-		break;
-	}
+	evdev_log_bug_libinput(tp->device,
+			 "invalid tap event, no fingers down, no thumb\n");
+	return next;
 }
 
-static void
-tp_tap_touch2_handle_event(struct tp_dispatch *tp,
-			   struct tp_touch *t,
-			   enum tap_event event, uint64_t time)
+static enum tp_tap_state
+tp_tap_action_bug_fingers_up(struct tp_dispatch *tp,
+			     struct tp_touch *t,
+			     uint64_t time,
+			     enum tp_tap_state next)
 {
+	evdev_log_bug_libinput(tp->device,
+			 "invalid tap event when fingers are up\n");
+	return next;
+}
 
-	switch (event) {
-	case TAP_EVENT_TOUCH:
-		tp->tap.state = TAP_STATE_TOUCH_3;
-		tp->tap.saved_press_time = time;
-		tp_tap_set_timer(tp, time);
-		break;
-	case TAP_EVENT_RELEASE:
-		tp->tap.state = TAP_STATE_TOUCH_2_RELEASE;
+static enum tp_tap_state
+tp_tap_action_tap_or_drag(struct tp_dispatch *tp,
+			  struct tp_touch *t,
+			  uint64_t time,
+			  enum tp_tap_state next)
+{
+	tp_tap_notify(tp,
+		      tp->tap.saved_press_time,
+		      1,
+		      LIBINPUT_BUTTON_STATE_PRESSED);
+	if (tp->tap.drag_enabled) {
 		tp->tap.saved_release_time = time;
 		tp_tap_set_timer(tp, time);
-		break;
-	case TAP_EVENT_MOTION:
-		tp_tap_clear_timer(tp);
-		/* fallthrough */
-	case TAP_EVENT_TIMEOUT:
-		tp->tap.state = TAP_STATE_TOUCH_2_HOLD;
-		break;
-	case TAP_EVENT_BUTTON:
-		tp->tap.state = TAP_STATE_DEAD;
-		break;
-	case TAP_EVENT_THUMB:
-		break;
+		return next;
 	}
+
+	tp_tap_notify(tp,
+		      time,
+		      1,
+		      LIBINPUT_BUTTON_STATE_RELEASED);
+	return TAP_STATE_IDLE;
 }
 
-static void
-tp_tap_touch2_hold_handle_event(struct tp_dispatch *tp,
-				struct tp_touch *t,
-				enum tap_event event, uint64_t time)
+static enum tp_tap_state
+tp_tap_action_thumb(struct tp_dispatch *tp,
+		    struct tp_touch *t,
+		    uint64_t time,
+		    enum tp_tap_state next)
 {
-
-	switch (event) {
-	case TAP_EVENT_TOUCH:
-		tp->tap.state = TAP_STATE_TOUCH_3;
-		tp->tap.saved_press_time = time;
-		tp_tap_set_timer(tp, time);
-		break;
-	case TAP_EVENT_RELEASE:
-		tp->tap.state = TAP_STATE_HOLD;
-		break;
-	case TAP_EVENT_MOTION:
-	case TAP_EVENT_TIMEOUT:
-		tp->tap.state = TAP_STATE_TOUCH_2_HOLD;
-		break;
-	case TAP_EVENT_BUTTON:
-		tp->tap.state = TAP_STATE_DEAD;
-		break;
-	case TAP_EVENT_THUMB:
-		break;
-	}
+	t->tap.is_thumb = true;
+	t->tap.state = TAP_TOUCH_STATE_DEAD;
+	return next;
 }
 
-static void
-tp_tap_touch2_release_handle_event(struct tp_dispatch *tp,
-				   struct tp_touch *t,
-				   enum tap_event event, uint64_t time)
+static enum tp_tap_state
+tp_tap_action_touch_dead(struct tp_dispatch *tp,
+			 struct tp_touch *t,
+			 uint64_t time,
+			 enum tp_tap_state next)
 {
-
-	switch (event) {
-	case TAP_EVENT_TOUCH:
-		tp->tap.state = TAP_STATE_TOUCH_2_HOLD;
-		t->tap.state = TAP_TOUCH_STATE_DEAD;
-		tp_tap_clear_timer(tp);
-		break;
-	case TAP_EVENT_RELEASE:
-		tp_tap_notify(tp,
-			      tp->tap.saved_press_time,
-			      2,
-			      LIBINPUT_BUTTON_STATE_PRESSED);
-		tp_tap_notify(tp,
-			      tp->tap.saved_release_time,
-			      2,
-			      LIBINPUT_BUTTON_STATE_RELEASED);
-		tp->tap.state = TAP_STATE_IDLE;
-		break;
-	case TAP_EVENT_MOTION:
-	case TAP_EVENT_TIMEOUT:
-		tp->tap.state = TAP_STATE_HOLD;
-		break;
-	case TAP_EVENT_BUTTON:
-		tp->tap.state = TAP_STATE_DEAD;
-		break;
-	case TAP_EVENT_THUMB:
-		break;
-	}
+	t->tap.state = TAP_TOUCH_STATE_DEAD;
+	tp_tap_clear_timer(tp);
+	return next;
 }
 
-static void
-tp_tap_touch3_handle_event(struct tp_dispatch *tp,
-			   struct tp_touch *t,
-			   enum tap_event event, uint64_t time)
+static inline void
+tp_tap_notify_tap(struct tp_dispatch *tp, int nfingers)
 {
-
-	switch (event) {
-	case TAP_EVENT_TOUCH:
-		tp->tap.state = TAP_STATE_DEAD;
-		tp_tap_clear_timer(tp);
-		break;
-	case TAP_EVENT_MOTION:
-	case TAP_EVENT_TIMEOUT:
-		tp->tap.state = TAP_STATE_TOUCH_3_HOLD;
-		tp_tap_clear_timer(tp);
-		break;
-	case TAP_EVENT_RELEASE:
-		tp->tap.state = TAP_STATE_TOUCH_2_HOLD;
-		if (t->tap.state == TAP_TOUCH_STATE_TOUCH) {
-			tp_tap_notify(tp,
-				      tp->tap.saved_press_time,
-				      3,
-				      LIBINPUT_BUTTON_STATE_PRESSED);
-			tp_tap_notify(tp, time, 3, LIBINPUT_BUTTON_STATE_RELEASED);
-		}
-		break;
-	case TAP_EVENT_BUTTON:
-		tp->tap.state = TAP_STATE_DEAD;
-		break;
-	case TAP_EVENT_THUMB:
-		break;
-	}
+	tp_tap_notify(tp,
+		      tp->tap.saved_press_time,
+		      nfingers,
+		      LIBINPUT_BUTTON_STATE_PRESSED);
+	tp_tap_notify(tp,
+		      tp->tap.saved_release_time,
+		      nfingers,
+		      LIBINPUT_BUTTON_STATE_RELEASED);
 }
 
-static void
-tp_tap_touch3_hold_handle_event(struct tp_dispatch *tp,
-				struct tp_touch *t,
-				enum tap_event event, uint64_t time)
+static enum tp_tap_state
+tp_tap_action_tap_1fg(struct tp_dispatch *tp,
+		      struct tp_touch *t,
+		      uint64_t time,
+		      enum tp_tap_state next)
 {
+	tp_tap_notify_tap(tp, 1);
+	return next;
+}
 
-	switch (event) {
-	case TAP_EVENT_TOUCH:
-		tp->tap.state = TAP_STATE_DEAD;
-		tp_tap_set_timer(tp, time);
-		break;
-	case TAP_EVENT_RELEASE:
-		tp->tap.state = TAP_STATE_TOUCH_2_HOLD;
-		break;
-	case TAP_EVENT_MOTION:
-	case TAP_EVENT_TIMEOUT:
-		break;
-	case TAP_EVENT_BUTTON:
-		tp->tap.state = TAP_STATE_DEAD;
-		break;
-	case TAP_EVENT_THUMB:
-		break;
-	}
+static enum tp_tap_state
+tp_tap_action_tap_2fg(struct tp_dispatch *tp,
+		      struct tp_touch *t,
+		      uint64_t time,
+		      enum tp_tap_state next)
+{
+	tp_tap_notify_tap(tp, 2);
+	return next;
 }
 
-static void
-tp_tap_dragging_or_doubletap_handle_event(struct tp_dispatch *tp,
-					  struct tp_touch *t,
-					  enum tap_event event, uint64_t time)
+static enum tp_tap_state
+tp_tap_action_tap_3fg(struct tp_dispatch *tp,
+		      struct tp_touch *t,
+		      uint64_t time,
+		      enum tp_tap_state next)
 {
-	switch (event) {
-	case TAP_EVENT_TOUCH:
-		tp->tap.state = TAP_STATE_DRAGGING_2;
-		break;
-	case TAP_EVENT_RELEASE:
-		tp->tap.state = TAP_STATE_MULTITAP;
+	if (t->tap.state == TAP_TOUCH_STATE_TOUCH) {
 		tp_tap_notify(tp,
-			      tp->tap.saved_release_time,
-			      1,
-			      LIBINPUT_BUTTON_STATE_RELEASED);
-		tp->tap.saved_release_time = time;
-		break;
-	case TAP_EVENT_MOTION:
-	case TAP_EVENT_TIMEOUT:
-		tp->tap.state = TAP_STATE_DRAGGING;
-		break;
-	case TAP_EVENT_BUTTON:
-		tp->tap.state = TAP_STATE_DEAD;
-		tp_tap_notify(tp,
-			      tp->tap.saved_release_time,
-			      1,
-			      LIBINPUT_BUTTON_STATE_RELEASED);
-		break;
-	case TAP_EVENT_THUMB:
-		break;
+			      tp->tap.saved_press_time,
+			      3,
+			      LIBINPUT_BUTTON_STATE_PRESSED);
+		tp_tap_notify(tp, time, 3, LIBINPUT_BUTTON_STATE_RELEASED);
 	}
+	return next;
 }
 
-static void
-tp_tap_dragging_handle_event(struct tp_dispatch *tp,
-			     struct tp_touch *t,
-			     enum tap_event event, uint64_t time)
+static enum tp_tap_state
+tp_tap_action_release(struct tp_dispatch *tp,
+		      struct tp_touch *t,
+		      uint64_t time,
+		      enum tp_tap_state next)
 {
-
-	switch (event) {
-	case TAP_EVENT_TOUCH:
-		tp->tap.state = TAP_STATE_DRAGGING_2;
-		break;
-	case TAP_EVENT_RELEASE:
-		if (tp->tap.drag_lock_enabled) {
-			tp->tap.state = TAP_STATE_DRAGGING_WAIT;
-			tp_tap_set_drag_timer(tp, time);
-		} else {
-			tp_tap_notify(tp,
-				      time,
-				      1,
-				      LIBINPUT_BUTTON_STATE_RELEASED);
-			tp->tap.state = TAP_STATE_IDLE;
-		}
-		break;
-	case TAP_EVENT_MOTION:
-	case TAP_EVENT_TIMEOUT:
-		/* noop */
-		break;
-	case TAP_EVENT_BUTTON:
-		tp->tap.state = TAP_STATE_DEAD;
-		tp_tap_notify(tp, time, 1, LIBINPUT_BUTTON_STATE_RELEASED);
-		break;
-	case TAP_EVENT_THUMB:
-		break;
-	}
+	tp_tap_notify(tp, time, 1, LIBINPUT_BUTTON_STATE_RELEASED);
+	return next;
 }
 
-static void
-tp_tap_dragging_wait_handle_event(struct tp_dispatch *tp,
-				  struct tp_touch *t,
-				  enum tap_event event, uint64_t time)
+static enum tp_tap_state
+tp_tap_action_release_saved(struct tp_dispatch *tp,
+			    struct tp_touch *t,
+			    uint64_t time,
+			    enum tp_tap_state next)
 {
-
-	switch (event) {
-	case TAP_EVENT_TOUCH:
-		tp->tap.state = TAP_STATE_DRAGGING_OR_TAP;
-		tp_tap_set_timer(tp, time);
-		break;
-	case TAP_EVENT_RELEASE:
-	case TAP_EVENT_MOTION:
-		break;
-	case TAP_EVENT_TIMEOUT:
-		tp->tap.state = TAP_STATE_IDLE;
-		tp_tap_notify(tp, time, 1, LIBINPUT_BUTTON_STATE_RELEASED);
-		break;
-	case TAP_EVENT_BUTTON:
-		tp->tap.state = TAP_STATE_DEAD;
-		tp_tap_notify(tp, time, 1, LIBINPUT_BUTTON_STATE_RELEASED);
-		break;
-	case TAP_EVENT_THUMB:
-		break;
-	}
+	tp_tap_notify(tp,
+		      tp->tap.saved_release_time,
+		      1,
+		      LIBINPUT_BUTTON_STATE_RELEASED);
+	return next;
 }
 
-static void
-tp_tap_dragging_tap_handle_event(struct tp_dispatch *tp,
-				  struct tp_touch *t,
-				  enum tap_event event, uint64_t time)
+static enum tp_tap_state
+tp_tap_action_drag_release(struct tp_dispatch *tp,
+			   struct tp_touch *t,
+			   uint64_t time,
+			   enum tp_tap_state next)
 {
-
-	switch (event) {
-	case TAP_EVENT_TOUCH:
-		tp->tap.state = TAP_STATE_DRAGGING_2;
-		tp_tap_clear_timer(tp);
-		break;
-	case TAP_EVENT_RELEASE:
-		tp->tap.state = TAP_STATE_IDLE;
-		tp_tap_notify(tp, time, 1, LIBINPUT_BUTTON_STATE_RELEASED);
-		break;
-	case TAP_EVENT_MOTION:
-	case TAP_EVENT_TIMEOUT:
-		tp->tap.state = TAP_STATE_DRAGGING;
-		break;
-	case TAP_EVENT_BUTTON:
-		tp->tap.state = TAP_STATE_DEAD;
-		tp_tap_notify(tp, time, 1, LIBINPUT_BUTTON_STATE_RELEASED);
-		break;
-	case TAP_EVENT_THUMB:
-		break;
+	if (tp->tap.drag_lock_enabled) {
+		tp_tap_set_drag_timer(tp, time);
+		return next;
 	}
+
+	tp_tap_notify(tp, time, 1, LIBINPUT_BUTTON_STATE_RELEASED);
+	return TAP_STATE_IDLE;
 }
 
-static void
-tp_tap_dragging2_handle_event(struct tp_dispatch *tp,
-			      struct tp_touch *t,
-			      enum tap_event event, uint64_t time)
+static enum tp_tap_state
+tp_tap_action_multitap_press(struct tp_dispatch *tp,
+			     struct tp_touch *t,
+			     uint64_t time,
+			     enum tp_tap_state next)
+{
+	tp_tap_notify(tp,
+		      tp->tap.saved_press_time,
+		      1,
+		      LIBINPUT_BUTTON_STATE_PRESSED);
+	tp->tap.saved_press_time = time;
+	tp_tap_set_timer(tp, time);
+	return next;
+}
+
+static enum tp_tap_state
+tp_tap_action_multitap_release(struct tp_dispatch *tp,
+			       struct tp_touch *t,
+			       uint64_t time,
+			       enum tp_tap_state next)
+{
+	tp_tap_notify(tp,
+		      tp->tap.saved_release_time,
+		      1,
+		      LIBINPUT_BUTTON_STATE_RELEASED);
+	tp->tap.saved_release_time = time;
+	return next;
+}
+
+static enum tp_tap_state
+tp_tap_action_dead_release(struct tp_dispatch *tp,
+			   struct tp_touch *t,
+			   uint64_t time,
+			   enum tp_tap_state next)
 {
+	if (tp->nfingers_down > 0)
+		return TAP_STATE_DEAD;
 
-	switch (event) {
-	case TAP_EVENT_RELEASE:
-		tp->tap.state = TAP_STATE_DRAGGING;
-		break;
-	case TAP_EVENT_TOUCH:
-		tp->tap.state = TAP_STATE_DEAD;
-		tp_tap_notify(tp, time, 1, LIBINPUT_BUTTON_STATE_RELEASED);
-		break;
-	case TAP_EVENT_MOTION:
-	case TAP_EVENT_TIMEOUT:
-		/* noop */
-		break;
-	case TAP_EVENT_BUTTON:
-		tp->tap.state = TAP_STATE_DEAD;
-		tp_tap_notify(tp, time, 1, LIBINPUT_BUTTON_STATE_RELEASED);
-		break;
-	case TAP_EVENT_THUMB:
-		break;
-	}
+	return next;
 }
 
-static void
-tp_tap_multitap_handle_event(struct tp_dispatch *tp,
-			      struct tp_touch *t,
-			      enum tap_event event, uint64_t time)
-{
-	switch (event) {
-	case TAP_EVENT_RELEASE:
-		evdev_log_bug_libinput(tp->device,
-				 "invalid tap event, no fingers are down\n");
-		break;
-	case TAP_EVENT_TOUCH:
-		tp->tap.state = TAP_STATE_MULTITAP_DOWN;
-		tp_tap_notify(tp,
-			      tp->tap.saved_press_time,
-			      1,
-			      LIBINPUT_BUTTON_STATE_PRESSED);
-		tp->tap.saved_press_time = time;
-		tp_tap_set_timer(tp, time);
-		break;
-	case TAP_EVENT_MOTION:
-		evdev_log_bug_libinput(tp->device,
-				 "invalid tap event, no fingers are down\n");
-		break;
-	case TAP_EVENT_TIMEOUT:
-		tp->tap.state = TAP_STATE_IDLE;
-		tp_tap_notify(tp,
-			      tp->tap.saved_press_time,
-			      1,
-			      LIBINPUT_BUTTON_STATE_PRESSED);
-		tp_tap_notify(tp,
-			      tp->tap.saved_release_time,
-			      1,
-			      LIBINPUT_BUTTON_STATE_RELEASED);
-		break;
-	case TAP_EVENT_BUTTON:
-		tp->tap.state = TAP_STATE_IDLE;
-		tp_tap_clear_timer(tp);
-		break;
-	case TAP_EVENT_THUMB:
-		break;
-	}
-}
+struct tap_transition {
+	enum tp_tap_state (*action)(struct tp_dispatch *tp,
+				    struct tp_touch *t,
+				    uint64_t time,
+				    enum tp_tap_state next);
+	enum tp_tap_state next;
+};
 
-static void
-tp_tap_multitap_down_handle_event(struct tp_dispatch *tp,
-				  struct tp_touch *t,
-				  enum tap_event event,
-				  uint64_t time)
-{
-	switch (event) {
-	case TAP_EVENT_RELEASE:
-		tp->tap.state = TAP_STATE_MULTITAP;
-		tp_tap_notify(tp,
-			      tp->tap.saved_release_time,
-			      1,
-			      LIBINPUT_BUTTON_STATE_RELEASED);
-		tp->tap.saved_release_time = time;
-		break;
-	case TAP_EVENT_TOUCH:
-		tp->tap.state = TAP_STATE_DRAGGING_2;
-		tp_tap_clear_timer(tp);
-		break;
-	case TAP_EVENT_MOTION:
-	case TAP_EVENT_TIMEOUT:
-		tp->tap.state = TAP_STATE_DRAGGING;
-		tp_tap_clear_timer(tp);
-		break;
-	case TAP_EVENT_BUTTON:
-		tp->tap.state = TAP_STATE_DEAD;
-		tp_tap_notify(tp,
-			      tp->tap.saved_release_time,
-			      1,
-			      LIBINPUT_BUTTON_STATE_RELEASED);
-		tp_tap_clear_timer(tp);
-		break;
-	case TAP_EVENT_THUMB:
-		break;
-	}
-}
+#define TAP_TRANSITION_ENTRY(state_, event_, action_, next_) \
+	[TAP_STATE_##state_ - TAP_STATE_IDLE] \
+		[TAP_EVENT_##event_ - TAP_EVENT_TOUCH] = { \
+		tp_tap_action_##action_, \
+		TAP_STATE_##next_ \
+	},
 
-static void
-tp_tap_dead_handle_event(struct tp_dispatch *tp,
-			 struct tp_touch *t,
-			 enum tap_event event,
-			 uint64_t time)
-{
+static const struct tap_transition
+tap_transitions[TAP_STATE_COUNT][TAP_EVENT_COUNT] = {
+	TAP_TRANSITIONS(TAP_TRANSITION_ENTRY)
+};
 
-	switch (event) {
-	case TAP_EVENT_RELEASE:
-		if (tp->nfingers_down == 0)
-			tp->tap.state = TAP_STATE_IDLE;
-		break;
-	case TAP_EVENT_TOUCH:
-	case TAP_EVENT_MOTION:
-	case TAP_EVENT_TIMEOUT:
-	case TAP_EVENT_BUTTON:
-		break;
-	case TAP_EVENT_THUMB:
-		break;
-	}
-}
+/* One enumerator per table entry: a state/event pair listed twice fails
+ * to compile, so with the count matching every pair is listed exactly
+ * once. */
+#define TAP_TRANSITION_ID(state_, event_, action_, next_) \
+	TAP_TRANSITION_##state_##_##event_,
+
+enum tap_transition_id {
+	TAP_TRANSITIONS(TAP_TRANSITION_ID)
+	TAP_TRANSITION_COUNT
+};
+
+static_assert(TAP_TRANSITION_COUNT == TAP_STATE_COUNT * TAP_EVENT_COUNT,
+	      "TAP_TRANSITIONS must handle every event in every state");
 
 static void
 tp_tap_handle_event(struct tp_dispatch *tp,
@@ -693,63 +431,18 @@ tp_tap_handle_event(struct tp_dispatch *tp,
 		    enum tap_event event,
 		    uint64_t time)
 {
+	const struct tap_transition *transition;
 	enum tp_tap_state current;
 
 	current = tp->tap.state;
+	transition = &tap_transitions[current - TAP_STATE_IDLE]
+				     [event - TAP_EVENT_TOUCH];
 
-	switch(tp->tap.state) {
-	case TAP_STATE_IDLE:
-		tp_tap_idle_handle_event(tp, t, event, time);
-		break;
-	case TAP_STATE_TOUCH:
-		tp_tap_touch_handle_event(tp, t, event, time);
-		break;
-	case TAP_STATE_HOLD:
-		tp_tap_hold_handle_event(tp, t, event, time);
-		break;
-	case TAP_STATE_TAPPED:
-		tp_tap_tapped_handle_event(tp, t, event, time);
-		break;
-	case TAP_STATE_TOUCH_2:
-		tp_tap_touch2_handle_event(tp, t, event, time);
-		break;
-	case TAP_STATE_TOUCH_2_HOLD:
-		tp_tap_touch2_hold_handle_event(tp, t, event, time);
-		break;
-	case TAP_STATE_TOUCH_2_RELEASE:
-		tp_tap_touch2_release_handle_event(tp, t, event, time);
-		break;
-	case TAP_STATE_TOUCH_3:
-		tp_tap_touch3_handle_event(tp, t, event, time);
-		break;
-	case TAP_STATE_TOUCH_3_HOLD:
-		tp_tap_touch3_hold_handle_event(tp, t, event, time);
-		break;
-	case TAP_STATE_DRAGGING_OR_DOUBLETAP:
-		tp_tap_dragging_or_doubletap_handle_event(tp, t, event, time);
-		break;
-	case TAP_STATE_DRAGGING:
-		tp_tap_dragging_handle_event(tp, t, event, time);
-		break;
-	case TAP_STATE_DRAGGING_WAIT:
-		tp_tap_dragging_wait_handle_event(tp, t, event, time);
-		break;
-	case TAP_STATE_DRAGGING_OR_TAP:
-		tp_tap_dragging_tap_handle_event(tp, t, event, time);
-		break;
-	case TAP_STATE_DRAGGING_2:
-		tp_tap_dragging2_handle_event(tp, t, event, time);
-		break;
-	case TAP_STATE_MULTITAP:
-		tp_tap_multitap_handle_event(tp, t, event, time);
-		break;
-	case TAP_STATE_MULTITAP_DOWN:
-		tp_tap_multitap_down_handle_event(tp, t, event, time);
-		break;
-	case TAP_STATE_DEAD:
-		tp_tap_dead_handle_event(tp, t, event, time);
-		break;
-	}
+	if (transition->action)
+		tp->tap.state = transition->action(tp, t, time,
+						   transition->next);
+	else
+		tp->tap.state = transition->next;
 
 	if (tp->tap.state == TAP_STATE_IDLE || tp->tap.state == TAP_STATE_DEAD)
 		tp_tap_clear_timer(tp);
@@ -804,8 +497,8 @@ tp_tap_handle_state(struct tp_dispatch *tp, uint64_t time)
 	if (tp->buttons.is_clickpad && tp->queued & TOUCHPAD_EVENT_BUTTON_PRESS)
 		tp_tap_handle_event(tp, NULL, TAP_EVENT_BUTTON, time);
 
-	tp_for_each_touch(tp, t) {
-		if (!t->dirty || t->state == TOUCH_NONE)
+	tp_for_each_dirty_touch(tp, t) {
+		if (t->state == TOUCH_NONE)
 			continue;
 
 		if (tp->buttons.is_clickpad &&
@@ -912,7 +605,7 @@ tp_tap_handle_timeout(uint64_t time, void *data)
 
 	tp_tap_handle_event(tp, NULL, TAP_EVENT_TIMEOUT, time);
 
-	tp_for_each_touch(tp, t) {
+	tp_for_each_active_touch(tp, t) {
 		if (t->state == TOUCH_NONE ||
 		    t->tap.state == TAP_TOUCH_STATE_IDLE)
 			continue;
@@ -35,6 +35,7 @@
 #define DEFAULT_KEYBOARD_ACTIVITY_TIMEOUT_2 ms2us(500)
 #define THUMB_MOVE_TIMEOUT ms2us(300)
 #define FAKE_FINGER_OVERFLOW (1 << 7)
+#define TP_LOW_LATENCY_DEFAULT_SMOOTHING 0.5
 
 static inline struct device_coords *
 tp_motion_history_offset(struct tp_touch *t, int offset)
@@ -117,6 +118,38 @@ tp_motion_hysteresis(struct tp_dispatch *tp,
 	}
 }
 
+/* Low-latency mode: filter the kernel position into t->smoothed, the
+ * position the pointer and scroll deltas are taken from. t->point is
+ * left alone, everything else keeps working on the hysteresis-filtered
+ * kernel position. Unlike the hysteresis, the smoothed position follows
+ * the finger from the first movement on. */
+static inline void
+tp_motion_smooth(struct tp_dispatch *tp,
+		 struct tp_touch *t)
+{
+	int res_x = tp->device->abs.absinfo_x->resolution,
+	    res_y = tp->device->abs.absinfo_y->resolution;
+	struct device_float_coords mm;
+	bool restart;
+
+	if (t->history.count == 0)
+		one_euro_reset(&t->smoothing);
+	restart = !t->smoothing.initialized;
+
+	mm.x = (double)t->point.x/res_x;
+	mm.y = (double)t->point.y/res_y;
+	mm = one_euro_filter(&tp->low_latency.params,
+			     &t->smoothing,
+			     &mm,
+			     t->time);
+
+	t->smoothed.last = t->smoothed.point;
+	t->smoothed.point.x = round(mm.x * res_x);
+	t->smoothed.point.y = round(mm.y * res_y);
+	if (restart)
+		t->smoothed.last = t->smoothed.point;
+}
+
 static inline void
 tp_motion_history_reset(struct tp_touch *t)
 {
@@ -212,10 +245,10 @@ tp_new_touch(struct tp_dispatch *tp, struct tp_touch *t, uint64_t time)
 	 * don't know if it's a touch down or not. And BTN_TOUCH may happen
 	 * after ABS_MT_TRACKING_ID */
 	tp_motion_history_reset(t);
-	t->dirty = true;
+	tp_touch_set_dirty(tp, t, true);
 	t->has_ended = false;
 	t->was_down = false;
-	t->state = TOUCH_HOVERING;
+	tp_touch_set_state(tp, t, TOUCH_HOVERING);
 	t->pinned.is_pinned = false;
 	t->time = time;
 	tp->queued |= TOUCHPAD_EVENT_MOTION;
@@ -224,12 +257,12 @@ tp_new_touch(struct tp_dispatch *tp, struct tp_touch *t, uint64_t time)
 static inline void
 tp_begin_touch(struct tp_dispatch *tp, struct tp_touch *t, uint64_t time)
 {
-	t->dirty = true;
-	t->state = TOUCH_BEGIN;
+	tp_touch_set_dirty(tp, t, true);
+	tp_touch_set_state(tp, t, TOUCH_BEGIN);
 	t->time = time;
 	t->was_down = true;
 	tp->nfingers_down++;
-	t->palm.time = time;
+	tp_touch_ext(t)->palm.time = time;
 	t->thumb.state = THUMB_STATE_MAYBE;
 	t->thumb.first_touch_time = time;
 	t->tap.is_thumb = false;
@@ -244,7 +277,7 @@ tp_end_touch(struct tp_dispatch *tp, struct tp_touch *t, uint64_t time)
 {
 	switch (t->state) {
 	case TOUCH_HOVERING:
-		t->state = TOUCH_NONE;
+		tp_touch_set_state(tp, t, TOUCH_NONE);
 		/* fallthough */
 	case TOUCH_NONE:
 	case TOUCH_END:
@@ -255,12 +288,12 @@ tp_end_touch(struct tp_dispatch *tp, struct tp_touch *t, uint64_t time)
 
 	}
 
-	t->dirty = true;
+	tp_touch_set_dirty(tp, t, true);
 	t->palm.state = PALM_NONE;
-	t->state = TOUCH_END;
+	tp_touch_set_state(tp, t, TOUCH_END);
 	t->pinned.is_pinned = false;
 	t->time = time;
-	t->palm.time = 0;
+	tp_touch_ext(t)->palm.time = 0;
 	assert(tp->nfingers_down >= 1);
 	tp->nfingers_down--;
 	tp->queued |= TOUCHPAD_EVENT_MOTION;
@@ -293,6 +326,12 @@ tp_get_delta(struct tp_touch *t)
 	if (t->history.count <= 1)
 		return zero;
 
+	if (t->tp->low_latency.enabled) {
+		delta.x = t->smoothed.point.x - t->smoothed.last.x;
+		delta.y = t->smoothed.point.y - t->smoothed.last.y;
+		return tp_normalize_delta(t->tp, delta);
+	}
+
 	delta.x = tp_motion_history_offset(t, 0)->x -
 		  tp_motion_history_offset(t, 1)->x;
 	delta.y = tp_motion_history_offset(t, 0)->y -
@@ -315,7 +354,7 @@ tp_process_absolute(struct tp_dispatch *tp,
 						  e->value);
 		t->point.x = e->value;
 		t->time = time;
-		t->dirty = true;
+		tp_touch_set_dirty(tp, t, true);
 		tp->queued |= TOUCHPAD_EVENT_MOTION;
 		break;
 	case ABS_MT_POSITION_Y:
@@ -324,7 +363,7 @@ tp_process_absolute(struct tp_dispatch *tp,
 						  e->value);
 		t->point.y = e->value;
 		t->time = time;
-		t->dirty = true;
+		tp_touch_set_dirty(tp, t, true);
 		tp->queued |= TOUCHPAD_EVENT_MOTION;
 		break;
 	case ABS_MT_SLOT:
@@ -339,13 +378,13 @@ tp_process_absolute(struct tp_dispatch *tp,
 	case ABS_MT_PRESSURE:
 		t->pressure = e->value;
 		t->time = time;
-		t->dirty = true;
+		tp_touch_set_dirty(tp, t, true);
 		tp->queued |= TOUCHPAD_EVENT_OTHERAXIS;
 		break;
 	case ABS_MT_TOOL_TYPE:
 		t->is_tool_palm = e->value == MT_TOOL_PALM;
 		t->time = time;
-		t->dirty = true;
+		tp_touch_set_dirty(tp, t, true);
 		tp->queued |= TOUCHPAD_EVENT_OTHERAXIS;
 		break;
 	}
@@ -365,7 +404,7 @@ tp_process_absolute_st(struct tp_dispatch *tp,
 						  e->value);
 		t->point.x = e->value;
 		t->time = time;
-		t->dirty = true;
+		tp_touch_set_dirty(tp, t, true);
 		tp->queued |= TOUCHPAD_EVENT_MOTION;
 		break;
 	case ABS_Y:
@@ -374,13 +413,13 @@ tp_process_absolute_st(struct tp_dispatch *tp,
 						  e->value);
 		t->point.y = e->value;
 		t->time = time;
-		t->dirty = true;
+		tp_touch_set_dirty(tp, t, true);
 		tp->queued |= TOUCHPAD_EVENT_MOTION;
 		break;
 	case ABS_PRESSURE:
 		t->pressure = e->value;
 		t->time = time;
-		t->dirty = true;
+		tp_touch_set_dirty(tp, t, true);
 		tp->queued |= TOUCHPAD_EVENT_OTHERAXIS;
 		break;
 	}
@@ -416,7 +455,7 @@ tp_restore_synaptics_touches(struct tp_dispatch *tp,
 		/* new touch, move it through begin to update immediately */
 		tp_new_touch(tp, t, time);
 		tp_begin_touch(tp, t, time);
-		t->state = TOUCH_UPDATE;
+		tp_touch_set_state(tp, t, TOUCH_UPDATE);
 	}
 }
 
@@ -533,7 +572,7 @@ tp_pin_fingers(struct tp_dispatch *tp)
 {
 	struct tp_touch *t;
 
-	tp_for_each_touch(tp, t) {
+	tp_for_each_active_touch(tp, t) {
 		t->pinned.is_pinned = true;
 		t->pinned.center = t->point;
 	}
@@ -573,7 +612,7 @@ tp_palm_detect_dwt_triggered(struct tp_dispatch *tp,
 	    tp->dwt.keyboard_active &&
 	    t->state == TOUCH_BEGIN) {
 		t->palm.state = PALM_TYPING;
-		t->palm.first = t->point;
+		tp_touch_ext(t)->palm.first = t->point;
 		return true;
 	} else if (!tp->dwt.keyboard_active &&
 		   t->state == TOUCH_UPDATE &&
@@ -584,8 +623,8 @@ tp_palm_detect_dwt_triggered(struct tp_dispatch *tp,
 		   started once we stop typing will be able to control the
 		   pointer (alas not tap, etc.).
 		   */
-		if (t->palm.time == 0 ||
-		    t->palm.time > tp->dwt.keyboard_last_press_time) {
+		if (tp_touch_ext(t)->palm.time == 0 ||
+		    tp_touch_ext(t)->palm.time > tp->dwt.keyboard_last_press_time) {
 			t->palm.state = PALM_NONE;
 			evdev_log_debug(tp->device,
 					"palm: touch released, timeout after typing\n");
@@ -612,8 +651,8 @@ tp_palm_detect_trackpoint_triggered(struct tp_dispatch *tp,
 		   t->state == TOUCH_UPDATE &&
 		   !tp->palm.trackpoint_active) {
 
-		if (t->palm.time == 0 ||
-		    t->palm.time > tp->palm.trackpoint_last_event_time) {
+		if (tp_touch_ext(t)->palm.time == 0 ||
+		    tp_touch_ext(t)->palm.time > tp->palm.trackpoint_last_event_time) {
 			t->palm.state = PALM_NONE;
 			evdev_log_debug(tp->device,
 				       "palm: touch released, timeout after trackpoint\n");
@@ -658,9 +697,9 @@ tp_palm_detect_move_out_of_edge(struct tp_dispatch *tp,
 	struct device_float_coords delta;
 	int dirs;
 
-	if (time < t->palm.time + PALM_TIMEOUT &&
+	if (time < tp_touch_ext(t)->palm.time + PALM_TIMEOUT &&
 	    (t->point.x > tp->palm.left_edge && t->point.x < tp->palm.right_edge)) {
-		delta = device_delta(t->point, t->palm.first);
+		delta = device_delta(t->point, tp_touch_ext(t)->palm.first);
 		dirs = phys_get_direction(tp_phys_delta(tp, delta));
 		if ((dirs & DIRECTIONS) && !(dirs & ~DIRECTIONS))
 			return true;
@@ -685,7 +724,7 @@ tp_palm_detect_multifinger(struct tp_dispatch *tp, struct tp_touch *t, uint64_t
 	 * frame the second touch will still be PALM_NONE and thus detected
 	 * here as non-palm touch. This is too niche to worry about for now.
 	 */
-	tp_for_each_touch(tp, other) {
+	tp_for_each_active_touch(tp, other) {
 		if (other == t)
 			continue;
 
@@ -740,8 +779,8 @@ tp_palm_detect_edge(struct tp_dispatch *tp,
 		return false;
 
 	t->palm.state = PALM_EDGE;
-	t->palm.time = time;
-	t->palm.first = t->point;
+	tp_touch_ext(t)->palm.time = time;
+	tp_touch_ext(t)->palm.first = t->point;
 
 	return true;
 }
@@ -879,8 +918,9 @@ tp_unhover_pressure(struct tp_dispatch *tp, uint64_t time)
 	if (nfake_touches == FAKE_FINGER_OVERFLOW)
 		nfake_touches = 0;
 
-	for (i = 0; i < (int)tp->num_slots; i++) {
-		t = tp_get_touch(tp, i);
+	tp_for_each_active_touch(tp, t) {
+		if (tp_touch_index(tp, t) >= tp->num_slots)
+			break;
 
 		if (t->state == TOUCH_NONE)
 			continue;
@@ -916,7 +956,7 @@ tp_unhover_pressure(struct tp_dispatch *tp, uint64_t time)
 	 * _all_ fingers have enough pressure, even if some of the slotted
 	 * ones don't. Anything else gets insane quickly.
 	 */
-	tp_for_each_touch(tp, t) {
+	tp_for_each_active_touch(tp, t) {
 		if (t->state == TOUCH_HOVERING) {
 			/* avoid jumps when landing a finger */
 			tp_motion_history_reset(t);
@@ -970,7 +1010,7 @@ tp_unhover_fake_touches(struct tp_dispatch *tp, uint64_t time)
 	 */
 	if (tp_fake_finger_is_touching(tp) &&
 	    tp->nfingers_down < nfake_touches) {
-		tp_for_each_touch(tp, t) {
+		tp_for_each_active_touch(tp, t) {
 			if (t->state == TOUCH_HOVERING) {
 				tp_begin_touch(tp, t, time);
 
@@ -1052,7 +1092,7 @@ tp_position_fake_touches(struct tp_dispatch *tp)
 		t->point = topmost->point;
 		t->pressure = topmost->pressure;
 		if (!t->dirty)
-			t->dirty = topmost->dirty;
+			tp_touch_set_dirty(tp, t, topmost->dirty);
 	}
 }
 
@@ -1137,7 +1177,7 @@ tp_process_state(struct tp_dispatch *tp, uint64_t time)
 
 	want_motion_reset = tp_need_motion_history_reset(tp);
 
-	tp_for_each_touch(tp, t) {
+	tp_for_each_active_touch(tp, t) {
 		if (want_motion_reset) {
 			tp_motion_history_reset(t);
 			t->quirks.reset_motion_history = true;
@@ -1161,6 +1201,8 @@ tp_process_state(struct tp_dispatch *tp, uint64_t time)
 		tp_thumb_detect(tp, t, time);
 		tp_palm_detect(tp, t, time);
 
+		if (tp->low_latency.enabled)
+			tp_motion_smooth(tp, t);
 		tp_motion_hysteresis(tp, t);
 		tp_motion_history_push(t);
 
@@ -1194,21 +1236,17 @@ tp_post_process_state(struct tp_dispatch *tp, uint64_t time)
 {
 	struct tp_touch *t;
 
-	tp_for_each_touch(tp, t) {
-
-		if (!t->dirty)
-			continue;
-
+	tp_for_each_dirty_touch(tp, t) {
 		if (t->state == TOUCH_END) {
 			if (t->has_ended)
-				t->state = TOUCH_NONE;
+				tp_touch_set_state(tp, t, TOUCH_NONE);
 			else
-				t->state = TOUCH_HOVERING;
+				tp_touch_set_state(tp, t, TOUCH_HOVERING);
 		} else if (t->state == TOUCH_BEGIN) {
-			t->state = TOUCH_UPDATE;
+			tp_touch_set_state(tp, t, TOUCH_UPDATE);
 		}
 
-		t->dirty = false;
+		tp_touch_set_dirty(tp, t, false);
 	}
 
 	tp->old_nfingers_down = tp->nfingers_down;
@@ -1247,14 +1285,96 @@ tp_post_events(struct tp_dispatch *tp, uint64_t time)
 	tp_gesture_post_events(tp, time);
 }
 
+static uint64_t
+tp_deadlines_earliest(const struct tp_dispatch *tp)
+{
+	uint64_t earliest = UINT64_MAX;
+	unsigned int i;
+
+	for (i = 0; i < tp->ntouches; i++) {
+		const struct tp_touch_ext *ext = &tp->touch_ext[i];
+
+		if (ext->button_deadline && ext->button_deadline < earliest)
+			earliest = ext->button_deadline;
+		if (ext->scroll_deadline && ext->scroll_deadline < earliest)
+			earliest = ext->scroll_deadline;
+	}
+
+	return earliest == UINT64_MAX ? 0 : earliest;
+}
+
+static void
+tp_deadlines_rearm(struct tp_dispatch *tp)
+{
+	uint64_t earliest = tp_deadlines_earliest(tp);
+
+	if (earliest == tp->deadlines.timer.expire)
+		return;
+
+	/* A deadline may have passed while the timer was armed for an
+	 * earlier one that got cancelled, it fires immediately */
+	if (earliest)
+		libinput_timer_set_flags(&tp->deadlines.timer,
+					 earliest,
+					 TIMER_FLAG_ALLOW_NEGATIVE);
+	else
+		libinput_timer_cancel(&tp->deadlines.timer);
+}
+
+void
+tp_touch_set_deadline(struct tp_dispatch *tp,
+		      uint64_t *deadline,
+		      uint64_t expire)
+{
+	*deadline = expire;
+
+	if (tp->deadlines.defer)
+		return;
+
+	if (tp->deadlines.timer.expire == 0 ||
+	    expire < tp->deadlines.timer.expire)
+		libinput_timer_set(&tp->deadlines.timer, expire);
+}
+
+static void
+tp_deadlines_timeout(uint64_t now, void *data)
+{
+	struct tp_dispatch *tp = data;
+	struct tp_touch *t;
+
+	tp->deadlines.defer = true;
+
+	tp_for_each_touch(tp, t) {
+		struct tp_touch_ext *ext = tp_touch_ext(t);
+
+		if (ext->button_deadline && ext->button_deadline <= now) {
+			ext->button_deadline = 0;
+			tp_button_handle_timeout(tp, t, now);
+		}
+
+		if (ext->scroll_deadline && ext->scroll_deadline <= now) {
+			ext->scroll_deadline = 0;
+			tp_edge_scroll_handle_timeout(tp, t, now);
+		}
+	}
+
+	tp->deadlines.defer = false;
+	tp_deadlines_rearm(tp);
+}
+
 static void
 tp_handle_state(struct tp_dispatch *tp,
 		uint64_t time)
 {
+	tp->deadlines.defer = true;
+
 	tp_process_state(tp, time);
 	tp_post_events(tp, time);
 	tp_post_process_state(tp, time);
 
+	tp->deadlines.defer = false;
+	tp_deadlines_rearm(tp);
+
 	tp_clickpad_middlebutton_apply_config(tp->device);
 }
 
@@ -1340,6 +1460,8 @@ tp_interface_remove(struct evdev_dispatch *dispatch)
 	tp_remove_sendevents(tp);
 	tp_remove_edge_scroll(tp);
 	tp_remove_gesture(tp);
+
+	libinput_timer_cancel(&tp->deadlines.timer);
 }
 
 static void
@@ -1347,6 +1469,9 @@ tp_interface_destroy(struct evdev_dispatch *dispatch)
 {
 	struct tp_dispatch *tp = tp_dispatch(dispatch);
 
+	free(tp->active_touches);
+	free(tp->dirty_touches);
+	free(tp->touch_ext);
 	free(tp->touches);
 	free(tp);
 }
@@ -1441,11 +1566,6 @@ tp_trackpoint_event(uint64_t time, struct libinput_event *event, void *data)
 {
 	struct tp_dispatch *tp = data;
 
-	/* Buttons do not count as trackpad activity, as people may use
-	   the trackpoint buttons in combination with the touchpad. */
-	if (event->type == LIBINPUT_EVENT_POINTER_BUTTON)
-		return;
-
 	tp->palm.trackpoint_last_event_time = time;
 	tp->palm.trackpoint_event_count++;
 
@@ -1467,11 +1587,19 @@ tp_keyboard_timeout(uint64_t now, void *data)
 {
 	struct tp_dispatch *tp = data;
 
+	/* More keys were pressed since the timer was set */
+	if (now < tp->dwt.keyboard_deadline) {
+		libinput_timer_set(&tp->dwt.keyboard_timer,
+				   tp->dwt.keyboard_deadline);
+		return;
+	}
+
 	if (tp->dwt.dwt_enabled &&
 	    long_any_bit_set(tp->dwt.key_mask,
 			     ARRAY_LENGTH(tp->dwt.key_mask))) {
+		tp->dwt.keyboard_deadline = now + DEFAULT_KEYBOARD_ACTIVITY_TIMEOUT_2;
 		libinput_timer_set(&tp->dwt.keyboard_timer,
-				   now + DEFAULT_KEYBOARD_ACTIVITY_TIMEOUT_2);
+				   tp->dwt.keyboard_deadline);
 		tp->dwt.keyboard_last_press_time = now;
 		evdev_log_debug(tp->device, "palm: keyboard timeout refresh\n");
 		return;
@@ -1520,6 +1648,19 @@ tp_key_ignore_for_dwt(unsigned int keycode)
 	return keycode >= KEY_F1;
 }
 
+static inline void
+tp_keyboard_set_deadline(struct tp_dispatch *tp, uint64_t deadline)
+{
+	tp->dwt.keyboard_deadline = deadline;
+
+	/* Only arm the timer if it isn't already armed for an earlier
+	 * time, tp_keyboard_timeout() takes care of the rest. Saves
+	 * re-arming it on every key press while typing. */
+	if (tp->dwt.keyboard_timer.expire == 0 ||
+	    deadline < tp->dwt.keyboard_timer.expire)
+		libinput_timer_set(&tp->dwt.keyboard_timer, deadline);
+}
+
 static void
 tp_keyboard_event(uint64_t time, struct libinput_event *event, void *data)
 {
@@ -1527,10 +1668,6 @@ tp_keyboard_event(uint64_t time, struct libinput_event *event, void *data)
 	struct libinput_event_keyboard *kbdev;
 	unsigned int timeout;
 	unsigned int key;
-	bool is_modifier;
-
-	if (event->type != LIBINPUT_EVENT_KEYBOARD_KEY)
-		return;
 
 	kbdev = libinput_event_get_keyboard_event(event);
 	key = libinput_event_keyboard_get_key(kbdev);
@@ -1546,13 +1683,12 @@ tp_keyboard_event(uint64_t time, struct libinput_event *event, void *data)
 	if (!tp->dwt.dwt_enabled)
 		return;
 
-	if (tp_key_ignore_for_dwt(key))
+	if (long_bit_is_set(tp->dwt.ignored_keys, key))
 		return;
 
 	/* modifier keys don't trigger disable-while-typing so things like
 	 * ctrl+zoom or ctrl+click are possible */
-	is_modifier = tp_key_is_modifier(key);
-	if (is_modifier) {
+	if (long_bit_is_set(tp->dwt.modifier_keys, key)) {
 		long_set_bit(tp->dwt.mod_mask, key);
 		return;
 	}
@@ -1576,8 +1712,7 @@ tp_keyboard_event(uint64_t time, struct libinput_event *event, void *data)
 
 	tp->dwt.keyboard_last_press_time = time;
 	long_set_bit(tp->dwt.key_mask, key);
-	libinput_timer_set(&tp->dwt.keyboard_timer,
-			   time + timeout);
+	tp_keyboard_set_deadline(tp, time + timeout);
 }
 
 static bool
@@ -1601,6 +1736,26 @@ tp_want_dwt(struct evdev_device *touchpad,
 	return false;
 }
 
+static void
+tp_dwt_init_key_masks(struct tp_dispatch *tp,
+		      struct evdev_device *keyboard)
+{
+	unsigned int code;
+
+	memset(tp->dwt.ignored_keys, 0, sizeof(tp->dwt.ignored_keys));
+	memset(tp->dwt.modifier_keys, 0, sizeof(tp->dwt.modifier_keys));
+
+	for (code = 0; code < KEY_CNT; code++) {
+		if (!libevdev_has_event_code(keyboard->evdev, EV_KEY, code))
+			continue;
+
+		if (tp_key_is_modifier(code))
+			long_set_bit(tp->dwt.modifier_keys, code);
+		else if (tp_key_ignore_for_dwt(code))
+			long_set_bit(tp->dwt.ignored_keys, code);
+	}
+}
+
 static void
 tp_dwt_pair_keyboard(struct evdev_device *touchpad,
 		     struct evdev_device *keyboard)
@@ -1616,9 +1771,11 @@ tp_dwt_pair_keyboard(struct evdev_device *touchpad,
 	if (!tp_want_dwt(touchpad, keyboard))
 		return;
 
+	tp_dwt_init_key_masks(tp, keyboard);
 	libinput_device_add_event_listener(&keyboard->base,
-					   &tp->dwt.keyboard_listener,
-					   tp_keyboard_event, tp);
+				&tp->dwt.keyboard_listener,
+				event_listener_mask(LIBINPUT_EVENT_KEYBOARD_KEY),
+				tp_keyboard_event, tp);
 	tp->dwt.keyboard = keyboard;
 	tp->dwt.keyboard_active = false;
 
@@ -1636,10 +1793,17 @@ tp_pair_trackpoint(struct evdev_device *touchpad,
 	unsigned int bus_tp = libevdev_get_id_bustype(touchpad->evdev),
 		     bus_trp = libevdev_get_id_bustype(trackpoint->evdev);
 	bool tp_is_internal, trp_is_internal;
+	uint64_t mask;
 
 	if ((trackpoint->tags & EVDEV_TAG_TRACKPOINT) == 0)
 		return;
 
+	/* Buttons do not count as trackpoint activity, as people may use
+	   the trackpoint buttons in combination with the touchpad. */
+	mask = event_listener_mask(LIBINPUT_EVENT_POINTER_MOTION) |
+	       event_listener_mask(LIBINPUT_EVENT_POINTER_MOTION_ABSOLUTE) |
+	       event_listener_mask(LIBINPUT_EVENT_POINTER_AXIS);
+
 	tp_is_internal = bus_tp != BUS_USB && bus_tp != BUS_BLUETOOTH;
 	trp_is_internal = bus_trp != BUS_USB && bus_trp != BUS_BLUETOOTH;
 
@@ -1651,6 +1815,7 @@ tp_pair_trackpoint(struct evdev_device *touchpad,
 		if (tp->palm.monitor_trackpoint)
 			libinput_device_add_event_listener(&trackpoint->base,
 						&tp->palm.trackpoint_listener,
+						mask,
 						tp_trackpoint_event, tp);
 	}
 }
@@ -1661,9 +1826,6 @@ tp_lid_switch_event(uint64_t time, struct libinput_event *event, void *data)
 	struct tp_dispatch *tp = data;
 	struct libinput_event_switch *swev;
 
-	if (libinput_event_get_type(event) != LIBINPUT_EVENT_SWITCH_TOGGLE)
-		return;
-
 	swev = libinput_event_get_switch_event(event);
 	switch (libinput_event_switch_get_switch_state(swev)) {
 	case LIBINPUT_SWITCH_STATE_OFF:
@@ -1694,6 +1856,7 @@ tp_pair_lid_switch(struct evdev_device *touchpad,
 
 		libinput_device_add_event_listener(&lid_switch->base,
 					&tp->lid_switch.lid_switch_listener,
+					event_listener_mask(LIBINPUT_EVENT_SWITCH_TOGGLE),
 					tp_lid_switch_event, tp);
 		tp->lid_switch.lid_switch = lid_switch;
 	}
@@ -1985,7 +2148,13 @@ tp_init_slots(struct tp_dispatch *tp,
 
 	tp->ntouches = max(tp->num_slots, n_btn_tool_touches);
 	tp->touches = calloc(tp->ntouches, sizeof(struct tp_touch));
-	if (!tp->touches)
+	tp->touch_ext = calloc(tp->ntouches, sizeof(struct tp_touch_ext));
+	if (!tp->touches || !tp->touch_ext)
+		return false;
+
+	tp->active_touches = zalloc(NLONGS(tp->ntouches) * sizeof(unsigned long));
+	tp->dirty_touches = zalloc(NLONGS(tp->ntouches) * sizeof(unsigned long));
+	if (!tp->active_touches || !tp->dirty_touches)
 		return false;
 
 	for (i = 0; i < tp->ntouches; i++)
@@ -2450,6 +2619,114 @@ tp_init_hysteresis(struct tp_dispatch *tp)
 	tp->hysteresis_margin.y = res_y/2;
 }
 
+static int
+tp_low_latency_config_is_available(struct libinput_device *device)
+{
+	return 1;
+}
+
+static enum libinput_config_status
+tp_low_latency_config_set(struct libinput_device *device,
+			  enum libinput_config_low_latency_state enable)
+{
+	struct evdev_device *evdev = evdev_device(device);
+	struct tp_dispatch *tp = (struct tp_dispatch*)evdev->dispatch;
+	struct tp_touch *t;
+
+	switch(enable) {
+	case LIBINPUT_CONFIG_LOW_LATENCY_ENABLED:
+	case LIBINPUT_CONFIG_LOW_LATENCY_DISABLED:
+		break;
+	default:
+		return LIBINPUT_CONFIG_STATUS_INVALID;
+	}
+
+	/* touches already down start filtering from their current
+	 * position */
+	tp_for_each_touch(tp, t)
+		one_euro_reset(&t->smoothing);
+
+	tp->low_latency.enabled = (enable == LIBINPUT_CONFIG_LOW_LATENCY_ENABLED);
+
+	return LIBINPUT_CONFIG_STATUS_SUCCESS;
+}
+
+static enum libinput_config_low_latency_state
+tp_low_latency_config_get(struct libinput_device *device)
+{
+	struct evdev_device *evdev = evdev_device(device);
+	struct tp_dispatch *tp = (struct tp_dispatch*)evdev->dispatch;
+
+	return tp->low_latency.enabled ?
+		LIBINPUT_CONFIG_LOW_LATENCY_ENABLED :
+		LIBINPUT_CONFIG_LOW_LATENCY_DISABLED;
+}
+
+static enum libinput_config_low_latency_state
+tp_low_latency_config_get_default(struct libinput_device *device)
+{
+	return LIBINPUT_CONFIG_LOW_LATENCY_DISABLED;
+}
+
+static void
+tp_low_latency_set_params(struct tp_dispatch *tp, double smoothing)
+{
+	const double max_cutoff = 30.0, /* Hz, at smoothing 0 */
+		     min_cutoff = 0.5;  /* Hz, at smoothing 1 */
+
+	/* The cutoff at zero speed is what trades jitter for latency,
+	 * interpolate it logarithmically so the whole smoothing range is
+	 * useful */
+	tp->low_latency.smoothing = smoothing;
+	tp->low_latency.params.min_cutoff = max_cutoff *
+					    pow(min_cutoff/max_cutoff, smoothing);
+	tp->low_latency.params.beta = 0.1; /* Hz per mm/s */
+	tp->low_latency.params.dcutoff = 1.0;
+}
+
+static enum libinput_config_status
+tp_low_latency_config_set_smoothing(struct libinput_device *device,
+				    double smoothing)
+{
+	struct evdev_device *evdev = evdev_device(device);
+	struct tp_dispatch *tp = (struct tp_dispatch*)evdev->dispatch;
+
+	tp_low_latency_set_params(tp, smoothing);
+
+	return LIBINPUT_CONFIG_STATUS_SUCCESS;
+}
+
+static double
+tp_low_latency_config_get_smoothing(struct libinput_device *device)
+{
+	struct evdev_device *evdev = evdev_device(device);
+	struct tp_dispatch *tp = (struct tp_dispatch*)evdev->dispatch;
+
+	return tp->low_latency.smoothing;
+}
+
+static double
+tp_low_latency_config_get_default_smoothing(struct libinput_device *device)
+{
+	return TP_LOW_LATENCY_DEFAULT_SMOOTHING;
+}
+
+static void
+tp_init_low_latency(struct tp_dispatch *tp,
+		    struct evdev_device *device)
+{
+	tp->low_latency.config.is_available = tp_low_latency_config_is_available;
+	tp->low_latency.config.set_enabled = tp_low_latency_config_set;
+	tp->low_latency.config.get_enabled = tp_low_latency_config_get;
+	tp->low_latency.config.get_default_enabled = tp_low_latency_config_get_default;
+	tp->low_latency.config.set_smoothing = tp_low_latency_config_set_smoothing;
+	tp->low_latency.config.get_smoothing = tp_low_latency_config_get_smoothing;
+	tp->low_latency.config.get_default_smoothing = tp_low_latency_config_get_default_smoothing;
+	tp->low_latency.enabled = false;
+	tp_low_latency_set_params(tp, TP_LOW_LATENCY_DEFAULT_SMOOTHING);
+	device->base.config.low_latency = &tp->low_latency.config;
+}
+
 static void
 tp_init_pressure(struct tp_dispatch *tp,
 		 struct evdev_device *device)
@@ -2525,6 +2802,10 @@ tp_init(struct tp_dispatch *tp,
 	if (!tp_init_slots(tp, device))
 		return false;
 
+	libinput_timer_init(&tp->deadlines.timer,
+			    tp_libinput_context(tp),
+			    tp_deadlines_timeout, tp);
+
 	evdev_device_init_abs_range_warnings(device);
 
 	tp_init_pressure(tp, device);
@@ -2534,6 +2815,7 @@ tp_init(struct tp_dispatch *tp,
 	device->dpi = device->abs.absinfo_x->resolution * 25.4;
 
 	tp_init_hysteresis(tp);
+	tp_init_low_latency(tp, device);
 
 	if (!tp_init_accel(tp))
 		return false;
@@ -104,6 +104,150 @@ enum tp_tap_state {
 	TAP_STATE_DEAD, /**< finger count exceeded */
 };
 
+#define TAP_STATE_COUNT (TAP_STATE_DEAD - TAP_STATE_IDLE + 1)
+
+enum tap_event {
+	TAP_EVENT_TOUCH = 12,
+	TAP_EVENT_MOTION,
+	TAP_EVENT_RELEASE,
+	TAP_EVENT_BUTTON,
+	TAP_EVENT_TIMEOUT,
+	TAP_EVENT_THUMB,
+};
+
+#define TAP_EVENT_COUNT (TAP_EVENT_THUMB - TAP_EVENT_TOUCH + 1)
+
+/* The tap state machine, one entry for every state and event:
+ * T(state, event, action, next state)
+ *
+ * The action is tp_tap_action_<action>() in evdev-mt-touchpad-tap.c, it
+ * returns the state to switch to, usually the next state given here.
+ * Where the transition depends on a config option, the next state is the
+ * one when that option is enabled.
+ *
+ * Look at the state diagram in doc/touchpad-tap-state-machine.svg, any
+ * changes here must be represented in the diagram.
+ */
+#define TAP_TRANSITIONS(T) \
+	T(IDLE,			TOUCH,		press,		TOUCH) \
+	T(IDLE,			MOTION,		bug_no_fingers,	IDLE) \
+	T(IDLE,			RELEASE,	none,		IDLE) \
+	T(IDLE,			BUTTON,		none,		DEAD) \
+	T(IDLE,			TIMEOUT,	none,		IDLE) \
+	T(IDLE,			THUMB,		bug_no_thumb,	IDLE) \
+	\
+	T(TOUCH,		TOUCH,		press,		TOUCH_2) \
+	T(TOUCH,		MOTION,		clear_timer,	HOLD) \
+	T(TOUCH,		RELEASE,	tap_or_drag,	TAPPED) \
+	T(TOUCH,		BUTTON,		none,		DEAD) \
+	T(TOUCH,		TIMEOUT,	clear_timer,	HOLD) \
+	T(TOUCH,		THUMB,		thumb,		IDLE) \
+	\
+	T(HOLD,			TOUCH,		press,		TOUCH_2) \
+	T(HOLD,			MOTION,		none,		HOLD) \
+	T(HOLD,			RELEASE,	none,		IDLE) \
+	T(HOLD,			BUTTON,		none,		DEAD) \
+	T(HOLD,			TIMEOUT,	none,		HOLD) \
+	T(HOLD,			THUMB,		thumb,		IDLE) \
+	\
+	T(TAPPED,		TOUCH,		press,		DRAGGING_OR_DOUBLETAP) \
+	T(TAPPED,		MOTION,		bug_fingers_up,	TAPPED) \
+	T(TAPPED,		RELEASE,	bug_fingers_up,	TAPPED) \
+	T(TAPPED,		BUTTON,		release_saved,	DEAD) \
+	T(TAPPED,		TIMEOUT,	release_saved,	IDLE) \
+	T(TAPPED,		THUMB,		none,		TAPPED) \
+	\
+	T(TOUCH_2,		TOUCH,		press,		TOUCH_3) \
+	T(TOUCH_2,		MOTION,		clear_timer,	TOUCH_2_HOLD) \
+	T(TOUCH_2,		RELEASE,	release_timer,	TOUCH_2_RELEASE) \
+	T(TOUCH_2,		BUTTON,		none,		DEAD) \
+	T(TOUCH_2,		TIMEOUT,	none,		TOUCH_2_HOLD) \
+	T(TOUCH_2,		THUMB,		none,		TOUCH_2) \
+	\
+	T(TOUCH_2_HOLD,		TOUCH,		press,		TOUCH_3) \
+	T(TOUCH_2_HOLD,		MOTION,		none,		TOUCH_2_HOLD) \
+	T(TOUCH_2_HOLD,		RELEASE,	none,		HOLD) \
+	T(TOUCH_2_HOLD,		BUTTON,		none,		DEAD) \
+	T(TOUCH_2_HOLD,		TIMEOUT,	none,		TOUCH_2_HOLD) \
+	T(TOUCH_2_HOLD,		THUMB,		none,		TOUCH_2_HOLD) \
+	\
+	T(TOUCH_2_RELEASE,	TOUCH,		touch_dead,	TOUCH_2_HOLD) \
+	T(TOUCH_2_RELEASE,	MOTION,		none,		HOLD) \
+	T(TOUCH_2_RELEASE,	RELEASE,	tap_2fg,	IDLE) \
+	T(TOUCH_2_RELEASE,	BUTTON,		none,		DEAD) \
+	T(TOUCH_2_RELEASE,	TIMEOUT,	none,		HOLD) \
+	T(TOUCH_2_RELEASE,	THUMB,		none,		TOUCH_2_RELEASE) \
+	\
+	T(TOUCH_3,		TOUCH,		none,		DEAD) \
+	T(TOUCH_3,		MOTION,		clear_timer,	TOUCH_3_HOLD) \
+	T(TOUCH_3,		RELEASE,	tap_3fg,	TOUCH_2_HOLD) \
+	T(TOUCH_3,		BUTTON,		none,		DEAD) \
+	T(TOUCH_3,		TIMEOUT,	clear_timer,	TOUCH_3_HOLD) \
+	T(TOUCH_3,		THUMB,		none,		TOUCH_3) \
+	\
+	T(TOUCH_3_HOLD,		TOUCH,		none,		DEAD) \
+	T(TOUCH_3_HOLD,		MOTION,		none,		TOUCH_3_HOLD) \
+	T(TOUCH_3_HOLD,		RELEASE,	none,		TOUCH_2_HOLD) \
+	T(TOUCH_3_HOLD,		BUTTON,		none,		DEAD) \
+	T(TOUCH_3_HOLD,		TIMEOUT,	none,		TOUCH_3_HOLD) \
+	T(TOUCH_3_HOLD,		THUMB,		none,		TOUCH_3_HOLD) \
+	\
+	T(DRAGGING_OR_DOUBLETAP, TOUCH,		none,		DRAGGING_2) \
+	T(DRAGGING_OR_DOUBLETAP, MOTION,	none,		DRAGGING) \
+	T(DRAGGING_OR_DOUBLETAP, RELEASE,	multitap_release, MULTITAP) \
+	T(DRAGGING_OR_DOUBLETAP, BUTTON,	release_saved,	DEAD) \
+	T(DRAGGING_OR_DOUBLETAP, TIMEOUT,	none,		DRAGGING) \
+	T(DRAGGING_OR_DOUBLETAP, THUMB,		none,		DRAGGING_OR_DOUBLETAP) \
+	\
+	T(DRAGGING_OR_TAP,	TOUCH,		clear_timer,	DRAGGING_2) \
+	T(DRAGGING_OR_TAP,	MOTION,		none,		DRAGGING) \
+	T(DRAGGING_OR_TAP,	RELEASE,	release,	IDLE) \
+	T(DRAGGING_OR_TAP,	BUTTON,		release,	DEAD) \
+	T(DRAGGING_OR_TAP,	TIMEOUT,	none,		DRAGGING) \
+	T(DRAGGING_OR_TAP,	THUMB,		none,		DRAGGING_OR_TAP) \
+	\
+	T(DRAGGING,		TOUCH,		none,		DRAGGING_2) \
+	T(DRAGGING,		MOTION,		none,		DRAGGING) \
+	T(DRAGGING,		RELEASE,	drag_release,	DRAGGING_WAIT) \
+	T(DRAGGING,		BUTTON,		release,	DEAD) \
+	T(DRAGGING,		TIMEOUT,	none,		DRAGGING) \
+	T(DRAGGING,		THUMB,		none,		DRAGGING) \
+	\
+	T(DRAGGING_WAIT,	TOUCH,		set_timer,	DRAGGING_OR_TAP) \
+	T(DRAGGING_WAIT,	MOTION,		none,		DRAGGING_WAIT) \
+	T(DRAGGING_WAIT,	RELEASE,	none,		DRAGGING_WAIT) \
+	T(DRAGGING_WAIT,	BUTTON,		release,	DEAD) \
+	T(DRAGGING_WAIT,	TIMEOUT,	release,	IDLE) \
+	T(DRAGGING_WAIT,	THUMB,		none,		DRAGGING_WAIT) \
+	\
+	T(DRAGGING_2,		TOUCH,		release,	DEAD) \
+	T(DRAGGING_2,		MOTION,		none,		DRAGGING_2) \
+	T(DRAGGING_2,		RELEASE,	none,		DRAGGING) \
+	T(DRAGGING_2,		BUTTON,		release,	DEAD) \
+	T(DRAGGING_2,		TIMEOUT,	none,		DRAGGING_2) \
+	T(DRAGGING_2,		THUMB,		none,		DRAGGING_2) \
+	\
+	T(MULTITAP,		TOUCH,		multitap_press,	MULTITAP_DOWN) \
+	T(MULTITAP,		MOTION,		bug_no_fingers,	MULTITAP) \
+	T(MULTITAP,		RELEASE,	bug_no_fingers,	MULTITAP) \
+	T(MULTITAP,		BUTTON,		none,		IDLE) \
+	T(MULTITAP,		TIMEOUT,	tap_1fg,	IDLE) \
+	T(MULTITAP,		THUMB,		none,		MULTITAP) \
+	\
+	T(MULTITAP_DOWN,	TOUCH,		clear_timer,	DRAGGING_2) \
+	T(MULTITAP_DOWN,	MOTION,		clear_timer,	DRAGGING) \
+	T(MULTITAP_DOWN,	RELEASE,	multitap_release, MULTITAP) \
+	T(MULTITAP_DOWN,	BUTTON,		release_saved,	DEAD) \
+	T(MULTITAP_DOWN,	TIMEOUT,	clear_timer,	DRAGGING) \
+	T(MULTITAP_DOWN,	THUMB,		none,		MULTITAP_DOWN) \
+	\
+	T(DEAD,			TOUCH,		none,		DEAD) \
+	T(DEAD,			MOTION,		none,		DEAD) \
+	T(DEAD,			RELEASE,	dead_release,	IDLE) \
+	T(DEAD,			BUTTON,		none,		DEAD) \
+	T(DEAD,			TIMEOUT,	none,		DEAD) \
+	T(DEAD,			THUMB,		none,		DEAD)
+
 enum tp_tap_touch_state {
 	TAP_TOUCH_STATE_IDLE = 16,	/**< not in touch */
 	TAP_TOUCH_STATE_TOUCH,		/**< touching, may tap */
@@ -138,18 +282,37 @@ enum tp_thumb_state {
 	THUMB_STATE_MAYBE,
 };
 
+/* The members are ordered so that the ones every per-frame pass reads
+ * (state, position, motion history) share the first cache line.
+ * The timeouts and palm coordinates, only used on a state change or for
+ * a palm, live in struct tp_touch_ext instead. */
 struct tp_touch {
 	struct tp_dispatch *tp;
 	enum touch_state state;
-	bool has_ended;				/* TRACKING_ID == -1 */
 	bool dirty;
+	bool has_ended;				/* TRACKING_ID == -1 */
+	bool is_tool_palm; /* MT_TOOL_PALM */
+	bool was_down; /* if distance == 0, false for pure hovering
+			  touches */
 	struct device_coords point;
 	uint64_t time;
 	int pressure;
-	bool is_tool_palm; /* MT_TOOL_PALM */
 
-	bool was_down; /* if distance == 0, false for pure hovering
-			  touches */
+	struct {
+		struct device_coords samples[TOUCHPAD_HISTORY_LENGTH];
+		unsigned int index;
+		unsigned int count;
+	} history;
+
+	struct device_coords hysteresis_center;
+
+	/* Low-latency mode only: the filtered kernel position, only used
+	 * for the pointer and scroll deltas, see tp_get_delta() */
+	struct {
+		struct device_coords point;
+		struct device_coords last;
+	} smoothed;
+	struct one_euro_state smoothing;
 
 	struct {
 		/* A quirk mostly used on Synaptics touchpads. In a
@@ -160,14 +323,6 @@ struct tp_touch {
 		bool reset_motion_history;
 	} quirks;
 
-	struct {
-		struct device_coords samples[TOUCHPAD_HISTORY_LENGTH];
-		unsigned int index;
-		unsigned int count;
-	} history;
-
-	struct device_coords hysteresis_center;
-
 	/* A pinned touchpoint is the one that pressed the physical button
 	 * on a clickpad. After the release, it won't move until the center
 	 * moves more than a threshold away from the original coordinates
@@ -177,12 +332,25 @@ struct tp_touch {
 		struct device_coords center;
 	} pinned;
 
-	/* Software-button state and timeout if applicable */
+	/* The state is checked for every touch in every frame, the
+	 * coordinates and timestamps are in tp_touch_ext */
+	struct {
+		enum touch_palm_state state;
+	} palm;
+
+	/* Read in every frame while the state is THUMB_STATE_MAYBE, which
+	 * is where every new touch starts */
+	struct {
+		enum tp_thumb_state state;
+		uint64_t first_touch_time;
+		struct device_coords initial;
+	} thumb;
+
+	/* Software-button state, the timeout is in tp_touch_ext */
 	struct {
 		enum button_state state;
 		/* We use button_event here so we can use == on events */
 		enum button_event curr;
-		struct libinput_timer timer;
 	} button;
 
 	struct {
@@ -191,29 +359,33 @@ struct tp_touch {
 		bool is_thumb;
 	} tap;
 
+	/* Edge scroll state, the timeout is in tp_touch_ext */
 	struct {
 		enum tp_edge_scroll_touch_state edge_state;
 		uint32_t edge;
 		int direction;
-		struct libinput_timer timer;
 		struct device_coords initial;
 	} scroll;
 
-	struct {
-		enum touch_palm_state state;
-		struct device_coords first; /* first coordinates if is_palm == true */
-		uint64_t time; /* first timestamp if is_palm == true */
-	} palm;
-
 	struct {
 		struct device_coords initial;
 	} gesture;
+};
+
+/* Per-touch timeouts and palm coordinates, only needed when a touch
+ * changes state or is a palm. Kept in a separate array so they don't
+ * share cache lines with the touches.
+ * touch_ext[n] belongs to touches[n], see tp_touch_ext() */
+struct tp_touch_ext {
+	/* Absolute timeouts in us, 0 if unset. They are all served by
+	 * tp->deadlines.timer, see tp_touch_set_deadline() */
+	uint64_t button_deadline;
+	uint64_t scroll_deadline;
 
 	struct {
-		enum tp_thumb_state state;
-		uint64_t first_touch_time;
-		struct device_coords initial;
-	} thumb;
+		struct device_coords first; /* first coordinates if is_palm == true */
+		uint64_t time; /* first timestamp if is_palm == true */
+	} palm;
 };
 
 struct tp_dispatch {
@@ -232,6 +404,23 @@ struct tp_dispatch {
 	unsigned int num_slots;			/* number of slots */
 	unsigned int ntouches;			/* no slots inc. fakes */
 	struct tp_touch *touches;		/* len == ntouches */
+	struct tp_touch_ext *touch_ext;		/* len == ntouches */
+
+	/* One timer for all per-touch deadlines in touch_ext */
+	struct {
+		struct libinput_timer timer;
+		/* set while a frame or a timeout is processed, the timer
+		 * is re-armed once at the end */
+		bool defer;
+	} deadlines;
+
+	/* Bitmaps of NLONGS(ntouches), bit n refers to touches[n].
+	 * A touch is active when it is not TOUCH_NONE or still has
+	 * changes pending for this frame. The per-frame passes only
+	 * iterate over the bits set here, use tp_touch_set_state() and
+	 * tp_touch_set_dirty() to keep them in sync. */
+	unsigned long *active_touches;
+	unsigned long *dirty_touches;
 	/* bit 0: BTN_TOUCH
 	 * bit 1: BTN_TOOL_FINGER
 	 * bit 2: BTN_TOOL_DOUBLETAP
@@ -267,6 +456,18 @@ struct tp_dispatch {
 		double prev_scale;
 		double angle;
 		struct device_float_coords center;
+
+		/* Active touches of the current frame, collected once by
+		 * tp_gesture_handle_state() so the state machine doesn't
+		 * have to walk the touches again */
+		struct {
+			unsigned int ntouches;
+			struct tp_touch *touches[4];
+			/* touches within num_slots, i.e. not fake touches,
+			 * and the sum of their deltas */
+			unsigned int nslots;
+			struct normalized_coords delta;
+		} active;
 	} gesture;
 
 	struct {
@@ -299,6 +500,14 @@ struct tp_dispatch {
 			int32_t leftbutton_right_edge; /* in device coordinates */
 		} top_area;
 
+		/* The button areas of each band, precomputed from the edges
+		 * above. A touch inside the band at x is in
+		 * events[(x > edges[0]) + (x > edges[1])] */
+		struct tp_softbutton_columns {
+			int32_t edges[2]; /* in device coordinates, sorted */
+			enum button_event events[3];
+		} bottom_columns, top_columns;
+
 		struct evdev_device *trackpoint;
 
 		enum libinput_config_click_method click_method;
@@ -350,6 +559,13 @@ struct tp_dispatch {
 		enum libinput_config_send_events_mode current_mode;
 	} sendevents;
 
+	struct {
+		struct libinput_device_config_low_latency config;
+		bool enabled;
+		double smoothing;
+		struct one_euro_params params;	/* in mm */
+	} low_latency;
+
 	struct {
 		struct libinput_device_config_dwt config;
 		bool dwt_enabled;
@@ -361,7 +577,14 @@ struct tp_dispatch {
 		unsigned long key_mask[NLONGS(KEY_CNT)];
 		unsigned long mod_mask[NLONGS(KEY_CNT)];
 
+		/* Keys of the paired keyboard, filled in on pairing */
+		unsigned long ignored_keys[NLONGS(KEY_CNT)];
+		unsigned long modifier_keys[NLONGS(KEY_CNT)];
+
 		uint64_t keyboard_last_press_time;
+		/* keyboard_timer may be armed for an earlier time, it
+		 * re-arms itself until this deadline has passed */
+		uint64_t keyboard_deadline;
 	} dwt;
 
 	struct {
@@ -399,6 +622,94 @@ tp_dispatch(struct evdev_dispatch *dispatch)
 #define tp_for_each_touch(_tp, _t) \
 	for (unsigned int _i = 0; _i < (_tp)->ntouches && (_t = &(_tp)->touches[_i]); _i++)
 
+/* @return the index of the first bit set in mask at or after start, or
+ * ntouches if there is none */
+static inline unsigned int
+tp_touch_mask_next(const unsigned long *mask,
+		   unsigned int ntouches,
+		   unsigned int start)
+{
+	while (start < ntouches) {
+		unsigned long bits = mask[start / LONG_BITS] >> (start % LONG_BITS);
+
+		if (bits) {
+			start += __builtin_ctzl(bits);
+			return min(start, ntouches);
+		}
+
+		start = (start / LONG_BITS + 1) * LONG_BITS;
+	}
+
+	return ntouches;
+}
+
+/* Bits may be cleared while iterating, bits set at or below the current
+ * touch are only seen on the next iteration */
+#define tp_for_each_touch_in_mask(_tp, _t, _mask) \
+	for (unsigned int _i = tp_touch_mask_next((_mask), (_tp)->ntouches, 0); \
+	     _i < (_tp)->ntouches && (_t = &(_tp)->touches[_i]); \
+	     _i = tp_touch_mask_next((_mask), (_tp)->ntouches, _i + 1))
+
+#define tp_for_each_active_touch(_tp, _t) \
+	tp_for_each_touch_in_mask(_tp, _t, (_tp)->active_touches)
+
+#define tp_for_each_dirty_touch(_tp, _t) \
+	tp_for_each_touch_in_mask(_tp, _t, (_tp)->dirty_touches)
+
+static inline unsigned int
+tp_touch_index(const struct tp_dispatch *tp, const struct tp_touch *t)
+{
+	return t - tp->touches;
+}
+
+static inline struct tp_touch_ext *
+tp_touch_ext(const struct tp_touch *t)
+{
+	return &t->tp->touch_ext[tp_touch_index(t->tp, t)];
+}
+
+static inline void
+tp_touch_update_masks(struct tp_dispatch *tp, const struct tp_touch *t)
+{
+	unsigned int idx = tp_touch_index(tp, t);
+
+	long_set_bit_state(tp->active_touches, idx,
+			   t->state != TOUCH_NONE || t->dirty);
+	long_set_bit_state(tp->dirty_touches, idx, t->dirty);
+}
+
+static inline void
+tp_touch_set_state(struct tp_dispatch *tp,
+		   struct tp_touch *t,
+		   enum touch_state state)
+{
+	t->state = state;
+	tp_touch_update_masks(tp, t);
+}
+
+static inline void
+tp_touch_set_dirty(struct tp_dispatch *tp,
+		   struct tp_touch *t,
+		   bool dirty)
+{
+	t->dirty = dirty;
+	tp_touch_update_masks(tp, t);
+}
+
+void
+tp_touch_set_deadline(struct tp_dispatch *tp,
+		      uint64_t *deadline,
+		      uint64_t expire);
+
+/* Cancelling never re-arms the timer: at worst it fires for nothing and
+ * is then re-armed for the next deadline */
+static inline void
+tp_touch_cancel_deadline(struct tp_dispatch *tp,
+			 uint64_t *deadline)
+{
+	*deadline = 0;
+}
+
 static inline struct libinput*
 tp_libinput_context(const struct tp_dispatch *tp)
 {
@@ -484,6 +795,11 @@ tp_init_top_softbuttons(struct tp_dispatch *tp,
 void
 tp_remove_buttons(struct tp_dispatch *tp);
 
+void
+tp_button_handle_timeout(struct tp_dispatch *tp,
+			 struct tp_touch *t,
+			 uint64_t now);
+
 void
 tp_process_button(struct tp_dispatch *tp,
 		  const struct input_event *e,
@@ -526,6 +842,11 @@ tp_edge_scroll_init(struct tp_dispatch *tp, struct evdev_device *device);
 void
 tp_remove_edge_scroll(struct tp_dispatch *tp);
 
+void
+tp_edge_scroll_handle_timeout(struct tp_dispatch *tp,
+			      struct tp_touch *t,
+			      uint64_t now);
+
 void
 tp_edge_scroll_handle_state(struct tp_dispatch *tp, uint64_t time);
 
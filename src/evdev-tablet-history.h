@@ -0,0 +1,115 @@
+/*
+ * Copyright © 2017 Red Hat, Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice (including the next
+ * paragraph) shall be included in all copies or substantial portions of the
+ * Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+
+#ifndef EVDEV_TABLET_HISTORY_H
+#define EVDEV_TABLET_HISTORY_H
+
+#include <string.h>
+
+#include "libinput-private.h"
+
+/* The default smoothing window, LIBINPUT_ATTR_TABLET_SMOOTHING_WINDOW
+ * may set it to anything up to TABLET_HISTORY_MAX_LENGTH */
+#define TABLET_HISTORY_LENGTH 4
+#define TABLET_HISTORY_MAX_LENGTH 8
+
+/* The last samples of the tool position and tilt, smoothed as a running
+ * mean over the window */
+struct tablet_history {
+	unsigned int index;
+	unsigned int count;
+	unsigned int size; /* the smoothing window */
+	struct tablet_axes samples[TABLET_HISTORY_MAX_LENGTH];
+
+	/* Running sums of the smoothed axes over the window */
+	struct {
+		int64_t x, y;
+		double tilt_x, tilt_y;
+	} sum;
+};
+
+static inline void
+tablet_history_init(struct tablet_history *history, unsigned int size)
+{
+	memset(history, 0, sizeof(*history));
+	history->size = size;
+}
+
+static inline void
+tablet_history_reset(struct tablet_history *history)
+{
+	history->count = 0;
+}
+
+static inline void
+tablet_history_sum_add(struct tablet_history *history,
+		       const struct tablet_axes *axes,
+		       int factor)
+{
+	history->sum.x += (int64_t)axes->point.x * factor;
+	history->sum.y += (int64_t)axes->point.y * factor;
+	history->sum.tilt_x += axes->tilt.x * factor;
+	history->sum.tilt_y += axes->tilt.y * factor;
+}
+
+static inline void
+tablet_history_push(struct tablet_history *history,
+		    const struct tablet_axes *axes)
+{
+	unsigned int sz = history->size;
+	unsigned int index = (history->index + 1) % sz;
+
+	/* After a reset, the first sample fills the whole window and the
+	 * sums restart from scratch, otherwise the oldest sample drops out */
+	if (history->count < sz) {
+		unsigned int i;
+
+		for (i = 0; i < sz; i++)
+			history->samples[i] = *axes;
+		memset(&history->sum, 0, sizeof(history->sum));
+		tablet_history_sum_add(history, axes, sz);
+		history->count = sz;
+	} else {
+		tablet_history_sum_add(history, &history->samples[index], -1);
+		tablet_history_sum_add(history, axes, 1);
+		history->samples[index] = *axes;
+	}
+
+	history->index = index;
+}
+
+/* Replaces the position and tilt in axes with their mean over the window */
+static inline void
+tablet_history_smoothen(const struct tablet_history *history,
+			struct tablet_axes *axes)
+{
+	int count = history->size;
+
+	axes->point.x = history->sum.x/count;
+	axes->point.y = history->sum.y/count;
+
+	axes->tilt.x = history->sum.tilt_x/count;
+	axes->tilt.y = history->sum.tilt_y/count;
+}
+
+#endif
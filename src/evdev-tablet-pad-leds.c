@@ -23,9 +23,11 @@
 #include "config.h"
 
 #include <assert.h>
+#include <inttypes.h>
 #include <limits.h>
 #include <sys/stat.h>
 #include <fcntl.h>
+#include <unistd.h>
 
 #include "evdev-tablet-pad.h"
 
@@ -37,6 +39,13 @@ struct pad_led_group {
 	struct libinput_tablet_pad_mode_group base;
 	struct list led_list;
 	struct list toggle_button_list;
+
+	/* sysfs reads, these happen inside libinput_dispatch() */
+	struct {
+		unsigned int reads;
+		uint64_t total_us;
+		uint64_t max_us;
+	} stats;
 };
 
 struct pad_mode_toggle_button {
@@ -75,28 +84,59 @@ pad_mode_toggle_button_destroy(struct pad_mode_toggle_button* button)
 }
 
 static inline int
-pad_led_group_get_mode(struct pad_led_group *group)
+pad_led_is_lit(struct pad_led_group *group, struct pad_mode_led *led)
 {
+	struct libinput *libinput = group->base.device->seat->libinput;
 	char buf[4] = {0};
-	int rc;
 	unsigned int brightness;
+	uint64_t start, duration;
+	int rc;
+
+	start = libinput_now(libinput);
+	rc = pread(led->brightness_fd, buf, sizeof(buf) - 1, 0);
+	duration = libinput_now(libinput) - start;
+
+	group->stats.reads++;
+	group->stats.total_us += duration;
+	group->stats.max_us = max(group->stats.max_us, duration);
+
+	if (rc == -1)
+		return -errno;
+
+	rc = sscanf(buf, "%u\n", &brightness);
+	if (rc != 1)
+		return -EINVAL;
+
+	return brightness != 0;
+}
+
+/* Assumption: only one LED lit up at any time. The LED of the expected
+ * mode is read first, a mode toggle usually only needs that one read. */
+static inline int
+pad_led_group_get_mode(struct pad_led_group *group, int expected_mode)
+{
 	struct pad_mode_led *led;
+	int rc;
 
 	list_for_each(led, &group->led_list, link) {
-		rc = lseek(led->brightness_fd, 0, SEEK_SET);
-		if (rc == -1)
-			return -errno;
+		if (led->mode_idx != expected_mode)
+			continue;
 
-		rc = read(led->brightness_fd, buf, sizeof(buf) - 1);
-		if (rc == -1)
-			return -errno;
+		rc = pad_led_is_lit(group, led);
+		if (rc < 0)
+			return rc;
+		if (rc)
+			return led->mode_idx;
+	}
 
-		rc = sscanf(buf, "%u\n", &brightness);
-		if (rc != 1)
-			return -EINVAL;
+	list_for_each(led, &group->led_list, link) {
+		if (led->mode_idx == expected_mode)
+			continue;
 
-		/* Assumption: only one LED lit up at any time */
-		if (brightness != 0)
+		rc = pad_led_is_lit(group, led);
+		if (rc < 0)
+			return rc;
+		if (rc)
 			return led->mode_idx;
 	}
 
@@ -158,14 +198,23 @@ static void
 pad_led_group_destroy(struct libinput_tablet_pad_mode_group *g)
 {
 	struct pad_led_group *group = (struct pad_led_group *)g;
+	struct libinput *libinput = g->device->seat->libinput;
 	struct pad_mode_toggle_button *button, *tmp;
 	struct pad_mode_led *led, *tmpled;
 
+	if (group->stats.reads > 0)
+		log_debug(libinput,
+			  "pad mode group %u: %u LED reads, %" PRIu64 "us average, %" PRIu64 "us max\n",
+			  g->index,
+			  group->stats.reads,
+			  group->stats.total_us/group->stats.reads,
+			  group->stats.max_us);
+
 	list_for_each_safe(button, tmp, &group->toggle_button_list, link)
 		pad_mode_toggle_button_destroy(button);
 
 	list_for_each_safe(led, tmpled, &group->led_list, link)
-		pad_led_destroy(g->device->seat->libinput, led);
+		pad_led_destroy(libinput, led);
 
 	free(group);
 }
@@ -224,7 +273,7 @@ pad_group_new(struct pad_dispatch *pad,
 		list_insert(&group->led_list, &led->link);
 	}
 
-	rc = pad_led_group_get_mode(group);
+	rc = pad_led_group_get_mode(group, 0);
 	if (rc < 0) {
 		errno = -rc;
 		goto error;
@@ -498,18 +547,13 @@ static int
 pad_init_leds_from_libwacom(struct pad_dispatch *pad,
 			    struct evdev_device *device)
 {
-	WacomDeviceDatabase *db = NULL;
 	WacomDevice *wacom = NULL;
 	int rc = 1;
 
-	db = libwacom_database_new();
-	if (!db) {
-		evdev_log_info(device,
-			       "Failed to initialize libwacom context.\n");
+	if (!pad->libwacom)
 		goto out;
-	}
 
-	wacom = libwacom_new_from_path(db,
+	wacom = libwacom_new_from_path(pad->libwacom,
 				       udev_device_get_devnode(device->udev_device),
 				       WFALLBACK_NONE,
 				       NULL);
@@ -529,8 +573,6 @@ pad_init_leds_from_libwacom(struct pad_dispatch *pad,
 out:
 	if (wacom)
 		libwacom_destroy(wacom);
-	if (db)
-		libwacom_database_destroy(db);
 
 	if (rc != 0)
 		pad_destroy_leds(pad);
@@ -609,7 +651,9 @@ pad_button_update_mode(struct libinput_tablet_pad_mode_group *g,
 	if (!libinput_tablet_pad_mode_group_button_is_toggle(g, button_index))
 		return;
 
-	rc = pad_led_group_get_mode(group);
+	/* The kernel moves to the next mode before we see the button */
+	rc = pad_led_group_get_mode(group,
+				    (g->current_mode + 1) % g->num_modes);
 	if (rc >= 0)
 		group->base.current_mode = rc;
 }
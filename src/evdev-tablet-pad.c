@@ -494,19 +494,40 @@ pad_suspend(struct evdev_dispatch *dispatch,
 	pad_flush(pad, device, libinput_now(libinput));
 }
 
+static inline void
+pad_libwacom_unref(struct pad_dispatch *pad)
+{
+#if HAVE_LIBWACOM
+	if (pad->libwacom) {
+		libinput_libwacom_unref(pad_libinput_context(pad));
+		pad->libwacom = NULL;
+	}
+#endif
+}
+
+static void
+pad_remove(struct evdev_dispatch *dispatch)
+{
+	struct pad_dispatch *pad = pad_dispatch(dispatch);
+
+	/* see tablet_remove() */
+	pad_libwacom_unref(pad);
+}
+
 static void
 pad_destroy(struct evdev_dispatch *dispatch)
 {
 	struct pad_dispatch *pad = pad_dispatch(dispatch);
 
 	pad_destroy_leds(pad);
+	pad_libwacom_unref(pad);
 	free(pad);
 }
 
 static struct evdev_dispatch_interface pad_interface = {
 	pad_process,
 	pad_suspend, /* suspend */
-	NULL, /* remove */
+	pad_remove, /* remove */
 	pad_destroy,
 	NULL, /* device_added */
 	NULL, /* device_removed */
@@ -568,6 +589,10 @@ pad_init(struct pad_dispatch *pad, struct evdev_device *device)
 	pad->status = PAD_NONE;
 	pad->changed_axes = PAD_AXIS_NONE;
 
+#if HAVE_LIBWACOM
+	pad->libwacom = libinput_libwacom_ref(pad_libinput_context(pad));
+#endif
+
 	pad_init_buttons(pad, device);
 	pad_init_left_handed(device);
 	if (pad_init_leds(pad, device) != 0)
@@ -25,6 +25,10 @@
 
 #include "evdev.h"
 
+#if HAVE_LIBWACOM
+#include <libwacom/libwacom.h>
+#endif
+
 #define LIBINPUT_BUTTONSET_AXIS_NONE 0
 
 enum pad_status {
@@ -68,6 +72,11 @@ struct pad_dispatch {
 	struct {
 		struct list mode_group_list;
 	} modes;
+
+#if HAVE_LIBWACOM
+	/* A reference to the context's database, NULL if unavailable */
+	WacomDeviceDatabase *libwacom;
+#endif
 };
 
 static inline struct pad_dispatch*
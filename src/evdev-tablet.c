@@ -76,50 +76,6 @@ tablet_force_button_presses(struct tablet_dispatch *tablet)
 	}
 }
 
-static inline size_t
-tablet_history_size(const struct tablet_dispatch *tablet)
-{
-	return ARRAY_LENGTH(tablet->history.samples);
-}
-
-static inline void
-tablet_history_reset(struct tablet_dispatch *tablet)
-{
-	tablet->history.count = 0;
-}
-
-static inline void
-tablet_history_push(struct tablet_dispatch *tablet,
-		    const struct tablet_axes *axes)
-{
-	unsigned int index = (tablet->history.index + 1) %
-				tablet_history_size(tablet);
-
-	tablet->history.samples[index] = *axes;
-	tablet->history.index = index;
-	tablet->history.count = min(tablet->history.count + 1,
-				    tablet_history_size(tablet));
-
-	if (tablet->history.count < tablet_history_size(tablet))
-		tablet_history_push(tablet, axes);
-}
-
-/**
- * Return a previous axis state, where index of 0 means "most recent", 1 is
- * "one before most recent", etc.
- */
-static inline const struct tablet_axes*
-tablet_history_get(const struct tablet_dispatch *tablet, unsigned int index)
-{
-	size_t sz = tablet_history_size(tablet);
-
-	assert(index < sz);
-	assert(index < tablet->history.count);
-
-	index = (tablet->history.index + sz - index) % sz;
-	return &tablet->history.samples[index];
-}
-
 static inline void
 tablet_reset_changed_axes(struct tablet_dispatch *tablet)
 {
@@ -162,34 +118,29 @@ tablet_device_has_axis(struct tablet_dispatch *tablet,
 	return has_axis;
 }
 
-static inline bool
-tablet_filter_axis_fuzz(const struct tablet_dispatch *tablet,
-			const struct evdev_device *device,
-			const struct input_event *e,
-			enum libinput_tablet_tool_axis axis)
+/* Filter all axes of the frame in one pass instead of one axis event at
+ * a time */
+static inline void
+tablet_filter_axes_fuzz(struct tablet_dispatch *tablet)
 {
-	int delta, fuzz;
-	int current, previous;
-
-	previous = tablet->prev_value[axis];
-	current = e->value;
-	delta = previous - current;
+	enum libinput_tablet_tool_axis axis;
+	uint32_t changed;
 
-	fuzz = libevdev_get_abs_fuzz(device->evdev, e->code);
+	changed = filter_fuzz_packed(tablet->current_value,
+				     tablet->prev_value,
+				     tablet->axis_fuzz,
+				     ARRAY_LENGTH(tablet->current_value));
+	if (!changed)
+		return;
 
-	/* ABS_DISTANCE doesn't have have fuzz set and causes continuous
-	 * updates for the cursor/lens tools. Add a minimum fuzz of 2, same
-	 * as the xf86-input-wacom driver
-	 */
-	switch (e->code) {
-	case ABS_DISTANCE:
-		fuzz = max(2, fuzz);
-		break;
-	default:
-		break;
+	for (axis = LIBINPUT_TABLET_TOOL_AXIS_X;
+	     axis <= LIBINPUT_TABLET_TOOL_AXIS_MAX;
+	     axis++) {
+		if (changed & (1 << axis))
+			set_bit(tablet->changed_axes, axis);
 	}
 
-	return abs(delta) <= fuzz;
+	tablet_set_status(tablet, TABLET_AXES_UPDATED);
 }
 
 static void
@@ -217,13 +168,7 @@ tablet_process_absolute(struct tablet_dispatch *tablet,
 			break;
 		}
 
-		tablet->prev_value[axis] = tablet->current_value[axis];
-		if (tablet_filter_axis_fuzz(tablet, device, e, axis))
-			break;
-
 		tablet->current_value[axis] = e->value;
-		set_bit(tablet->changed_axes, axis);
-		tablet_set_status(tablet, TABLET_AXES_UPDATED);
 		break;
 	/* tool_id is the identifier for the tool we can use in libwacom
 	 * to identify it (if we have one anyway) */
@@ -311,6 +256,87 @@ normalize_pressure(const struct input_absinfo *absinfo,
 	return value;
 }
 
+static inline double
+bezier_coord(double t, double p1, double p2)
+{
+	double u = 1.0 - t;
+
+	/* the end points are 0 and 1 */
+	return 3 * u * u * t * p1 + 3 * u * t * t * p2 + t * t * t;
+}
+
+/* Sample the curve at every pressure value above the offset, so the
+ * curve costs one table lookup per event. The curve is walked along t
+ * and the y values are interpolated at the evenly spaced x values of
+ * the table, x(t) is monotonic for control points within [0, 1]. */
+static bool
+tool_update_pressure_curve(struct libinput_tablet_tool *tool, int range)
+{
+	const double *p = tool->pressure_curve.points;
+	unsigned int size = min(range, TABLET_PRESSURE_CURVE_MAX_SIZE - 1) + 1;
+	unsigned int steps = size * 4;
+	unsigned int i, step = 0;
+	double x = 0.0, y = 0.0, prev_x = 0.0, prev_y = 0.0;
+	double *lut;
+
+	if (tool->pressure_curve.lut && tool->pressure_curve.lut_range == range)
+		return true;
+
+	lut = zalloc(size * sizeof(*lut));
+	if (!lut)
+		return false;
+
+	for (i = 0; i < size; i++) {
+		double target = (double)i/(size - 1);
+
+		while (x < target && step < steps) {
+			double t;
+
+			prev_x = x;
+			prev_y = y;
+			step++;
+			t = (double)step/steps;
+			x = bezier_coord(t, p[0], p[2]);
+			y = bezier_coord(t, p[1], p[3]);
+		}
+
+		if (x > prev_x)
+			lut[i] = prev_y + (y - prev_y) * (target - prev_x)/(x - prev_x);
+		else
+			lut[i] = y;
+	}
+
+	free(tool->pressure_curve.lut);
+	tool->pressure_curve.lut = lut;
+	tool->pressure_curve.lut_size = size;
+	tool->pressure_curve.lut_range = range;
+
+	return true;
+}
+
+static inline double
+apply_pressure_curve(const struct input_absinfo *absinfo,
+		     struct libinput_tablet_tool *tool)
+{
+	int range = absinfo->maximum - absinfo->minimum;
+	int offset = tool->has_pressure_offset ?
+			tool->pressure_offset : 0;
+	int64_t value = absinfo->value - offset - absinfo->minimum;
+	unsigned int size;
+
+	if (range <= 0 || !tool_update_pressure_curve(tool, range))
+		return normalize_pressure(absinfo, tool);
+
+	size = tool->pressure_curve.lut_size;
+	value = value * (size - 1)/range;
+	if (value < 0)
+		value = 0;
+	else if (value >= size)
+		value = size - 1;
+
+	return tool->pressure_curve.lut[value];
+}
+
 static inline double
 adjust_tilt(const struct input_absinfo *absinfo)
 {
@@ -462,7 +488,10 @@ tablet_update_pressure(struct tablet_dispatch *tablet,
 	if (bit_is_set(tablet->changed_axes,
 		       LIBINPUT_TABLET_TOOL_AXIS_PRESSURE)) {
 		absinfo = libevdev_get_abs_info(device->evdev, ABS_PRESSURE);
-		tablet->axes.pressure = normalize_pressure(absinfo, tool);
+		if (tool->pressure_curve.enabled)
+			tablet->axes.pressure = apply_pressure_curve(absinfo, tool);
+		else
+			tablet->axes.pressure = normalize_pressure(absinfo, tool);
 	}
 }
 
@@ -589,31 +618,6 @@ tablet_update_wheel(struct tablet_dispatch *tablet,
 	}
 }
 
-static void
-tablet_smoothen_axes(const struct tablet_dispatch *tablet,
-		     struct tablet_axes *axes)
-{
-	size_t i;
-	size_t count = tablet_history_size(tablet);
-	struct tablet_axes smooth = { 0 };
-
-	for (i = 0; i < count; i++) {
-		const struct tablet_axes *a = tablet_history_get(tablet, i);
-
-		smooth.point.x += a->point.x;
-		smooth.point.y += a->point.y;
-
-		smooth.tilt.x += a->tilt.x;
-		smooth.tilt.y += a->tilt.y;
-	}
-
-	axes->point.x = smooth.point.x/count;
-	axes->point.y = smooth.point.y/count;
-
-	axes->tilt.x = smooth.tilt.x/count;
-	axes->tilt.y = smooth.tilt.y/count;
-}
-
 static bool
 tablet_check_notify_axes(struct tablet_dispatch *tablet,
 			 struct evdev_device *device,
@@ -652,8 +656,8 @@ tablet_check_notify_axes(struct tablet_dispatch *tablet,
 	rc = true;
 
 out:
-	tablet_history_push(tablet, &tablet->axes);
-	tablet_smoothen_axes(tablet, &axes);
+	tablet_history_push(&tablet->history, &tablet->axes);
+	tablet_history_smoothen(&tablet->history, &axes);
 
 	/* The delta relies on the last *smooth* point, so we do it last */
 	axes.delta = tablet_tool_process_delta(tablet, tool, device, &axes, time);
@@ -848,19 +852,15 @@ tool_set_bits_from_libwacom(const struct tablet_dispatch *tablet,
 	int rc = 1;
 
 #if HAVE_LIBWACOM
-	WacomDeviceDatabase *db;
 	const WacomStylus *s = NULL;
 	int code;
 	WacomStylusType type;
 	WacomAxisTypeFlags axes;
 
-	db = libwacom_database_new();
-	if (!db) {
-		evdev_log_info(tablet->device,
-			       "Failed to initialize libwacom context.\n");
+	if (!tablet->libwacom)
 		goto out;
-	}
-	s = libwacom_stylus_get_for_id(db, tool->tool_id);
+
+	s = libwacom_stylus_get_for_id(tablet->libwacom, tool->tool_id);
 	if (!s)
 		goto out;
 
@@ -907,8 +907,6 @@ tool_set_bits_from_libwacom(const struct tablet_dispatch *tablet,
 
 	rc = 0;
 out:
-	if (db)
-		libwacom_database_destroy(db);
 #endif
 	return rc;
 }
@@ -990,18 +988,12 @@ tablet_get_tool(struct tablet_dispatch *tablet,
 {
 	struct libinput *libinput = tablet_libinput_context(tablet);
 	struct libinput_tablet_tool *tool = NULL, *t;
-	struct list *tool_list;
 
-	if (serial) {
-		tool_list = &libinput->tool_list;
-		/* Check if we already have the tool in our list of tools */
-		list_for_each(t, tool_list, link) {
-			if (type == t->type && serial == t->serial) {
-				tool = t;
-				break;
-			}
-		}
-	}
+	/* Check if we already have the tool in our registry of tools */
+	if (serial)
+		tool = libinput_tablet_tool_registry_find(libinput,
+							  type,
+							  serial);
 
 	/* If we get a tool with a delayed serial number, we already created
 	 * a 0-serial number tool for it earlier. Re-use that, even though
@@ -1009,24 +1001,18 @@ tablet_get_tool(struct tablet_dispatch *tablet,
 	 * https://bugs.freedesktop.org/show_bug.cgi?id=97526
 	 */
 	if (!tool) {
-		tool_list = &tablet->tool_list;
 		/* We can't guarantee that tools without serial numbers are
 		 * unique, so we keep them local to the tablet that they come
 		 * into proximity of instead of storing them in the global tool
-		 * list
+		 * registry
 		 * Same as above, but don't bother checking the serial number
 		 */
-		list_for_each(t, tool_list, link) {
+		list_for_each(t, &tablet->tool_list, link) {
 			if (type == t->type) {
 				tool = t;
 				break;
 			}
 		}
-
-		/* Didn't find the tool but we have a serial. Switch
-		 * tool_list back so we create in the correct list */
-		if (!tool && serial)
-			tool_list = &libinput->tool_list;
 	}
 
 	/* If we didn't already have the new_tool in our list of tools,
@@ -1063,7 +1049,10 @@ tablet_get_tool(struct tablet_dispatch *tablet,
 
 		tool_set_bits(tablet, tool);
 
-		list_insert(tool_list, &tool->link);
+		if (serial)
+			libinput_tablet_tool_registry_add(libinput, tool);
+		else
+			list_insert(&tablet->tool_list, &tool->link);
 	}
 
 	return tool;
@@ -1371,6 +1360,12 @@ tablet_send_proximity_in(struct tablet_dispatch *tablet,
 				LIBINPUT_TABLET_TOOL_PROXIMITY_STATE_IN,
 				tablet->changed_axes,
 				axes);
+
+	/* The tool registry doesn't evict tools we still hold */
+	if (tablet->proximity_tool)
+		libinput_tablet_tool_unref(tablet->proximity_tool);
+	tablet->proximity_tool = libinput_tablet_tool_ref(tool);
+
 	tablet_unset_status(tablet, TABLET_TOOL_ENTERING_PROXIMITY);
 	tablet_unset_status(tablet, TABLET_AXES_UPDATED);
 
@@ -1398,6 +1393,11 @@ tablet_send_proximity_out(struct tablet_dispatch *tablet,
 				tablet->changed_axes,
 				axes);
 
+	if (tablet->proximity_tool) {
+		libinput_tablet_tool_unref(tablet->proximity_tool);
+		tablet->proximity_tool = NULL;
+	}
+
 	tablet_set_status(tablet, TABLET_TOOL_OUT_OF_PROXIMITY);
 	tablet_unset_status(tablet, TABLET_TOOL_LEAVING_PROXIMITY);
 
@@ -1454,6 +1454,95 @@ tablet_send_tip(struct tablet_dispatch *tablet,
 	return false;
 }
 
+static void
+tablet_batch_flush(struct tablet_dispatch *tablet,
+		   struct evdev_device *device)
+{
+	struct libinput_tablet_tool *tool = tablet->batch.tool;
+
+	if (tablet->batch.count == 0)
+		return;
+
+	libinput_timer_cancel(&tablet->batch.timer);
+
+	/* The last sample is the event itself */
+	tablet_notify_axis(&device->base,
+			   tablet->batch.time,
+			   tool,
+			   tablet->batch.tip_state,
+			   tablet->batch.changed_axes,
+			   &tablet->batch.axes,
+			   tablet->batch.samples,
+			   tablet->batch.count - 1);
+
+	tablet->batch.count = 0;
+	tablet->batch.tool = NULL;
+	libinput_tablet_tool_unref(tool);
+}
+
+static void
+tablet_batch_timeout(uint64_t now, void *data)
+{
+	struct tablet_dispatch *tablet = data;
+
+	tablet_batch_flush(tablet, tablet->device);
+}
+
+static void
+tablet_batch_axes(struct tablet_dispatch *tablet,
+		  struct libinput_tablet_tool *tool,
+		  struct evdev_device *device,
+		  enum libinput_tablet_tool_tip_state tip_state,
+		  const struct tablet_axes *axes,
+		  uint64_t time)
+{
+	struct tablet_axes *batched = &tablet->batch.axes;
+	struct tablet_axes_sample *sample;
+	struct normalized_coords delta;
+	double wheel;
+	int wheel_discrete;
+	size_t i;
+
+	if (tablet->batch.count == 0) {
+		tablet->batch.tool = libinput_tablet_tool_ref(tool);
+		tablet->batch.first_time = time;
+		memset(tablet->batch.changed_axes,
+		       0,
+		       sizeof(tablet->batch.changed_axes));
+		memset(batched, 0, sizeof(*batched));
+		libinput_timer_set(&tablet->batch.timer,
+				   time + TABLET_BATCH_WINDOW);
+	}
+
+	sample = &tablet->batch.samples[tablet->batch.count++];
+	sample->time = time;
+	sample->point = axes->point;
+	sample->pressure = axes->pressure;
+	sample->tilt = axes->tilt;
+
+	for (i = 0; i < sizeof(tablet->batch.changed_axes); i++)
+		tablet->batch.changed_axes[i] |= tablet->changed_axes[i];
+
+	/* Relative motion and the wheel must not get lost, everything
+	 * else is absolute and taken from the most recent frame */
+	delta.x = batched->delta.x + axes->delta.x;
+	delta.y = batched->delta.y + axes->delta.y;
+	wheel = batched->wheel + axes->wheel;
+	wheel_discrete = batched->wheel_discrete + axes->wheel_discrete;
+
+	*batched = *axes;
+	batched->delta = delta;
+	batched->wheel = wheel;
+	batched->wheel_discrete = wheel_discrete;
+
+	tablet->batch.tip_state = tip_state;
+	tablet->batch.time = time;
+
+	if (tablet->batch.count == TABLET_BATCH_MAX_SAMPLES ||
+	    time - tablet->batch.first_time >= TABLET_BATCH_WINDOW)
+		tablet_batch_flush(tablet, device);
+}
+
 static inline void
 tablet_send_axes(struct tablet_dispatch *tablet,
 		 struct libinput_tablet_tool *tool,
@@ -1472,12 +1561,17 @@ tablet_send_axes(struct tablet_dispatch *tablet,
 	else
 		tip_state = LIBINPUT_TABLET_TOOL_TIP_UP;
 
-	tablet_notify_axis(&device->base,
-			   time,
-			   tool,
-			   tip_state,
-			   tablet->changed_axes,
-			   axes);
+	if (tablet->batch.enabled)
+		tablet_batch_axes(tablet, tool, device, tip_state, axes, time);
+	else
+		tablet_notify_axis(&device->base,
+				   time,
+				   tool,
+				   tip_state,
+				   tablet->changed_axes,
+				   axes,
+				   NULL,
+				   0);
 	tablet_unset_status(tablet, TABLET_AXES_UPDATED);
 	tablet_reset_changed_axes(tablet);
 	axes->delta.x = 0;
@@ -1517,6 +1611,16 @@ tablet_send_events(struct tablet_dispatch *tablet,
 {
 	struct tablet_axes axes = {0};
 
+	/* Anything but a plain axis update posts the pending batch first,
+	 * so the event order doesn't change */
+	if (tablet_has_status(tablet, TABLET_TOOL_ENTERING_PROXIMITY) ||
+	    tablet_has_status(tablet, TABLET_TOOL_LEAVING_PROXIMITY) ||
+	    tablet_has_status(tablet, TABLET_TOOL_ENTERING_CONTACT) ||
+	    tablet_has_status(tablet, TABLET_TOOL_LEAVING_CONTACT) ||
+	    tablet_has_status(tablet, TABLET_BUTTONS_PRESSED) ||
+	    tablet_has_status(tablet, TABLET_BUTTONS_RELEASED))
+		tablet_batch_flush(tablet, device);
+
 	if (tablet_has_status(tablet, TABLET_TOOL_LEAVING_PROXIMITY)) {
 		/* Tool is leaving proximity, we can't rely on the last axis
 		 * information (it'll be mostly 0), so we just get the
@@ -1545,7 +1649,7 @@ tablet_send_events(struct tablet_dispatch *tablet,
 
 	if (tablet_send_proximity_out(tablet, tool, device, &axes, time)) {
 		tablet_change_to_left_handed(device);
-		tablet_history_reset(tablet);
+		tablet_history_reset(&tablet->history);
 	}
 }
 
@@ -1656,6 +1760,7 @@ tablet_process(struct evdev_dispatch *dispatch,
 		tablet_process_misc(tablet, device, e, time);
 		break;
 	case EV_SYN:
+		tablet_filter_axes_fuzz(tablet);
 		tablet_flush(tablet, device, time);
 		tablet_toggle_touch_device(tablet, device);
 		tablet_reset_state(tablet);
@@ -1675,22 +1780,53 @@ tablet_suspend(struct evdev_dispatch *dispatch,
 {
 	struct tablet_dispatch *tablet = tablet_dispatch(dispatch);
 
+	tablet_batch_flush(tablet, device);
 	tablet_set_touch_device_enabled(tablet->touch_device, true);
 }
 
+static inline void
+tablet_libwacom_unref(struct tablet_dispatch *tablet)
+{
+#if HAVE_LIBWACOM
+	if (tablet->libwacom) {
+		libinput_libwacom_unref(tablet_libinput_context(tablet));
+		tablet->libwacom = NULL;
+	}
+#endif
+}
+
 static void
 tablet_destroy(struct evdev_dispatch *dispatch)
 {
 	struct tablet_dispatch *tablet = tablet_dispatch(dispatch);
 	struct libinput_tablet_tool *tool, *tmp;
 
+	libinput_timer_cancel(&tablet->batch.timer);
+	if (tablet->batch.tool)
+		libinput_tablet_tool_unref(tablet->batch.tool);
+
+	if (tablet->proximity_tool)
+		libinput_tablet_tool_unref(tablet->proximity_tool);
+
 	list_for_each_safe(tool, tmp, &tablet->tool_list, link) {
 		libinput_tablet_tool_unref(tool);
 	}
 
+	tablet_libwacom_unref(tablet);
+
 	free(tablet);
 }
 
+static void
+tablet_remove(struct evdev_dispatch *dispatch)
+{
+	struct tablet_dispatch *tablet = tablet_dispatch(dispatch);
+
+	/* Queued events may keep the dispatch around after the device is
+	 * gone, they must not keep the libwacom database loaded */
+	tablet_libwacom_unref(tablet);
+}
+
 static void
 tablet_device_added(struct evdev_device *device,
 		    struct evdev_device *added_device)
@@ -1760,7 +1896,7 @@ tablet_check_initial_proximity(struct evdev_device *device,
 static struct evdev_dispatch_interface tablet_interface = {
 	tablet_process,
 	tablet_suspend,
-	NULL, /* remove */
+	tablet_remove,
 	tablet_destroy,
 	tablet_device_added,
 	tablet_device_removed,
@@ -1802,6 +1938,85 @@ tablet_init_proximity_threshold(struct tablet_dispatch *tablet,
 	tablet->cursor_proximity_threshold = 42;
 }
 
+static void
+tablet_init_smoothing(struct tablet_dispatch *tablet,
+		      struct evdev_device *device)
+{
+	const char *prop;
+	int window;
+
+	tablet_history_init(&tablet->history, TABLET_HISTORY_LENGTH);
+
+	prop = udev_device_get_property_value(device->udev_device,
+					      "LIBINPUT_ATTR_TABLET_SMOOTHING_WINDOW");
+	if (!prop)
+		return;
+
+	if (!safe_atoi(prop, &window) ||
+	    window < 1 || window > TABLET_HISTORY_MAX_LENGTH) {
+		evdev_log_error(device,
+				"tablet smoothing window '%s' is invalid, expected 1-%d\n",
+				prop,
+				TABLET_HISTORY_MAX_LENGTH);
+		return;
+	}
+
+	tablet_history_init(&tablet->history, window);
+}
+
+static int
+tablet_batching_is_available(struct libinput_device *device)
+{
+	return 1;
+}
+
+static enum libinput_config_status
+tablet_batching_set_enabled(struct libinput_device *device,
+			    enum libinput_config_batching_state enable)
+{
+	struct evdev_device *evdev = evdev_device(device);
+	struct tablet_dispatch *tablet = tablet_dispatch(evdev->dispatch);
+
+	tablet->batch.enabled = (enable == LIBINPUT_CONFIG_BATCHING_ENABLED);
+	if (!tablet->batch.enabled)
+		tablet_batch_flush(tablet, evdev);
+
+	return LIBINPUT_CONFIG_STATUS_SUCCESS;
+}
+
+static enum libinput_config_batching_state
+tablet_batching_get_enabled(struct libinput_device *device)
+{
+	struct evdev_device *evdev = evdev_device(device);
+	struct tablet_dispatch *tablet = tablet_dispatch(evdev->dispatch);
+
+	return tablet->batch.enabled ? LIBINPUT_CONFIG_BATCHING_ENABLED :
+				       LIBINPUT_CONFIG_BATCHING_DISABLED;
+}
+
+static enum libinput_config_batching_state
+tablet_batching_get_default_enabled(struct libinput_device *device)
+{
+	return LIBINPUT_CONFIG_BATCHING_DISABLED;
+}
+
+static void
+tablet_init_batching(struct tablet_dispatch *tablet,
+		     struct evdev_device *device)
+{
+	libinput_timer_init(&tablet->batch.timer,
+			    tablet_libinput_context(tablet),
+			    tablet_batch_timeout,
+			    tablet);
+
+	tablet->batch.enabled = false;
+	tablet->batch.config.is_available = tablet_batching_is_available;
+	tablet->batch.config.set_enabled = tablet_batching_set_enabled;
+	tablet->batch.config.get_enabled = tablet_batching_get_enabled;
+	tablet->batch.config.get_default_enabled = tablet_batching_get_default_enabled;
+	device->base.config.batching = &tablet->batch.config;
+}
+
 static uint32_t
 tablet_accel_config_get_profiles(struct libinput_device *libinput_device)
 {
@@ -1889,6 +2104,35 @@ out:
 	return rc;
 }
 
+static void
+tablet_init_fuzz(struct tablet_dispatch *tablet,
+		 struct evdev_device *device)
+{
+	enum libinput_tablet_tool_axis axis;
+	unsigned int code;
+	int fuzz;
+
+	for (axis = LIBINPUT_TABLET_TOOL_AXIS_X;
+	     axis <= LIBINPUT_TABLET_TOOL_AXIS_MAX;
+	     axis++) {
+		/* relative, never filtered */
+		if (axis == LIBINPUT_TABLET_TOOL_AXIS_REL_WHEEL)
+			continue;
+
+		code = axis_to_evcode(axis);
+		fuzz = libevdev_get_abs_fuzz(device->evdev, code);
+
+		/* ABS_DISTANCE doesn't have have fuzz set and causes
+		 * continuous updates for the cursor/lens tools. Add a
+		 * minimum fuzz of 2, same as the xf86-input-wacom driver
+		 */
+		if (code == ABS_DISTANCE)
+			fuzz = max(2, fuzz);
+
+		tablet->axis_fuzz[axis] = fuzz;
+	}
+}
+
 static int
 tablet_init(struct tablet_dispatch *tablet,
 	    struct evdev_device *device)
@@ -1906,8 +2150,15 @@ tablet_init(struct tablet_dispatch *tablet,
 	if (tablet_reject_device(device))
 		return -1;
 
+#if HAVE_LIBWACOM
+	tablet->libwacom = libinput_libwacom_ref(tablet_libinput_context(tablet));
+#endif
+
 	tablet_init_calibration(tablet, device);
+	tablet_init_fuzz(tablet, device);
 	tablet_init_proximity_threshold(tablet, device);
+	tablet_init_smoothing(tablet, device);
+	tablet_init_batching(tablet, device);
 	rc = tablet_init_accel(tablet, device);
 	if (rc != 0)
 		return rc;
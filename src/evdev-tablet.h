@@ -25,12 +25,22 @@
 #define EVDEV_TABLET_H
 
 #include "evdev.h"
+#include "evdev-tablet-history.h"
+
+#if HAVE_LIBWACOM
+#include <libwacom/libwacom.h>
+#endif
 
 #define LIBINPUT_TABLET_TOOL_AXIS_NONE 0
 #define LIBINPUT_TOOL_NONE 0
 #define LIBINPUT_TABLET_TOOL_TYPE_MAX LIBINPUT_TABLET_TOOL_TYPE_LENS
 
-#define TABLET_HISTORY_LENGTH 4
+/* With batching enabled, axis events are coalesced for at most this long
+ * or this many frames */
+#define TABLET_BATCH_WINDOW ms2us(8)
+#define TABLET_BATCH_MAX_SAMPLES 16
+/* Largest pressure curve lookup table, larger pressure ranges share entries */
+#define TABLET_PRESSURE_CURVE_MAX_SIZE 8192
 
 enum tablet_status {
 	TABLET_NONE = 0,
@@ -57,18 +67,38 @@ struct tablet_dispatch {
 	unsigned char changed_axes[NCHARS(LIBINPUT_TABLET_TOOL_AXIS_MAX + 1)];
 	struct tablet_axes axes; /* for assembling the current state */
 	struct device_coords last_smooth_point;
-	struct {
-		unsigned int index;
-		unsigned int count;
-		struct tablet_axes samples[TABLET_HISTORY_LENGTH];
-	} history;
+	struct tablet_history history;
 
 	unsigned char axis_caps[NCHARS(LIBINPUT_TABLET_TOOL_AXIS_MAX + 1)];
+	/* The axes are fuzz-filtered once per frame, see
+	 * tablet_filter_axes_fuzz(). current_value is the most recent value
+	 * from the kernel, prev_value the last one that passed the fuzz. */
 	int current_value[LIBINPUT_TABLET_TOOL_AXIS_MAX + 1];
 	int prev_value[LIBINPUT_TABLET_TOOL_AXIS_MAX + 1];
+	int axis_fuzz[LIBINPUT_TABLET_TOOL_AXIS_MAX + 1];
 
 	/* Only used for tablets that don't report serial numbers */
 	struct list tool_list;
+	/* The tool in proximity, we hold a reference to it */
+	struct libinput_tablet_tool *proximity_tool;
+
+	struct {
+		bool enabled;
+		struct libinput_device_config_batching config;
+		struct libinput_timer timer;
+
+		unsigned int count;
+		uint64_t first_time;
+		struct tablet_axes_sample samples[TABLET_BATCH_MAX_SAMPLES];
+
+		/* The pending event, the state of the most recent frame
+		 * with the deltas summed up */
+		struct libinput_tablet_tool *tool;
+		enum libinput_tablet_tool_tip_state tip_state;
+		unsigned char changed_axes[NCHARS(LIBINPUT_TABLET_TOOL_AXIS_MAX + 1)];
+		struct tablet_axes axes;
+		uint64_t time;
+	} batch;
 
 	struct button_state button_state;
 	struct button_state prev_button_state;
@@ -83,6 +113,11 @@ struct tablet_dispatch {
 
 	/* The paired touch device on devices with both pen & touch */
 	struct evdev_device *touch_device;
+
+#if HAVE_LIBWACOM
+	/* A reference to the context's database, NULL if unavailable */
+	WacomDeviceDatabase *libwacom;
+#endif
 };
 
 static inline struct tablet_dispatch*
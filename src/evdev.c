@@ -568,6 +568,67 @@ fallback_flush_extra_aux_data(struct fallback_dispatch *dispatch,
 	}
 }
 
+static void
+fallback_flush_coalesced_motion(struct fallback_dispatch *dispatch,
+				struct evdev_device *device)
+{
+	struct normalized_coords accel = dispatch->coalesce.accel;
+	struct device_float_coords raw = dispatch->coalesce.raw;
+
+	if (dispatch->coalesce.count == 0)
+		return;
+
+	libinput_timer_cancel(&dispatch->coalesce.timer);
+
+	dispatch->coalesce.count = 0;
+	dispatch->coalesce.accel.x = 0.0;
+	dispatch->coalesce.accel.y = 0.0;
+	dispatch->coalesce.raw.x = 0.0;
+	dispatch->coalesce.raw.y = 0.0;
+
+	pointer_notify_motion(&device->base,
+			      dispatch->coalesce.last_time,
+			      &accel,
+			      &raw);
+}
+
+static void
+fallback_coalesce_timeout(uint64_t now, void *data)
+{
+	struct evdev_device *device = data;
+	struct fallback_dispatch *dispatch =
+		fallback_dispatch(device->dispatch);
+
+	fallback_flush_coalesced_motion(dispatch, device);
+}
+
+static inline void
+fallback_coalesce_relative_motion(struct fallback_dispatch *dispatch,
+				  struct evdev_device *device,
+				  uint64_t time,
+				  const struct normalized_coords *accel,
+				  const struct device_float_coords *raw)
+{
+	if (dispatch->coalesce.count == 0) {
+		dispatch->coalesce.first_time = time;
+		libinput_timer_set(&dispatch->coalesce.timer,
+				   time + dispatch->coalesce.window);
+	}
+
+	/* The sums are kept in floating point, whatever subpixel motion
+	 * the filter returns is carried over into the posted event */
+	dispatch->coalesce.accel.x += accel->x;
+	dispatch->coalesce.accel.y += accel->y;
+	dispatch->coalesce.raw.x += raw->x;
+	dispatch->coalesce.raw.y += raw->y;
+	dispatch->coalesce.last_time = time;
+	dispatch->coalesce.count++;
+
+	if (time - dispatch->coalesce.first_time >= dispatch->coalesce.window ||
+	    dispatch->coalesce.count == dispatch->coalesce.max_count)
+		fallback_flush_coalesced_motion(dispatch, device);
+}
+
 static void
 fallback_flush_relative_motion(struct fallback_dispatch *dispatch,
 			       struct evdev_device *device,
@@ -607,6 +668,15 @@ fallback_flush_relative_motion(struct fallback_dispatch *dispatch,
 	if (normalized_is_zero(accel) && normalized_is_zero(unaccel))
 		return;
 
+	if (dispatch->coalesce.enabled) {
+		fallback_coalesce_relative_motion(dispatch,
+						  device,
+						  time,
+						  &accel,
+						  &raw);
+		return;
+	}
+
 	pointer_notify_motion(base, time, &accel, &raw);
 }
 
@@ -627,6 +697,43 @@ fallback_flush_absolute_motion(struct fallback_dispatch *dispatch,
 	pointer_notify_motion_absolute(base, time, &point);
 }
 
+static inline void
+fallback_predictor_push(struct motion_predictor *predictor,
+			const struct device_coords *point,
+			uint64_t time)
+{
+	struct device_float_coords p = {
+		.x = point->x,
+		.y = point->y,
+	};
+
+	motion_predictor_push(predictor, &p, time);
+}
+
+static bool
+fallback_touch_is_palm(struct fallback_dispatch *dispatch,
+		       struct evdev_device *device,
+		       const struct mt_slot *slot)
+{
+	double angle, major;
+
+	if (dispatch->palm.pressure_threshold > 0 &&
+	    slot->pressure >= dispatch->palm.pressure_threshold)
+		return true;
+
+	if (dispatch->palm.size_threshold > 0) {
+		angle = evdev_device_transform_orientation(device,
+							   slot->area.orientation);
+		major = evdev_device_transform_ellipse_diameter_to_mm(device,
+								      slot->area.major,
+								      angle);
+		if (major >= dispatch->palm.size_threshold)
+			return true;
+	}
+
+	return false;
+}
+
 static bool
 fallback_flush_mt_down(struct fallback_dispatch *dispatch,
 		       struct evdev_device *device,
@@ -649,6 +756,11 @@ fallback_flush_mt_down(struct fallback_dispatch *dispatch,
 		return false;
 	}
 
+	/* Palms never get a seat slot, everything up to and including
+	 * the touch up is dropped */
+	if (fallback_touch_is_palm(dispatch, device, slot))
+		return false;
+
 	seat_slot = ffs(~seat->slot_map) - 1;
 	slot->seat_slot = seat_slot;
 
@@ -660,6 +772,9 @@ fallback_flush_mt_down(struct fallback_dispatch *dispatch,
 	slot->hysteresis_center = point;
 	evdev_transform_absolute(device, &point);
 
+	motion_predictor_reset(&slot->predictor);
+	fallback_predictor_push(&slot->predictor, &point, time);
+
 	fallback_flush_extra_aux_data(dispatch, device, time, dispatch->pending_event, slot_idx, seat_slot);
 	touch_notify_touch_down(base, time, slot_idx, seat_slot,
 				&point, &slot->area, slot->pressure);
@@ -668,13 +783,13 @@ fallback_flush_mt_down(struct fallback_dispatch *dispatch,
 }
 
 static bool
-fallback_flush_mt_motion(struct fallback_dispatch *dispatch,
-			 struct evdev_device *device,
-			 int slot_idx,
-			 uint64_t time)
+fallback_flush_mt_up(struct fallback_dispatch *dispatch,
+		     struct evdev_device *device,
+		     int slot_idx,
+		     uint64_t time)
 {
 	struct libinput_device *base = &device->base;
-	struct device_coords point;
+	struct libinput_seat *seat = base->seat;
 	struct mt_slot *slot;
 	int seat_slot;
 
@@ -683,31 +798,28 @@ fallback_flush_mt_motion(struct fallback_dispatch *dispatch,
 
 	slot = &dispatch->mt.slots[slot_idx];
 	seat_slot = slot->seat_slot;
-	point = slot->point;
+	slot->seat_slot = -1;
 
 	if (seat_slot == -1)
 		return false;
 
-	if (fallback_filter_defuzz_touch(dispatch, device, slot))
-		return false;
-
-	evdev_transform_absolute(device, &point);
+	seat->slot_map &= ~(1 << seat_slot);
 
 	fallback_flush_extra_aux_data(dispatch, device, time, dispatch->pending_event, slot_idx, seat_slot);
-	touch_notify_touch_motion(base, time, slot_idx, seat_slot,
-				  &point, &slot->area, slot->pressure);
+	touch_notify_touch_up(base, time, slot_idx, seat_slot);
 
 	return true;
 }
 
 static bool
-fallback_flush_mt_up(struct fallback_dispatch *dispatch,
-		     struct evdev_device *device,
-		     int slot_idx,
-		     uint64_t time)
+fallback_flush_mt_motion(struct fallback_dispatch *dispatch,
+			 struct evdev_device *device,
+			 int slot_idx,
+			 uint64_t time)
 {
 	struct libinput_device *base = &device->base;
-	struct libinput_seat *seat = base->seat;
+	struct device_coords point;
+	struct device_float_coords velocity;
 	struct mt_slot *slot;
 	int seat_slot;
 
@@ -716,15 +828,31 @@ fallback_flush_mt_up(struct fallback_dispatch *dispatch,
 
 	slot = &dispatch->mt.slots[slot_idx];
 	seat_slot = slot->seat_slot;
-	slot->seat_slot = -1;
+	point = slot->point;
 
 	if (seat_slot == -1)
 		return false;
 
-	seat->slot_map &= ~(1 << seat_slot);
+	/* A finger turning into a palm ends the touch for the caller, the
+	 * slot has no seat slot until the next touch down so the rest is
+	 * dropped */
+	if (fallback_touch_is_palm(dispatch, device, slot)) {
+		fallback_flush_mt_up(dispatch, device, slot_idx, time);
+		return true;
+	}
+
+	if (fallback_filter_defuzz_touch(dispatch, device, slot))
+		return false;
+
+	evdev_transform_absolute(device, &point);
+
+	fallback_predictor_push(&slot->predictor, &point, time);
+	velocity = motion_predictor_velocity(&slot->predictor);
 
 	fallback_flush_extra_aux_data(dispatch, device, time, dispatch->pending_event, slot_idx, seat_slot);
-	touch_notify_touch_up(base, time, slot_idx, seat_slot);
+	touch_notify_touch_motion(base, time, slot_idx, seat_slot,
+				  &point, &slot->area, slot->pressure,
+				  &velocity);
 
 	return true;
 }
@@ -764,6 +892,9 @@ fallback_flush_st_down(struct fallback_dispatch *dispatch,
 	point = dispatch->abs.point;
 	evdev_transform_absolute(device, &point);
 
+	motion_predictor_reset(&dispatch->abs.predictor);
+	fallback_predictor_push(&dispatch->abs.predictor, &point, time);
+
 	touch_notify_touch_down(base, time, -1, seat_slot, &point, &default_touch, DEFAULT_TOUCH_PRESSURE);
 
 	return true;
@@ -776,6 +907,7 @@ fallback_flush_st_motion(struct fallback_dispatch *dispatch,
 {
 	struct libinput_device *base = &device->base;
 	struct device_coords point;
+	struct device_float_coords velocity;
 	int seat_slot;
 	struct ellipse default_touch = {
 		.major = DEFAULT_TOUCH_MAJOR,
@@ -791,7 +923,10 @@ fallback_flush_st_motion(struct fallback_dispatch *dispatch,
 	if (seat_slot == -1)
 		return false;
 
-	touch_notify_touch_motion(base, time, -1, seat_slot, &point, &default_touch, DEFAULT_TOUCH_PRESSURE);
+	fallback_predictor_push(&dispatch->abs.predictor, &point, time);
+	velocity = motion_predictor_velocity(&dispatch->abs.predictor);
+
+	touch_notify_touch_motion(base, time, -1, seat_slot, &point, &default_touch, DEFAULT_TOUCH_PRESSURE, &velocity);
 
 	return true;
 }
@@ -966,6 +1101,7 @@ fallback_process_key(struct fallback_dispatch *dispatch,
 	}
 
 	fallback_flush_pending_event(dispatch, device, time);
+	fallback_flush_coalesced_motion(dispatch, device);
 
 	type = get_key_type(e->code);
 
@@ -1188,6 +1324,7 @@ fallback_process_relative(struct fallback_dispatch *dispatch,
 		break;
 	case REL_WHEEL:
 		fallback_flush_pending_event(dispatch, device, time);
+		fallback_flush_coalesced_motion(dispatch, device);
 		wheel_degrees.y = -1 * e->value *
 					device->scroll.wheel_click_angle.x;
 		discrete.y = -1 * e->value;
@@ -1206,6 +1343,7 @@ fallback_process_relative(struct fallback_dispatch *dispatch,
 		break;
 	case REL_HWHEEL:
 		fallback_flush_pending_event(dispatch, device, time);
+		fallback_flush_coalesced_motion(dispatch, device);
 		wheel_degrees.x = e->value *
 					device->scroll.wheel_click_angle.y;
 		discrete.x = e->value;
@@ -1454,6 +1592,7 @@ fallback_return_to_neutral_state(struct fallback_dispatch *dispatch,
 	if ((time = libinput_now(libinput)) == 0)
 		return;
 
+	fallback_flush_coalesced_motion(dispatch, device);
 	release_touches(dispatch, device, time);
 	release_pressed_keys(dispatch, device, time);
 	memset(dispatch->hw_key_mask, 0, sizeof(dispatch->hw_key_mask));
@@ -1503,6 +1642,8 @@ fallback_destroy(struct evdev_dispatch *evdev_dispatch)
 	}
 	free(dispatch->mt.aux_data_list);
 
+	libinput_timer_cancel(&dispatch->coalesce.timer);
+
 	free(dispatch->mt.slots);
 	free(dispatch);
 }
@@ -2032,6 +2173,97 @@ fallback_dispatch_init_rel(struct fallback_dispatch *dispatch,
 	dispatch->rel.y = 0;
 }
 
+static inline void
+fallback_dispatch_init_coalesce(struct fallback_dispatch *dispatch,
+				struct evdev_device *device)
+{
+	struct libinput *libinput = evdev_libinput_context(device);
+	const char *prop;
+	unsigned int window_ms, count;
+
+	libinput_timer_init(&dispatch->coalesce.timer,
+			    libinput,
+			    fallback_coalesce_timeout,
+			    device);
+
+	if (!(device->seat_caps & EVDEV_DEVICE_POINTER))
+		return;
+
+	prop = udev_device_get_property_value(device->udev_device,
+					      "LIBINPUT_ATTR_MOTION_COALESCE");
+	if (!prop)
+		return;
+
+	if (!parse_motion_coalesce_property(prop, &window_ms, &count)) {
+		evdev_log_error(device,
+				"motion coalescing property is present but invalid\n");
+		return;
+	}
+
+	dispatch->coalesce.enabled = true;
+	dispatch->coalesce.window = ms2us(window_ms);
+	dispatch->coalesce.max_count = count;
+
+	evdev_log_info(device,
+		       "coalescing relative motion over %ums/%u events\n",
+		       window_ms,
+		       count);
+}
+
+static inline int
+fallback_palm_threshold(struct evdev_device *device,
+			const char *property,
+			unsigned int required_code)
+{
+	const char *prop;
+	int threshold;
+
+	prop = udev_device_get_property_value(device->udev_device, property);
+	if (!prop)
+		return 0;
+
+	if (!safe_atoi(prop, &threshold) || threshold <= 0) {
+		evdev_log_error(device, "%s is present but invalid\n", property);
+		return 0;
+	}
+
+	if (!libevdev_has_event_code(device->evdev, EV_ABS, required_code)) {
+		evdev_log_info(device,
+			       "%s is set but the device has no %s, ignoring\n",
+			       property,
+			       libevdev_event_code_get_name(EV_ABS, required_code));
+		return 0;
+	}
+
+	return threshold;
+}
+
+static inline void
+fallback_dispatch_init_palm(struct fallback_dispatch *dispatch,
+			    struct evdev_device *device)
+{
+	if (!dispatch->mt.slots ||
+	    !(device->seat_caps & EVDEV_DEVICE_TOUCH))
+		return;
+
+	dispatch->palm.size_threshold =
+		fallback_palm_threshold(device,
+					"LIBINPUT_ATTR_PALM_SIZE_THRESHOLD",
+					ABS_MT_TOUCH_MAJOR);
+	/* Without a real resolution the size in mm is meaningless */
+	if (dispatch->palm.size_threshold > 0 &&
+	    device->abs.is_fake_resolution) {
+		evdev_log_info(device,
+			       "%s is set but the device has no resolution, ignoring\n",
+			       "LIBINPUT_ATTR_PALM_SIZE_THRESHOLD");
+		dispatch->palm.size_threshold = 0;
+	}
+	dispatch->palm.pressure_threshold =
+		fallback_palm_threshold(device,
+					"LIBINPUT_ATTR_PALM_PRESSURE_THRESHOLD",
+					ABS_MT_PRESSURE);
+}
+
 static inline void
 fallback_dispatch_init_abs(struct fallback_dispatch *dispatch,
 			   struct evdev_device *device)
@@ -2067,10 +2299,12 @@ fallback_dispatch_create(struct libinput_device *libinput_device)
 
 	fallback_dispatch_init_rel(dispatch, device);
 	fallback_dispatch_init_abs(dispatch, device);
+	fallback_dispatch_init_coalesce(dispatch, device);
 	if (fallback_dispatch_init_slots(dispatch, device) == -1) {
 		free(dispatch);
 		return NULL;
 	}
+	fallback_dispatch_init_palm(dispatch, device);
 
 	if (device->left_handed.want_enabled)
 		evdev_init_left_handed(device,
@@ -2798,16 +3032,14 @@ evdev_extract_abs_axes(struct evdev_device *device)
 }
 
 static struct evdev_dispatch *
-evdev_configure_device(struct evdev_device *device)
+evdev_configure_device(struct evdev_device *device,
+		       enum evdev_device_udev_tags udev_tags)
 {
 	struct libevdev *evdev = device->evdev;
-	enum evdev_device_udev_tags udev_tags;
 	unsigned int tablet_tags;
 	struct evdev_dispatch *dispatch;
 	char *env;
 
-	udev_tags = evdev_device_get_udev_tags(device, device->udev_device);
-
 	if ((udev_tags & EVDEV_UDEV_TAG_INPUT) == 0 ||
 	    (udev_tags & ~EVDEV_UDEV_TAG_INPUT) == 0) {
 		evdev_log_info(device,
@@ -3144,6 +3376,43 @@ libevdev_log_func(const struct libevdev *evdev,
 	log_msg_va(libinput, pri, fmt, args);
 }
 
+/* Everything but the fd and the udev device */
+static void
+evdev_device_init(struct evdev_device *device)
+{
+	struct libinput *libinput = evdev_libinput_context(device);
+
+	libevdev_set_clock_id(device->evdev, CLOCK_MONOTONIC);
+	libevdev_set_device_log_function(device->evdev,
+					 libevdev_log_func,
+					 LIBEVDEV_LOG_ERROR,
+					 libinput);
+	device->seat_caps = 0;
+	device->is_mt = 0;
+	device->mtdev = NULL;
+	device->dispatch = NULL;
+	device->devname = libevdev_get_name(device->evdev);
+	device->scroll.threshold = 5.0; /* Default may be overridden */
+	device->scroll.direction_lock_threshold = 5.0; /* Default may be overridden */
+	device->scroll.direction = 0;
+	device->scroll.wheel_click_angle =
+		evdev_read_wheel_click_props(device);
+	device->scroll.is_tilt = evdev_read_wheel_tilt_props(device);
+	device->model_flags = evdev_read_model_flags(device);
+	device->dpi = DEFAULT_MOUSE_DPI;
+
+	/* at most 5 SYN_DROPPED log-messages per 30s */
+	ratelimit_init(&device->syn_drop_limit, s2us(30), 5);
+	/* at most 5 log-messages per 5s */
+	ratelimit_init(&device->nonpointer_rel_limit, s2us(5), 5);
+
+	matrix_init_identity(&device->abs.calibration);
+	matrix_init_identity(&device->abs.usermatrix);
+	matrix_init_identity(&device->abs.default_calibration);
+
+	evdev_pre_configure_model_quirks(device);
+}
+
 struct evdev_device *
 evdev_device_create(struct libinput_seat *seat,
 		    struct udev_device *udev_device)
@@ -3204,39 +3473,13 @@ evdev_device_create(struct libinput_seat *seat,
 	if (rc != 0)
 		goto err;
 
-	libevdev_set_clock_id(device->evdev, CLOCK_MONOTONIC);
-	libevdev_set_device_log_function(device->evdev,
-					 libevdev_log_func,
-					 LIBEVDEV_LOG_ERROR,
-					 libinput);
-	device->seat_caps = 0;
-	device->is_mt = 0;
-	device->mtdev = NULL;
 	device->udev_device = udev_device_ref(udev_device);
-	device->dispatch = NULL;
 	device->fd = fd;
-	device->devname = libevdev_get_name(device->evdev);
-	device->scroll.threshold = 5.0; /* Default may be overridden */
-	device->scroll.direction_lock_threshold = 5.0; /* Default may be overridden */
-	device->scroll.direction = 0;
-	device->scroll.wheel_click_angle =
-		evdev_read_wheel_click_props(device);
-	device->scroll.is_tilt = evdev_read_wheel_tilt_props(device);
-	device->model_flags = evdev_read_model_flags(device);
-	device->dpi = DEFAULT_MOUSE_DPI;
-
-	/* at most 5 SYN_DROPPED log-messages per 30s */
-	ratelimit_init(&device->syn_drop_limit, s2us(30), 5);
-	/* at most 5 log-messages per 5s */
-	ratelimit_init(&device->nonpointer_rel_limit, s2us(5), 5);
-
-	matrix_init_identity(&device->abs.calibration);
-	matrix_init_identity(&device->abs.usermatrix);
-	matrix_init_identity(&device->abs.default_calibration);
-
-	evdev_pre_configure_model_quirks(device);
+	evdev_device_init(device);
 
-	device->dispatch = evdev_configure_device(device);
+	device->dispatch = evdev_configure_device(device,
+						  evdev_device_get_udev_tags(device,
+									     udev_device));
 	if (device->dispatch == NULL) {
 		if (device->seat_caps == 0)
 			unhandled_device = 1;
@@ -3266,6 +3509,65 @@ err:
 	return unhandled_device ? EVDEV_UNHANDLED_DEVICE :  NULL;
 }
 
+struct evdev_device *
+evdev_device_create_touchpad(struct libinput_seat *seat,
+			     struct libevdev *evdev)
+{
+	struct evdev_device *device;
+
+	device = zalloc(sizeof *device);
+	if (device == NULL) {
+		libevdev_free(evdev);
+		return NULL;
+	}
+
+	libinput_device_init(&device->base, seat);
+	libinput_seat_ref(seat);
+
+	device->evdev = evdev;
+	device->udev_device = NULL;
+	device->fd = -1;
+	evdev_device_init(device);
+
+	device->dispatch = evdev_configure_device(device,
+						  EVDEV_UDEV_TAG_INPUT |
+						  EVDEV_UDEV_TAG_TOUCHPAD);
+	if (device->dispatch == NULL) {
+		evdev_device_destroy(device);
+		return NULL;
+	}
+
+	list_insert(seat->devices_list.prev, &device->base.link);
+
+	evdev_notify_added_device(device);
+
+	return device;
+}
+
+struct evdev_device *
+evdev_device_create_virtual(struct libinput_seat *seat,
+			    const char *name,
+			    enum evdev_device_seat_capability seat_caps)
+{
+	struct evdev_device *device;
+
+	device = zalloc(sizeof *device);
+	if (device == NULL)
+		return NULL;
+
+	/* Only what the notify functions look at */
+	libinput_device_init(&device->base, seat);
+	libinput_seat_ref(seat);
+
+	device->devname = name;
+	device->fd = -1;
+	device->seat_caps = seat_caps;
+
+	list_insert(seat->devices_list.prev, &device->base.link);
+
+	return device;
+}
+
 const char *
 evdev_device_get_output(struct evdev_device *device)
 {
@@ -3275,6 +3577,10 @@ evdev_device_get_output(struct evdev_device *device)
 const char *
 evdev_device_get_sysname(struct evdev_device *device)
 {
+	/* see evdev_device_create_touchpad() */
+	if (!device->udev_device)
+		return "virtual";
+
 	return udev_device_get_sysname(device->udev_device);
 }
 
@@ -3403,30 +3709,6 @@ evdev_read_calibration_prop(struct evdev_device *device)
 		       calibration[5]);
 }
 
-bool
-evdev_device_has_capability(struct evdev_device *device,
-			    enum libinput_device_capability capability)
-{
-	switch (capability) {
-	case LIBINPUT_DEVICE_CAP_POINTER:
-		return !!(device->seat_caps & EVDEV_DEVICE_POINTER);
-	case LIBINPUT_DEVICE_CAP_KEYBOARD:
-		return !!(device->seat_caps & EVDEV_DEVICE_KEYBOARD);
-	case LIBINPUT_DEVICE_CAP_TOUCH:
-		return !!(device->seat_caps & EVDEV_DEVICE_TOUCH);
-	case LIBINPUT_DEVICE_CAP_GESTURE:
-		return !!(device->seat_caps & EVDEV_DEVICE_GESTURE);
-	case LIBINPUT_DEVICE_CAP_TABLET_TOOL:
-		return !!(device->seat_caps & EVDEV_DEVICE_TABLET);
-	case LIBINPUT_DEVICE_CAP_TABLET_PAD:
-		return !!(device->seat_caps & EVDEV_DEVICE_TABLET_PAD);
-	case LIBINPUT_DEVICE_CAP_SWITCH:
-		return !!(device->seat_caps & EVDEV_DEVICE_SWITCH);
-	default:
-		return false;
-	}
-}
-
 int
 evdev_device_get_size(const struct evdev_device *device,
 		      double *width,
@@ -3768,17 +4050,15 @@ evdev_tablet_has_left_handed(struct evdev_device *device)
 {
 	bool has_left_handed = false;
 #if HAVE_LIBWACOM
+	struct libinput *libinput = evdev_libinput_context(device);
 	WacomDeviceDatabase *db;
 	WacomDevice *d = NULL;
 	WacomError *error;
 	const char *devnode;
 
-	db = libwacom_database_new();
-	if (!db) {
-		evdev_log_info(device,
-			       "failed to initialize libwacom context.\n");
+	db = libinput_libwacom_ref(libinput);
+	if (!db)
 		goto out;
-	}
 
 	error = libwacom_error_new();
 	devnode = udev_device_get_devnode(device->udev_device);
@@ -3805,7 +4085,7 @@ evdev_tablet_has_left_handed(struct evdev_device *device)
 		libwacom_error_free(&error);
 	if (d)
 		libwacom_destroy(d);
-	libwacom_database_destroy(db);
+	libinput_libwacom_unref(libinput);
 
 out:
 #endif
@@ -141,6 +141,7 @@ struct mt_slot {
 	struct device_coords hysteresis_center;
 	struct ellipse area;
 	int32_t pressure;
+	struct motion_predictor predictor;
 };
 
 struct mt_aux_data {
@@ -224,6 +225,10 @@ struct evdev_device {
 	struct {
 		struct libinput_device_config_accel config;
 		struct motion_filter *filter;
+
+		/* Sum of all accelerated deltas, fed to the predictor */
+		struct device_float_coords position;
+		struct motion_predictor predictor;
 	} pointer;
 
 	/* Key counter used for multiplexing button events internally in
@@ -262,6 +267,32 @@ evdev_device(struct libinput_device *device)
 
 #define EVDEV_UNHANDLED_DEVICE ((struct evdev_device *) 1)
 
+/* Inline so the notify functions can check their capability with a
+ * single test of the seat_caps set up by evdev_configure_device() */
+static inline bool
+evdev_device_has_capability(struct evdev_device *device,
+			    enum libinput_device_capability capability)
+{
+	switch (capability) {
+	case LIBINPUT_DEVICE_CAP_POINTER:
+		return !!(device->seat_caps & EVDEV_DEVICE_POINTER);
+	case LIBINPUT_DEVICE_CAP_KEYBOARD:
+		return !!(device->seat_caps & EVDEV_DEVICE_KEYBOARD);
+	case LIBINPUT_DEVICE_CAP_TOUCH:
+		return !!(device->seat_caps & EVDEV_DEVICE_TOUCH);
+	case LIBINPUT_DEVICE_CAP_GESTURE:
+		return !!(device->seat_caps & EVDEV_DEVICE_GESTURE);
+	case LIBINPUT_DEVICE_CAP_TABLET_TOOL:
+		return !!(device->seat_caps & EVDEV_DEVICE_TABLET);
+	case LIBINPUT_DEVICE_CAP_TABLET_PAD:
+		return !!(device->seat_caps & EVDEV_DEVICE_TABLET_PAD);
+	case LIBINPUT_DEVICE_CAP_SWITCH:
+		return !!(device->seat_caps & EVDEV_DEVICE_SWITCH);
+	default:
+		return false;
+	}
+}
+
 struct evdev_dispatch;
 
 struct evdev_dispatch_interface {
@@ -348,6 +379,7 @@ struct fallback_dispatch {
 	struct {
 		struct device_coords point;
 		int32_t seat_slot;
+		struct motion_predictor predictor;
 
 		struct {
 			struct device_coords min, max;
@@ -364,8 +396,32 @@ struct fallback_dispatch {
 		struct list *aux_data_list;
 	} mt;
 
+	/* A touch exceeding either threshold on down or during motion is a
+	 * palm and ignored until it lifts, 0 disables the threshold. See
+	 * LIBINPUT_ATTR_PALM_SIZE_THRESHOLD and
+	 * LIBINPUT_ATTR_PALM_PRESSURE_THRESHOLD */
+	struct {
+		int size_threshold;	/* touch major in mm */
+		int pressure_threshold;
+	} palm;
+
 	struct device_coords rel;
 
+	/* Relative motion is accelerated for every report but posted at
+	 * most once per window or count, see LIBINPUT_ATTR_MOTION_COALESCE */
+	struct {
+		bool enabled;
+		uint64_t window;	/* in us */
+		unsigned int max_count;	/* 0 for no limit */
+
+		unsigned int count;
+		uint64_t first_time;
+		uint64_t last_time;
+		struct normalized_coords accel;
+		struct device_float_coords raw;
+		struct libinput_timer timer;
+	} coalesce;
+
 	/* Bitmask of pressed keys used to ignore initial release events from
 	 * the kernel. */
 	unsigned long hw_key_mask[NLONGS(KEY_CNT)];
@@ -389,6 +445,24 @@ struct evdev_device *
 evdev_device_create(struct libinput_seat *seat,
 		    struct udev_device *device);
 
+/* Creates a touchpad from a libevdev context the caller set up, e.g. from
+ * a recorded device description. There is no device node and no udev
+ * device, so property-based quirks use their defaults. The device takes
+ * ownership of evdev, events are passed to the dispatch by the caller. */
+struct evdev_device *
+evdev_device_create_touchpad(struct libinput_seat *seat,
+			     struct libevdev *evdev);
+
+/* Creates a device without a kernel device, libevdev context or
+ * dispatch, for posting events through the notify functions directly.
+ * The device is not announced to the other devices, the caller
+ * removes it from the seat and unrefs it, evdev_device_remove() must not
+ * be used. name must outlive the device. */
+struct evdev_device *
+evdev_device_create_virtual(struct libinput_seat *seat,
+			    const char *name,
+			    enum evdev_device_seat_capability seat_caps);
+
 void
 evdev_transform_absolute(struct evdev_device *device,
 			 struct device_coords *point);
@@ -458,10 +532,6 @@ void
 evdev_device_calibrate(struct evdev_device *device,
 		       const float calibration[6]);
 
-bool
-evdev_device_has_capability(struct evdev_device *device,
-			    enum libinput_device_capability capability);
-
 int
 evdev_device_get_size(const struct evdev_device *device,
 		      double *w,
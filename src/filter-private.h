@@ -34,6 +34,12 @@ struct motion_filter_interface {
 			   struct motion_filter *filter,
 			   const struct device_float_coords *unaccelerated,
 			   void *data, uint64_t time);
+	void (*filter_batch)(struct motion_filter *filter,
+			     const struct device_float_coords *unaccelerated,
+			     void *data,
+			     const uint64_t *times,
+			     struct normalized_coords *accelerated,
+			     size_t nevents);
 	struct normalized_coords (*filter_constant)(
 			   struct motion_filter *filter,
 			   const struct device_float_coords *unaccelerated,
@@ -44,6 +50,8 @@ struct motion_filter_interface {
 	void (*destroy)(struct motion_filter *filter);
 	bool (*set_speed)(struct motion_filter *filter,
 			  double speed_adjustment);
+	bool (*set_velocity_estimator)(struct motion_filter *filter,
+				       enum velocity_estimator estimator);
 };
 
 struct motion_filter {
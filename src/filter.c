@@ -31,6 +31,7 @@
 #include <stdint.h>
 #include <limits.h>
 #include <math.h>
+#include <string.h>
 
 #include "filter.h"
 #include "libinput-util.h"
@@ -81,6 +82,33 @@ filter_dispatch(struct motion_filter *filter,
 	return filter->interface->filter(filter, unaccelerated, data, time);
 }
 
+void
+filter_dispatch_batch(struct motion_filter *filter,
+		      const struct device_float_coords *unaccelerated,
+		      void *data,
+		      const uint64_t *times,
+		      struct normalized_coords *accelerated,
+		      size_t nevents)
+{
+	size_t i;
+
+	if (filter->interface->filter_batch) {
+		filter->interface->filter_batch(filter,
+						unaccelerated,
+						data,
+						times,
+						accelerated,
+						nevents);
+		return;
+	}
+
+	for (i = 0; i < nevents; i++)
+		accelerated[i] = filter->interface->filter(filter,
+							   &unaccelerated[i],
+							   data,
+							   times[i]);
+}
+
 struct normalized_coords
 filter_dispatch_constant(struct motion_filter *filter,
 			 const struct device_float_coords *unaccelerated,
@@ -125,6 +153,16 @@ filter_get_type(struct motion_filter *filter)
 	return filter->interface->type;
 }
 
+bool
+filter_set_velocity_estimator(struct motion_filter *filter,
+			      enum velocity_estimator estimator)
+{
+	if (!filter->interface->set_velocity_estimator)
+		return false;
+
+	return filter->interface->set_velocity_estimator(filter, estimator);
+}
+
 /*
  * Default parameters for pointer acceleration profiles.
  */
@@ -161,6 +199,32 @@ struct pointer_tracker {
 	uint32_t dir;
 };
 
+/* Rebase the velocity ring's prefix sums once they get this large, to
+ * avoid losing precision on long continuous movements */
+#define VELOCITY_RING_REBASE_LIMIT 1e6
+
+struct velocity_ring_entry {
+	struct device_float_coords sum; /* sum of all deltas up to this one */
+	uint64_t time;  /* us */
+	uint32_t dir;
+};
+
+/* Incremental velocity estimator. Equivalent to the pointer trackers but
+ * stores prefix sums of the deltas instead of per-tracker deltas, so the
+ * motion since any tracker is the difference of two entries. The window
+ * of events used for the velocity only ever shrinks from its oldest end,
+ * every event is added and dropped exactly once.
+ */
+struct velocity_ring {
+	struct velocity_ring_entry entries[NUM_POINTER_TRACKERS];
+	unsigned int newest;	/* index of the most recent event */
+	unsigned int nentries;	/* entries in the window, incl. newest */
+
+	/* per direction bit, the number of window entries with that bit
+	 * set. A bit is common to all entries if its count is nentries */
+	unsigned int dir_count[8];
+};
+
 struct pointer_accelerator {
 	struct motion_filter base;
 
@@ -169,8 +233,10 @@ struct pointer_accelerator {
 	double velocity;	/* units/us */
 	double last_velocity;	/* units/us */
 
+	enum velocity_estimator estimator;
 	struct pointer_tracker *trackers;
 	int cur_tracker;
+	struct velocity_ring ring;
 
 	double threshold;	/* units/us */
 	double accel;		/* unitless factor */
@@ -313,6 +379,219 @@ calculate_velocity(struct pointer_accelerator *accel, uint64_t time)
 	return result; /* units/us */
 }
 
+static inline struct velocity_ring_entry *
+velocity_ring_by_offset(struct velocity_ring *ring, unsigned int offset)
+{
+	unsigned int index =
+		(ring->newest + NUM_POINTER_TRACKERS - offset)
+		% NUM_POINTER_TRACKERS;
+	return &ring->entries[index];
+}
+
+static inline void
+velocity_ring_count_dir(struct velocity_ring *ring, uint32_t dir, int change)
+{
+	unsigned int bit;
+
+	for (bit = 0; bit < ARRAY_LENGTH(ring->dir_count); bit++) {
+		if (dir & (1 << bit))
+			ring->dir_count[bit] += change;
+	}
+}
+
+static inline uint32_t
+velocity_ring_common_dir(struct velocity_ring *ring)
+{
+	uint32_t dir = 0;
+	unsigned int bit;
+
+	for (bit = 0; bit < ARRAY_LENGTH(ring->dir_count); bit++) {
+		if (ring->dir_count[bit] == ring->nentries)
+			dir |= (1 << bit);
+	}
+
+	return dir;
+}
+
+static inline void
+velocity_ring_drop_oldest(struct velocity_ring *ring)
+{
+	struct velocity_ring_entry *oldest;
+
+	assert(ring->nentries > 1);
+
+	oldest = velocity_ring_by_offset(ring, ring->nentries - 1);
+	velocity_ring_count_dir(ring, oldest->dir, -1);
+	ring->nentries--;
+}
+
+static void
+velocity_ring_reset(struct velocity_ring *ring, uint64_t time, uint32_t dir)
+{
+	struct velocity_ring_entry *newest;
+
+	newest = velocity_ring_by_offset(ring, 0);
+	newest->sum.x = 0.0;
+	newest->sum.y = 0.0;
+	newest->time = time;
+	newest->dir = dir;
+
+	ring->nentries = 1;
+	memset(ring->dir_count, 0, sizeof(ring->dir_count));
+	velocity_ring_count_dir(ring, dir, 1);
+}
+
+static void
+velocity_ring_rebase(struct velocity_ring *ring)
+{
+	struct device_float_coords base;
+	struct velocity_ring_entry *entry;
+	unsigned int offset;
+
+	base = velocity_ring_by_offset(ring, ring->nentries - 1)->sum;
+	for (offset = 0; offset < ring->nentries; offset++) {
+		entry = velocity_ring_by_offset(ring, offset);
+		entry->sum.x -= base.x;
+		entry->sum.y -= base.y;
+	}
+}
+
+static void
+velocity_ring_push(struct velocity_ring *ring,
+		   const struct device_float_coords *delta,
+		   uint64_t time)
+{
+	struct velocity_ring_entry *prev, *entry;
+
+	if (ring->nentries == NUM_POINTER_TRACKERS)
+		velocity_ring_drop_oldest(ring);
+
+	prev = velocity_ring_by_offset(ring, 0);
+	ring->newest = (ring->newest + 1) % NUM_POINTER_TRACKERS;
+	entry = velocity_ring_by_offset(ring, 0);
+
+	entry->sum.x = prev->sum.x + delta->x;
+	entry->sum.y = prev->sum.y + delta->y;
+	entry->time = time;
+	entry->dir = device_float_get_direction(*delta);
+
+	ring->nentries++;
+	velocity_ring_count_dir(ring, entry->dir, 1);
+
+	if (fabs(entry->sum.x) > VELOCITY_RING_REBASE_LIMIT ||
+	    fabs(entry->sum.y) > VELOCITY_RING_REBASE_LIMIT)
+		velocity_ring_rebase(ring);
+}
+
+static inline double
+velocity_ring_velocity(struct velocity_ring *ring,
+		       unsigned int offset,
+		       uint64_t time)
+{
+	struct velocity_ring_entry *newest, *entry;
+	double tdelta;
+
+	newest = velocity_ring_by_offset(ring, 0);
+	entry = velocity_ring_by_offset(ring, offset);
+	tdelta = time - entry->time + 1;
+
+	return hypot(newest->sum.x - entry->sum.x,
+		     newest->sum.y - entry->sum.y) / tdelta; /* units/us */
+}
+
+/**
+ * Add the delta to the velocity ring and calculate the velocity. This
+ * uses the same direction and timeout rules as calculate_velocity() but
+ * only ever looks at the most recent and the oldest entry in the window.
+ *
+ * The velocity difference is checked between the most recent and the
+ * oldest entry only, calculate_velocity() checks every entry in between.
+ */
+static double
+velocity_ring_feed(struct velocity_ring *ring,
+		   const struct device_float_coords *delta,
+		   uint64_t time)
+{
+	struct velocity_ring_entry *newest, *entry;
+	double velocity, initial_velocity;
+
+	velocity_ring_push(ring, delta, time);
+
+	newest = velocity_ring_by_offset(ring, 0);
+	entry = velocity_ring_by_offset(ring, 1);
+
+	/* Bug: time running backwards */
+	if (entry->time > time) {
+		while (ring->nentries > 1)
+			velocity_ring_drop_oldest(ring);
+		return 0.0;
+	}
+
+	/* First movement after timeout, see
+	 * calculate_velocity_after_timeout() */
+	if (time - entry->time > MOTION_TIMEOUT) {
+		velocity = hypot(delta->x, delta->y) / (MOTION_TIMEOUT + 1);
+		while (ring->nentries > 1)
+			velocity_ring_drop_oldest(ring);
+		return velocity;
+	}
+
+	initial_velocity = velocity_ring_velocity(ring, 1, time);
+
+	/* First movement after dirchange - velocity is that of the last
+	 * movement */
+	if ((entry->dir & newest->dir) == 0) {
+		while (ring->nentries > 1)
+			velocity_ring_drop_oldest(ring);
+		return initial_velocity;
+	}
+
+	/* Drop entries too far away in time or in a different direction */
+	while (ring->nentries > 2) {
+		entry = velocity_ring_by_offset(ring, ring->nentries - 1);
+		if (entry->time <= time &&
+		    time - entry->time <= MOTION_TIMEOUT &&
+		    velocity_ring_common_dir(ring) != 0)
+			break;
+
+		velocity_ring_drop_oldest(ring);
+	}
+
+	velocity = velocity_ring_velocity(ring, ring->nentries - 1, time);
+
+	/* Velocity differs too much from initial, only the most recent
+	 * movement counts */
+	if (fabs(initial_velocity - velocity) > MAX_VELOCITY_DIFF) {
+		while (ring->nentries > 2)
+			velocity_ring_drop_oldest(ring);
+		velocity = initial_velocity;
+	}
+
+	return velocity; /* units/us */
+}
+
+/**
+ * Feed the delta into the velocity estimator of the filter and calculate
+ * the current velocity.
+ *
+ * @param accel The acceleration filter
+ * @param delta The delta of the current event
+ * @param time Current time in µs
+ *
+ * @return The velocity in units/µs
+ */
+static inline double
+accelerator_velocity(struct pointer_accelerator *accel,
+		     const struct device_float_coords *delta,
+		     uint64_t time)
+{
+	if (accel->estimator == VELOCITY_ESTIMATOR_INCREMENTAL)
+		return velocity_ring_feed(&accel->ring, delta, time);
+
+	feed_trackers(accel, delta, time);
+	return calculate_velocity(accel, time);
+}
+
 /**
  * Apply the acceleration profile to the given velocity.
  *
@@ -384,8 +663,7 @@ calculate_acceleration_factor(struct pointer_accelerator *accel,
 	double velocity; /* units/us in device-native dpi*/
 	double accel_factor;
 
-	feed_trackers(accel, unaccelerated, time);
-	velocity = calculate_velocity(accel, time);
+	velocity = accelerator_velocity(accel, unaccelerated, time);
 	accel_factor = calculate_acceleration(accel,
 					      data,
 					      velocity,
@@ -471,6 +749,45 @@ accelerator_filter_pre_normalized(struct motion_filter *filter,
 	return normalized;
 }
 
+static void
+accelerator_filter_pre_normalized_batch(struct motion_filter *filter,
+					const struct device_float_coords *unaccelerated,
+					void *data,
+					const uint64_t *times,
+					struct normalized_coords *accelerated,
+					size_t nevents)
+{
+	struct pointer_accelerator *accel =
+		(struct pointer_accelerator *) filter;
+	const int dpi = accel->dpi;
+	struct device_float_coords converted;
+	double accel_value; /* unitless factor */
+	size_t i;
+
+	/* Same as accelerator_filter_pre_normalized() but split into
+	 * passes: the normalization has no dependencies between events and
+	 * is vectorized by the compiler, only the velocity calculation is
+	 * sequential. Keep the expressions identical to the single-event
+	 * path so the results are bit-for-bit the same.
+	 */
+	for (i = 0; i < nevents; i++) {
+		accelerated[i].x = unaccelerated[i].x * DEFAULT_MOUSE_DPI/dpi;
+		accelerated[i].y = unaccelerated[i].y * DEFAULT_MOUSE_DPI/dpi;
+	}
+
+	for (i = 0; i < nevents; i++) {
+		converted.x = accelerated[i].x;
+		converted.y = accelerated[i].y;
+
+		accel_value = calculate_acceleration_factor(accel,
+							    &converted,
+							    data,
+							    times[i]);
+		accelerated[i].x = accel_value * converted.x;
+		accelerated[i].y = accel_value * converted.y;
+	}
+}
+
 static struct normalized_coords
 accelerator_filter_unnormalized(struct motion_filter *filter,
 				const struct device_float_coords *unaccelerated,
@@ -536,8 +853,7 @@ accelerator_filter_x230(struct motion_filter *filter,
 	delta_normalized.x = unaccelerated.x;
 	delta_normalized.y = unaccelerated.y;
 
-	feed_trackers(accel, &delta_normalized, time);
-	velocity = calculate_velocity(accel, time);
+	velocity = accelerator_velocity(accel, &delta_normalized, time);
 	accel_factor = calculate_acceleration(accel,
 					      data,
 					      velocity,
@@ -617,6 +933,11 @@ accelerator_restart(struct motion_filter *filter,
 	unsigned int offset;
 	struct pointer_tracker *tracker;
 
+	if (accel->estimator == VELOCITY_ESTIMATOR_INCREMENTAL) {
+		velocity_ring_reset(&accel->ring, time, UNDEFINED_DIRECTION);
+		return;
+	}
+
 	for (offset = 1; offset < NUM_POINTER_TRACKERS; offset++) {
 		tracker = tracker_by_offset(accel, offset);
 		tracker->time = 0;
@@ -640,6 +961,36 @@ accelerator_destroy(struct motion_filter *filter)
 	free(accel);
 }
 
+static bool
+accelerator_set_velocity_estimator(struct motion_filter *filter,
+				   enum velocity_estimator estimator)
+{
+	struct pointer_accelerator *accel =
+		(struct pointer_accelerator *) filter;
+	uint64_t time;
+
+	switch (estimator) {
+	case VELOCITY_ESTIMATOR_TRACKERS:
+	case VELOCITY_ESTIMATOR_INCREMENTAL:
+		break;
+	default:
+		return false;
+	}
+
+	if (accel->estimator == estimator)
+		return true;
+
+	if (accel->estimator == VELOCITY_ESTIMATOR_INCREMENTAL)
+		time = velocity_ring_by_offset(&accel->ring, 0)->time;
+	else
+		time = tracker_by_offset(accel, 0)->time;
+
+	accel->estimator = estimator;
+	accelerator_restart(filter, NULL, time);
+
+	return true;
+}
+
 static bool
 accelerator_set_speed(struct motion_filter *filter,
 		      double speed_adjustment)
@@ -939,10 +1290,12 @@ trackpoint_accel_profile(struct motion_filter *filter,
 struct motion_filter_interface accelerator_interface = {
 	.type = LIBINPUT_CONFIG_ACCEL_PROFILE_ADAPTIVE,
 	.filter = accelerator_filter_pre_normalized,
+	.filter_batch = accelerator_filter_pre_normalized_batch,
 	.filter_constant = accelerator_filter_noop,
 	.restart = accelerator_restart,
 	.destroy = accelerator_destroy,
 	.set_speed = accelerator_set_speed,
+	.set_velocity_estimator = accelerator_set_velocity_estimator,
 };
 
 static struct pointer_accelerator *
@@ -956,9 +1309,11 @@ create_default_filter(int dpi)
 
 	filter->last_velocity = 0.0;
 
+	filter->estimator = VELOCITY_ESTIMATOR_TRACKERS;
 	filter->trackers =
 		calloc(NUM_POINTER_TRACKERS, sizeof *filter->trackers);
 	filter->cur_tracker = 0;
+	velocity_ring_reset(&filter->ring, 0, 0);
 
 	filter->threshold = DEFAULT_THRESHOLD;
 	filter->accel = DEFAULT_ACCELERATION;
@@ -986,10 +1341,12 @@ create_pointer_accelerator_filter_linear(int dpi)
 struct motion_filter_interface accelerator_interface_low_dpi = {
 	.type = LIBINPUT_CONFIG_ACCEL_PROFILE_ADAPTIVE,
 	.filter = accelerator_filter_unnormalized,
+	.filter_batch = NULL,
 	.filter_constant = accelerator_filter_noop,
 	.restart = accelerator_restart,
 	.destroy = accelerator_destroy,
 	.set_speed = accelerator_set_speed,
+	.set_velocity_estimator = accelerator_set_velocity_estimator,
 };
 
 struct motion_filter *
@@ -1010,10 +1367,12 @@ create_pointer_accelerator_filter_linear_low_dpi(int dpi)
 struct motion_filter_interface accelerator_interface_touchpad = {
 	.type = LIBINPUT_CONFIG_ACCEL_PROFILE_ADAPTIVE,
 	.filter = accelerator_filter_post_normalized,
+	.filter_batch = NULL,
 	.filter_constant = touchpad_constant_filter,
 	.restart = accelerator_restart,
 	.destroy = accelerator_destroy,
 	.set_speed = touchpad_accelerator_set_speed,
+	.set_velocity_estimator = accelerator_set_velocity_estimator,
 };
 
 struct motion_filter *
@@ -1034,10 +1393,12 @@ create_pointer_accelerator_filter_touchpad(int dpi)
 struct motion_filter_interface accelerator_interface_x230 = {
 	.type = LIBINPUT_CONFIG_ACCEL_PROFILE_ADAPTIVE,
 	.filter = accelerator_filter_x230,
+	.filter_batch = NULL,
 	.filter_constant = accelerator_filter_constant_x230,
 	.restart = accelerator_restart,
 	.destroy = accelerator_destroy,
 	.set_speed = accelerator_set_speed,
+	.set_velocity_estimator = accelerator_set_velocity_estimator,
 };
 
 /* The Lenovo x230 has a bad touchpad. This accel method has been
@@ -1057,9 +1418,11 @@ create_pointer_accelerator_filter_lenovo_x230(int dpi)
 	filter->profile = touchpad_lenovo_x230_accel_profile;
 	filter->last_velocity = 0.0;
 
+	filter->estimator = VELOCITY_ESTIMATOR_TRACKERS;
 	filter->trackers =
 		calloc(NUM_POINTER_TRACKERS, sizeof *filter->trackers);
 	filter->cur_tracker = 0;
+	velocity_ring_reset(&filter->ring, 0, 0);
 
 	filter->threshold = X230_THRESHOLD;
 	filter->accel = X230_ACCELERATION; /* unitless factor */
@@ -1072,10 +1435,12 @@ create_pointer_accelerator_filter_lenovo_x230(int dpi)
 struct motion_filter_interface accelerator_interface_trackpoint = {
 	.type = LIBINPUT_CONFIG_ACCEL_PROFILE_ADAPTIVE,
 	.filter = accelerator_filter_unnormalized,
+	.filter_batch = NULL,
 	.filter_constant = accelerator_filter_noop,
 	.restart = accelerator_restart,
 	.destroy = accelerator_destroy,
 	.set_speed = accelerator_set_speed,
+	.set_velocity_estimator = accelerator_set_velocity_estimator,
 };
 
 struct motion_filter *
@@ -1116,6 +1481,27 @@ accelerator_filter_flat(struct motion_filter *filter,
 	return accelerated;
 }
 
+static void
+accelerator_filter_flat_batch(struct motion_filter *filter,
+			      const struct device_float_coords *unaccelerated,
+			      void *data,
+			      const uint64_t *times,
+			      struct normalized_coords *accelerated,
+			      size_t nevents)
+{
+	struct pointer_accelerator_flat *accel_filter =
+		(struct pointer_accelerator_flat *)filter;
+	const double factor = accel_filter->factor; /* unitless factor */
+	size_t i;
+
+	/* No state between events, this loop is vectorized by the
+	 * compiler */
+	for (i = 0; i < nevents; i++) {
+		accelerated[i].x = factor * unaccelerated[i].x;
+		accelerated[i].y = factor * unaccelerated[i].y;
+	}
+}
+
 static bool
 accelerator_set_speed_flat(struct motion_filter *filter,
 			   double speed_adjustment)
@@ -1148,10 +1534,12 @@ accelerator_destroy_flat(struct motion_filter *filter)
 struct motion_filter_interface accelerator_interface_flat = {
 	.type = LIBINPUT_CONFIG_ACCEL_PROFILE_FLAT,
 	.filter = accelerator_filter_flat,
+	.filter_batch = accelerator_filter_flat_batch,
 	.filter_constant = accelerator_filter_noop,
 	.restart = NULL,
 	.destroy = accelerator_destroy_flat,
 	.set_speed = accelerator_set_speed_flat,
+	.set_velocity_estimator = NULL,
 };
 
 struct motion_filter *
@@ -1272,10 +1660,12 @@ tablet_accelerator_destroy(struct motion_filter *filter)
 struct motion_filter_interface accelerator_interface_tablet = {
 	.type = LIBINPUT_CONFIG_ACCEL_PROFILE_FLAT,
 	.filter = tablet_accelerator_filter_flat,
+	.filter_batch = NULL,
 	.filter_constant = NULL,
 	.restart = NULL,
 	.destroy = tablet_accelerator_destroy,
 	.set_speed = tablet_accelerator_set_speed,
+	.set_velocity_estimator = NULL,
 };
 
 static struct tablet_accelerator_flat *
@@ -1309,3 +1699,165 @@ create_pointer_accelerator_filter_tablet(int xres, int yres)
 
 	return &filter->base;
 }
+
+void
+motion_predictor_reset(struct motion_predictor *predictor)
+{
+	predictor->newest = 0;
+	predictor->nsamples = 0;
+}
+
+void
+motion_predictor_push(struct motion_predictor *predictor,
+		      const struct device_float_coords *point,
+		      uint64_t time)
+{
+	unsigned int newest = predictor->newest;
+	bool replace = false;
+
+	if (predictor->nsamples > 0) {
+		uint64_t last = predictor->samples[newest].time;
+
+		/* Time going backwards or a long pause, start afresh */
+		if (time < last || time - last > MOTION_PREDICTOR_TIMEOUT)
+			predictor->nsamples = 0;
+		else if (time == last)
+			replace = true;
+		else
+			newest = (newest + 1) % MOTION_PREDICTOR_HISTORY;
+	}
+
+	predictor->samples[newest].point = *point;
+	predictor->samples[newest].time = time;
+	predictor->newest = newest;
+
+	if (!replace && predictor->nsamples < MOTION_PREDICTOR_HISTORY)
+		predictor->nsamples++;
+}
+
+struct device_float_coords
+motion_predictor_velocity(const struct motion_predictor *predictor)
+{
+	struct device_float_coords velocity = { 0.0, 0.0 };
+	struct device_float_coords lo, hi;
+	uint64_t now, span = 0;
+	double mean_t = 0.0, mean_x = 0.0, mean_y = 0.0;
+	double var_t = 0.0, cov_x = 0.0, cov_y = 0.0;
+	double speed, max_speed;
+	unsigned int i, n = 0;
+
+	if (predictor->nsamples < 2)
+		return velocity;
+
+	now = predictor->samples[predictor->newest].time;
+	lo = predictor->samples[predictor->newest].point;
+	hi = lo;
+
+	/* Timestamps relative to the newest sample so the fit doesn't
+	 * lose precision on large absolute times */
+	for (i = 0; i < predictor->nsamples; i++) {
+		unsigned int idx = (predictor->newest + MOTION_PREDICTOR_HISTORY - i) %
+				   MOTION_PREDICTOR_HISTORY;
+
+		const struct device_float_coords *p;
+
+		if (now - predictor->samples[idx].time > MOTION_PREDICTOR_TIMEOUT)
+			break;
+
+		p = &predictor->samples[idx].point;
+		span = now - predictor->samples[idx].time;
+		mean_t -= span;
+		mean_x += p->x;
+		mean_y += p->y;
+		lo.x = min(lo.x, p->x);
+		lo.y = min(lo.y, p->y);
+		hi.x = max(hi.x, p->x);
+		hi.y = max(hi.y, p->y);
+		n++;
+	}
+
+	if (n < 2 || span < MOTION_PREDICTOR_MIN_SPAN)
+		return velocity;
+
+	mean_t /= n;
+	mean_x /= n;
+	mean_y /= n;
+
+	for (i = 0; i < n; i++) {
+		unsigned int idx = (predictor->newest + MOTION_PREDICTOR_HISTORY - i) %
+				   MOTION_PREDICTOR_HISTORY;
+		double dt = -(double)(now - predictor->samples[idx].time) - mean_t;
+
+		var_t += dt * dt;
+		cov_x += dt * (predictor->samples[idx].point.x - mean_x);
+		cov_y += dt * (predictor->samples[idx].point.y - mean_y);
+	}
+
+	if (var_t == 0.0)
+		return velocity;
+
+	velocity.x = cov_x/var_t;
+	velocity.y = cov_y/var_t;
+
+	max_speed = hypot(hi.x - lo.x, hi.y - lo.y)/span;
+	speed = hypot(velocity.x, velocity.y);
+	if (speed > max_speed) {
+		velocity.x *= max_speed/speed;
+		velocity.y *= max_speed/speed;
+	}
+
+	return velocity;
+}
+
+void
+one_euro_reset(struct one_euro_state *state)
+{
+	state->initialized = false;
+}
+
+static inline double
+one_euro_alpha(double dt, double cutoff)
+{
+	double tau = 1.0/(2 * M_PI * cutoff);
+
+	return 1.0/(1.0 + tau/dt);
+}
+
+struct device_float_coords
+one_euro_filter(const struct one_euro_params *params,
+		struct one_euro_state *state,
+		const struct device_float_coords *point,
+		uint64_t time)
+{
+	struct device_float_coords velocity;
+	double dt, alpha, speed;
+
+	if (!state->initialized || time < state->time) {
+		state->value = *point;
+		state->velocity.x = 0.0;
+		state->velocity.y = 0.0;
+		state->time = time;
+		state->initialized = true;
+		return *point;
+	}
+
+	/* Same timestamp, nothing to base a speed on */
+	if (time == state->time)
+		return state->value;
+
+	dt = (time - state->time)/1000000.0; /* s */
+	state->time = time;
+
+	velocity.x = (point->x - state->value.x)/dt;
+	velocity.y = (point->y - state->value.y)/dt;
+	alpha = one_euro_alpha(dt, params->dcutoff);
+	state->velocity.x += alpha * (velocity.x - state->velocity.x);
+	state->velocity.y += alpha * (velocity.y - state->velocity.y);
+
+	speed = hypot(state->velocity.x, state->velocity.y);
+	alpha = one_euro_alpha(dt, params->min_cutoff + params->beta * speed);
+	state->value.x += alpha * (point->x - state->value.x);
+	state->value.y += alpha * (point->y - state->value.y);
+
+	return state->value;
+}
@@ -61,6 +61,30 @@ filter_dispatch(struct motion_filter *filter,
 		const struct device_float_coords *unaccelerated,
 		void *data, uint64_t time);
 
+/**
+ * Accelerate a sequence of deltas. The result is identical to calling
+ * filter_dispatch() for each delta in order, but filters may process the
+ * whole array at once.
+ *
+ * @param filter The device's motion filter
+ * @param unaccelerated An array of nevents unaccelerated deltas, see
+ * filter_dispatch()
+ * @param data Custom data
+ * @param times An array of nevents timestamps, one for each delta
+ * @param accelerated An array of nevents coordinates to store the
+ * accelerated deltas in
+ * @param nevents The number of deltas
+ *
+ * @see filter_dispatch
+ */
+void
+filter_dispatch_batch(struct motion_filter *filter,
+		      const struct device_float_coords *unaccelerated,
+		      void *data,
+		      const uint64_t *times,
+		      struct normalized_coords *accelerated,
+		      size_t nevents);
+
 /**
  * Apply constant motion filters, but no acceleration.
  *
@@ -98,6 +122,32 @@ filter_get_speed(struct motion_filter *filter);
 enum libinput_config_accel_profile
 filter_get_type(struct motion_filter *filter);
 
+/**
+ * The method used by the adaptive filters to calculate the pointer
+ * velocity.
+ */
+enum velocity_estimator {
+	/** Walk the tracker history on every event, the default */
+	VELOCITY_ESTIMATOR_TRACKERS,
+	/** Keep running sums of the history, O(1) per event */
+	VELOCITY_ESTIMATOR_INCREMENTAL,
+};
+
+/**
+ * Switch the velocity estimator of the filter. The velocity history is
+ * discarded, the next event is handled like the first motion after a
+ * restart.
+ *
+ * @param filter The device's motion filter
+ * @param estimator The velocity estimator to use
+ *
+ * @return false if the filter does not calculate a velocity, true
+ * otherwise
+ */
+bool
+filter_set_velocity_estimator(struct motion_filter *filter,
+			      enum velocity_estimator estimator);
+
 typedef double (*accel_profile_func_t)(struct motion_filter *filter,
 				       void *data,
 				       double velocity,
@@ -125,6 +175,96 @@ create_pointer_accelerator_filter_trackpoint(int dpi);
 struct motion_filter *
 create_pointer_accelerator_filter_tablet(int xres, int yres);
 
+/*
+ * Motion prediction.
+ */
+
+#define MOTION_PREDICTOR_HISTORY 4
+/* Samples older than this are not used for prediction */
+#define MOTION_PREDICTOR_TIMEOUT ms2us(50)
+/* Longest interval we extrapolate over */
+#define MOTION_PREDICTOR_MAX_INTERVAL ms2us(50)
+/* Shortest history we fit a line to, one frame at 1000Hz. Samples
+ * closer together than this say nothing about the velocity. */
+#define MOTION_PREDICTOR_MIN_SPAN ms2us(1)
+
+/* Estimates the current velocity from a least-squares line fit over the
+ * most recent positions. The unit of the positions is up to the caller,
+ * the velocity is in that unit per microsecond. */
+struct motion_predictor {
+	struct {
+		struct device_float_coords point;
+		uint64_t time;
+	} samples[MOTION_PREDICTOR_HISTORY];
+	unsigned int newest;
+	unsigned int nsamples;
+};
+
+/**
+ * Discard all history, e.g. on touch down.
+ */
+void
+motion_predictor_reset(struct motion_predictor *predictor);
+
+/**
+ * Add a position to the history. A position with the same timestamp as
+ * the most recent one replaces it, history older than
+ * MOTION_PREDICTOR_TIMEOUT is discarded.
+ */
+void
+motion_predictor_push(struct motion_predictor *predictor,
+		      const struct device_float_coords *point,
+		      uint64_t time);
+
+/**
+ * The velocity is never faster than the distance between the extremes of
+ * the history over its time span, so a noisy fit can't predict further
+ * than the history actually moved.
+ *
+ * @return The estimated velocity in units per microsecond, or 0 if the
+ * history has fewer than two samples or spans less than
+ * MOTION_PREDICTOR_MIN_SPAN
+ */
+struct device_float_coords
+motion_predictor_velocity(const struct motion_predictor *predictor);
+
+/*
+ * One-euro filter, see Casiez et al., "1€ Filter: A Simple Speed-based
+ * Low-pass Filter for Noisy Input in Interactive Systems", CHI 2012.
+ * A low-pass filter whose cutoff frequency rises with the speed, so slow
+ * motion is smoothed and fast motion has little lag. It only needs the
+ * previous output, so unlike a history-based filter it reacts to the
+ * first sample of a motion.
+ */
+
+struct one_euro_params {
+	double min_cutoff;	/* Hz, cutoff at zero speed */
+	double beta;		/* Hz per unit/s of speed */
+	double dcutoff;		/* Hz, cutoff for the speed estimate */
+};
+
+struct one_euro_state {
+	struct device_float_coords value;
+	struct device_float_coords velocity; /* units/s */
+	uint64_t time;
+	bool initialized;
+};
+
+/**
+ * Discard the filter state, the next point is passed through unchanged.
+ */
+void
+one_euro_reset(struct one_euro_state *state);
+
+/**
+ * @return The filtered point, in the same unit as point
+ */
+struct device_float_coords
+one_euro_filter(const struct one_euro_params *params,
+		struct one_euro_state *state,
+		const struct device_float_coords *point,
+		uint64_t time);
+
 /*
  * Pointer acceleration profiles.
  */
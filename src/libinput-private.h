@@ -57,6 +57,12 @@
 #define TRACE_INPUT_END()
 #endif
 
+/* Buckets of the tablet tool hash */
+#define TABLET_TOOL_HASH_BITS 6
+#define TABLET_TOOL_HASH_SIZE (1 << TABLET_TOOL_HASH_BITS)
+/* Tools only the registry references are evicted beyond this count */
+#define TABLET_TOOL_REGISTRY_MAX 32
+
 struct libinput_source;
 
 /* A coordinate pair in device coordinates */
@@ -137,6 +143,9 @@ struct libinput {
 		struct list list;
 		struct libinput_source *source;
 		int fd;
+		/* Non-zero once the timers run on the time passed to
+		 * libinput_timer_advance() instead of the timerfd */
+		uint64_t virtual_now;
 	} timer;
 
 	struct libinput_event **events;
@@ -145,7 +154,30 @@ struct libinput {
 	size_t events_in;
 	size_t events_out;
 
-	struct list tool_list;
+	/* Tools with a serial number, shared by all tablets. The registry
+	 * holds one reference to each tool, see
+	 * libinput_tablet_tool_registry_add() */
+	struct {
+		struct list lru; /* most recently used first */
+		struct list buckets[TABLET_TOOL_HASH_SIZE];
+		unsigned int count;
+
+		struct {
+			uint64_t lookups;
+			uint64_t compares; /* tools compared during lookups */
+			uint64_t evictions;
+		} stats;
+	} tools;
+
+#if HAVE_LIBWACOM
+	/* Shared by all tablets and pads, see libinput_libwacom_ref().
+	 * The libwacom header is left to the tablet code, this header is
+	 * used by targets built without the libwacom flags. */
+	struct {
+		struct _WacomDeviceDatabase *db;
+		unsigned int refcount;
+	} libwacom;
+#endif
 
 	const struct libinput_interface *interface;
 	const struct libinput_interface_backend *interface_backend;
@@ -290,6 +322,33 @@ struct libinput_device_config_dwt {
 			 struct libinput_device *device);
 };
 
+struct libinput_device_config_low_latency {
+	int (*is_available)(struct libinput_device *device);
+	enum libinput_config_status (*set_enabled)(
+			 struct libinput_device *device,
+			 enum libinput_config_low_latency_state enable);
+	enum libinput_config_low_latency_state (*get_enabled)(
+			 struct libinput_device *device);
+	enum libinput_config_low_latency_state (*get_default_enabled)(
+			 struct libinput_device *device);
+	enum libinput_config_status (*set_smoothing)(
+			 struct libinput_device *device,
+			 double smoothing);
+	double (*get_smoothing)(struct libinput_device *device);
+	double (*get_default_smoothing)(struct libinput_device *device);
+};
+
+struct libinput_device_config_batching {
+	int (*is_available)(struct libinput_device *device);
+	enum libinput_config_status (*set_enabled)(
+			 struct libinput_device *device,
+			 enum libinput_config_batching_state enable);
+	enum libinput_config_batching_state (*get_enabled)(
+			 struct libinput_device *device);
+	enum libinput_config_batching_state (*get_default_enabled)(
+			 struct libinput_device *device);
+};
+
 struct libinput_device_config_rotation {
 	int (*is_available)(struct libinput_device *device);
 	enum libinput_config_status (*set_angle)(
@@ -310,6 +369,8 @@ struct libinput_device_config {
 	struct libinput_device_config_click_method *click_method;
 	struct libinput_device_config_middle_emulation *middle_emulation;
 	struct libinput_device_config_dwt *dwt;
+	struct libinput_device_config_low_latency *low_latency;
+	struct libinput_device_config_batching *batching;
 	struct libinput_device_config_rotation *rotation;
 };
 
@@ -326,6 +387,7 @@ struct libinput_device {
 	struct libinput_device_group *group;
 	struct list link;
 	struct list event_listeners;
+	uint64_t event_listener_mask; /* union of the listeners' masks */
 	void *user_data;
 	int refcount;
 	struct libinput_device_config config;
@@ -357,8 +419,18 @@ struct tablet_axes {
 	int wheel_discrete;
 };
 
+/* One of the intermediate frames coalesced into a batched tablet tool
+ * axis event */
+struct tablet_axes_sample {
+	uint64_t time;
+	struct device_coords point;
+	double pressure;
+	struct tilt_degrees tilt;
+};
+
 struct libinput_tablet_tool {
-	struct list link;
+	struct list link; /* the registry's LRU list or the tablet's list */
+	struct list hash_link; /* only for tools in the registry */
 	uint32_t serial;
 	uint32_t tool_id;
 	enum libinput_tablet_tool_type type;
@@ -371,6 +443,18 @@ struct libinput_tablet_tool {
 	struct threshold pressure_threshold;
 	int pressure_offset; /* in device coordinates */
 	bool has_pressure_offset;
+
+	/* A cubic Bezier from (0, 0) to (1, 1), see
+	 * libinput_tablet_tool_config_pressure_curve_set(). The lookup
+	 * table is built for the pressure range of the tablet the tool
+	 * was last used on. */
+	struct {
+		bool enabled;
+		double points[4]; /* x1, y1, x2, y2 */
+		double *lut;
+		unsigned int lut_size;
+		int lut_range;
+	} pressure_curve;
 };
 
 struct libinput_tablet_pad_mode_group {
@@ -399,6 +483,8 @@ struct libinput_event {
 
 struct libinput_event_listener {
 	struct list link;
+	struct libinput_device *device;
+	uint64_t event_mask;
 	void (*notify_func)(uint64_t time, struct libinput_event *ev, void *notify_func_data);
 	void *notify_func_data;
 };
@@ -450,6 +536,23 @@ libinput_init(struct libinput *libinput,
 	      const struct libinput_interface_backend *interface_backend,
 	      void *user_data);
 
+struct libinput_tablet_tool *
+libinput_tablet_tool_registry_find(struct libinput *libinput,
+				   enum libinput_tablet_tool_type type,
+				   uint32_t serial);
+
+void
+libinput_tablet_tool_registry_add(struct libinput *libinput,
+				  struct libinput_tablet_tool *tool);
+
+#if HAVE_LIBWACOM
+struct _WacomDeviceDatabase *
+libinput_libwacom_ref(struct libinput *libinput);
+
+void
+libinput_libwacom_unref(struct libinput *libinput);
+#endif
+
 struct libinput_source *
 libinput_add_fd(struct libinput *libinput,
 		int fd,
@@ -496,9 +599,31 @@ libinput_device_set_device_group(struct libinput_device *device,
 void
 libinput_device_init_event_listener(struct libinput_event_listener *listener);
 
+/* Event types are grouped in steps of 100 with fewer than 8 types per
+ * group, starting with the keyboard group at 300. Each type gets one bit,
+ * the device added/removed events are never passed to listeners and have
+ * no bit. */
+static inline uint64_t
+event_listener_mask(enum libinput_event_type type)
+{
+	unsigned int group = type / 100,
+		     offset = type % 100;
+
+	if (group < 3 || group > 9 || offset >= 8)
+		return 0;
+
+	return 1ULL << ((group - 3) * 8 + offset);
+}
+
+/**
+ * Add a listener for the events of device. The listener is only notified
+ * about events whose type is in event_mask, a mask of
+ * event_listener_mask() bits.
+ */
 void
 libinput_device_add_event_listener(struct libinput_device *device,
 				   struct libinput_event_listener *listener,
+				   uint64_t event_mask,
 				   void (*notify_func)(
 						uint64_t time,
 						struct libinput_event *event,
@@ -561,7 +686,8 @@ touch_notify_touch_motion(struct libinput_device *device,
 			  int32_t seat_slot,
 			  const struct device_coords *point,
  			  const struct ellipse *area,
-			  int32_t pressure);
+			  int32_t pressure,
+			  const struct device_float_coords *velocity);
  
 void
 touch_notify_touch_up(struct libinput_device *device,
@@ -618,7 +744,9 @@ tablet_notify_axis(struct libinput_device *device,
 		   struct libinput_tablet_tool *tool,
 		   enum libinput_tablet_tool_tip_state tip_state,
 		   unsigned char *changed_axes,
-		   const struct tablet_axes *axes);
+		   const struct tablet_axes *axes,
+		   const struct tablet_axes_sample *history,
+		   size_t history_size);
 
 void
 tablet_notify_proximity(struct libinput_device *device,
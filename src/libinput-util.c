@@ -404,6 +404,39 @@ parse_pressure_range_property(const char *prop, int *hi, int *lo)
 	return true;
 }
 
+/**
+ * Parses a string of the format "a:b" where a is a time window in ms and b
+ * is a number of events. The window must be a positive integer, the count
+ * a non-negative integer where 0 means no limit on the number of events.
+ *
+ * @param prop The value of the property
+ * @param window_ms Set to the first number
+ * @param count Set to the second number
+ * @return true on success, false otherwise
+ */
+bool
+parse_motion_coalesce_property(const char *prop,
+			       unsigned int *window_ms,
+			       unsigned int *count)
+{
+	int first, second, nread = 0;
+
+	if (!prop)
+		return false;
+
+	if (sscanf(prop, "%d:%d%n", &first, &second, &nread) != 2 ||
+	    prop[nread] != '\0')
+		return false;
+
+	if (first <= 0 || second < 0)
+		return false;
+
+	*window_ms = first;
+	*count = second;
+
+	return true;
+}
+
 /**
  * Return the next word in a string pointed to by state before the first
  * separator character. Call repeatedly to tokenize a whole string.
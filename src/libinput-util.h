@@ -132,6 +132,8 @@ bool list_empty(const struct list *list);
 #endif
 
 #define LIBINPUT_EXPORT __attribute__ ((visibility("default")))
+#define LIBINPUT_ATTRIBUTE_COLD __attribute__ ((cold))
+#define LIBINPUT_ATTRIBUTE_NOINLINE __attribute__ ((noinline))
 
 static inline void *
 zalloc(size_t size)
@@ -392,6 +394,9 @@ double parse_trackpoint_accel_property(const char *prop);
 bool parse_dimension_property(const char *prop, size_t *width, size_t *height);
 bool parse_calibration_property(const char *prop, float calibration[6]);
 bool parse_pressure_range_property(const char *prop, int *hi, int *lo);
+bool parse_motion_coalesce_property(const char *prop,
+				    unsigned int *window_ms,
+				    unsigned int *count);
 
 enum tpkbcombo_layout {
 	TPKBCOMBO_LAYOUT_UNKNOWN,
@@ -496,6 +501,41 @@ safe_atod(const char *str, double *val)
 	return true;
 }
 
+/**
+ * Apply a fuzz filter to nvalues values at once: a value is only accepted
+ * if it differs from the previously accepted value by more than its fuzz.
+ * The loop has no data-dependent branches, so the compiler can vectorize
+ * it and the cost does not depend on which values changed.
+ *
+ * @param values The new values
+ * @param accepted The previously accepted values, updated in place
+ * @param fuzz The fuzz of each value
+ * @param nvalues The number of values, at most 32
+ *
+ * @return A bitmask with bit n set if accepted[n] changed
+ */
+static inline uint32_t
+filter_fuzz_packed(const int *values,
+		   int *accepted,
+		   const int *fuzz,
+		   size_t nvalues)
+{
+	uint32_t changed = 0;
+	size_t i;
+
+	assert(nvalues <= 32);
+
+	for (i = 0; i < nvalues; i++) {
+		int delta = values[i] - accepted[i];
+		uint32_t is_changed = (delta > fuzz[i]) | (delta < -fuzz[i]);
+
+		accepted[i] = is_changed ? values[i] : accepted[i];
+		changed |= is_changed << i;
+	}
+
+	return changed;
+}
+
 char **strv_from_string(const char *string, const char *separator);
 
 static inline void
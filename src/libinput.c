@@ -33,6 +33,10 @@
 #include <unistd.h>
 #include <assert.h>
 
+#if HAVE_LIBWACOM
+#include <libwacom/libwacom.h>
+#endif
+
 #include "libinput.h"
 #include "libinput-private.h"
 #include "evdev.h"
@@ -73,6 +77,8 @@ ASSERT_INT_SIZE(enum libinput_config_click_method);
 ASSERT_INT_SIZE(enum libinput_config_middle_emulation_state);
 ASSERT_INT_SIZE(enum libinput_config_scroll_method);
 ASSERT_INT_SIZE(enum libinput_config_dwt_state);
+ASSERT_INT_SIZE(enum libinput_config_low_latency_state);
+ASSERT_INT_SIZE(enum libinput_config_batching_state);
 
 #ifndef ABS_MT_PALM
 #define ABS_MT_PALM 0x3e
@@ -172,6 +178,7 @@ struct libinput_event_pointer {
 	uint64_t time;
 	struct normalized_coords delta;
 	struct device_float_coords delta_raw;
+	struct normalized_coords velocity; /* units/us */
 	struct device_coords absolute;
 	struct discrete_coords discrete;
 	uint32_t button;
@@ -189,6 +196,7 @@ struct libinput_event_touch {
  	struct device_coords point;
  	struct ellipse area;
 	int32_t pressure;
+	struct device_float_coords velocity; /* units/us */
  };
 
 struct libinput_event_gesture {
@@ -213,6 +221,10 @@ struct libinput_event_tablet_tool {
 	struct libinput_tablet_tool *tool;
 	enum libinput_tablet_tool_proximity_state proximity_state;
 	enum libinput_tablet_tool_tip_state tip_state;
+
+	/* Batched axis events only, allocated with the event */
+	size_t history_size;
+	struct tablet_axes_sample history[];
 };
 
 struct libinput_event_tablet_pad {
@@ -599,6 +611,34 @@ libinput_event_pointer_get_dy_unaccelerated(
 	return event->delta_raw.y;
 }
 
+LIBINPUT_EXPORT double
+libinput_event_pointer_get_predicted_dx(struct libinput_event_pointer *event,
+					uint64_t dt_us)
+{
+	require_event_type(libinput_event_get_context(&event->base),
+			   event->base.type,
+			   0,
+			   LIBINPUT_EVENT_POINTER_MOTION);
+
+	dt_us = min(dt_us, MOTION_PREDICTOR_MAX_INTERVAL);
+
+	return event->delta.x + event->velocity.x * dt_us;
+}
+
+LIBINPUT_EXPORT double
+libinput_event_pointer_get_predicted_dy(struct libinput_event_pointer *event,
+					uint64_t dt_us)
+{
+	require_event_type(libinput_event_get_context(&event->base),
+			   event->base.type,
+			   0,
+			   LIBINPUT_EVENT_POINTER_MOTION);
+
+	dt_us = min(dt_us, MOTION_PREDICTOR_MAX_INTERVAL);
+
+	return event->delta.y + event->velocity.y * dt_us;
+}
+
 LIBINPUT_EXPORT double
 libinput_event_pointer_get_absolute_x(struct libinput_event_pointer *event)
 {
@@ -889,6 +929,82 @@ libinput_event_touch_get_y(struct libinput_event_touch *event)
 	return evdev_convert_to_mm(device->abs.absinfo_y, event->point.y);
 }
 
+LIBINPUT_EXPORT double
+libinput_event_touch_get_predicted_x(struct libinput_event_touch *event,
+				     uint64_t dt_us)
+{
+	struct evdev_device *device = evdev_device(event->base.device);
+
+	require_event_type(libinput_event_get_context(&event->base),
+			   event->base.type,
+			   0,
+			   LIBINPUT_EVENT_TOUCH_DOWN,
+			   LIBINPUT_EVENT_TOUCH_MOTION);
+
+	dt_us = min(dt_us, MOTION_PREDICTOR_MAX_INTERVAL);
+
+	return evdev_convert_to_mm(device->abs.absinfo_x,
+				   event->point.x + event->velocity.x * dt_us);
+}
+
+LIBINPUT_EXPORT double
+libinput_event_touch_get_predicted_y(struct libinput_event_touch *event,
+				     uint64_t dt_us)
+{
+	struct evdev_device *device = evdev_device(event->base.device);
+
+	require_event_type(libinput_event_get_context(&event->base),
+			   event->base.type,
+			   0,
+			   LIBINPUT_EVENT_TOUCH_DOWN,
+			   LIBINPUT_EVENT_TOUCH_MOTION);
+
+	dt_us = min(dt_us, MOTION_PREDICTOR_MAX_INTERVAL);
+
+	return evdev_convert_to_mm(device->abs.absinfo_y,
+				   event->point.y + event->velocity.y * dt_us);
+}
+
+LIBINPUT_EXPORT double
+libinput_event_touch_get_predicted_x_transformed(struct libinput_event_touch *event,
+						 uint64_t dt_us,
+						 uint32_t width)
+{
+	struct evdev_device *device = evdev_device(event->base.device);
+
+	require_event_type(libinput_event_get_context(&event->base),
+			   event->base.type,
+			   0,
+			   LIBINPUT_EVENT_TOUCH_DOWN,
+			   LIBINPUT_EVENT_TOUCH_MOTION);
+
+	dt_us = min(dt_us, MOTION_PREDICTOR_MAX_INTERVAL);
+
+	return evdev_device_transform_x(device,
+					event->point.x + event->velocity.x * dt_us,
+					width);
+}
+
+LIBINPUT_EXPORT double
+libinput_event_touch_get_predicted_y_transformed(struct libinput_event_touch *event,
+						 uint64_t dt_us,
+						 uint32_t height)
+{
+	struct evdev_device *device = evdev_device(event->base.device);
+
+	require_event_type(libinput_event_get_context(&event->base),
+			   event->base.type,
+			   0,
+			   LIBINPUT_EVENT_TOUCH_DOWN,
+			   LIBINPUT_EVENT_TOUCH_MOTION);
+
+	dt_us = min(dt_us, MOTION_PREDICTOR_MAX_INTERVAL);
+
+	return evdev_device_transform_y(device,
+					event->point.y + event->velocity.y * dt_us,
+					height);
+}
+
   LIBINPUT_EXPORT double
  libinput_event_touch_get_major(struct libinput_event_touch *event)
  {
@@ -1678,6 +1794,154 @@ libinput_event_tablet_tool_get_time_usec(struct libinput_event_tablet_tool *even
 	return event->time;
 }
 
+LIBINPUT_EXPORT unsigned int
+libinput_event_tablet_tool_get_history_size(struct libinput_event_tablet_tool *event)
+{
+	require_event_type(libinput_event_get_context(&event->base),
+			   event->base.type,
+			   0,
+			   LIBINPUT_EVENT_TABLET_TOOL_AXIS,
+			   LIBINPUT_EVENT_TABLET_TOOL_TIP,
+			   LIBINPUT_EVENT_TABLET_TOOL_BUTTON,
+			   LIBINPUT_EVENT_TABLET_TOOL_PROXIMITY);
+
+	return event->history_size;
+}
+
+static inline const struct tablet_axes_sample *
+tablet_tool_event_history(struct libinput_event_tablet_tool *event,
+			  unsigned int index)
+{
+	static const struct tablet_axes_sample none;
+
+	if (index >= event->history_size) {
+		log_bug_client(libinput_event_get_context(&event->base),
+			       "history index %u out of range\n",
+			       index);
+		return &none;
+	}
+
+	return &event->history[index];
+}
+
+LIBINPUT_EXPORT double
+libinput_event_tablet_tool_get_history_x(struct libinput_event_tablet_tool *event,
+					 unsigned int index)
+{
+	struct evdev_device *device = evdev_device(event->base.device);
+	const struct tablet_axes_sample *sample;
+
+	require_event_type(libinput_event_get_context(&event->base),
+			   event->base.type,
+			   0,
+			   LIBINPUT_EVENT_TABLET_TOOL_AXIS);
+
+	sample = tablet_tool_event_history(event, index);
+
+	return evdev_convert_to_mm(device->abs.absinfo_x, sample->point.x);
+}
+
+LIBINPUT_EXPORT double
+libinput_event_tablet_tool_get_history_y(struct libinput_event_tablet_tool *event,
+					 unsigned int index)
+{
+	struct evdev_device *device = evdev_device(event->base.device);
+	const struct tablet_axes_sample *sample;
+
+	require_event_type(libinput_event_get_context(&event->base),
+			   event->base.type,
+			   0,
+			   LIBINPUT_EVENT_TABLET_TOOL_AXIS);
+
+	sample = tablet_tool_event_history(event, index);
+
+	return evdev_convert_to_mm(device->abs.absinfo_y, sample->point.y);
+}
+
+LIBINPUT_EXPORT double
+libinput_event_tablet_tool_get_history_x_transformed(struct libinput_event_tablet_tool *event,
+						     unsigned int index,
+						     uint32_t width)
+{
+	struct evdev_device *device = evdev_device(event->base.device);
+	const struct tablet_axes_sample *sample;
+
+	require_event_type(libinput_event_get_context(&event->base),
+			   event->base.type,
+			   0,
+			   LIBINPUT_EVENT_TABLET_TOOL_AXIS);
+
+	sample = tablet_tool_event_history(event, index);
+
+	return evdev_device_transform_x(device, sample->point.x, width);
+}
+
+LIBINPUT_EXPORT double
+libinput_event_tablet_tool_get_history_y_transformed(struct libinput_event_tablet_tool *event,
+						     unsigned int index,
+						     uint32_t height)
+{
+	struct evdev_device *device = evdev_device(event->base.device);
+	const struct tablet_axes_sample *sample;
+
+	require_event_type(libinput_event_get_context(&event->base),
+			   event->base.type,
+			   0,
+			   LIBINPUT_EVENT_TABLET_TOOL_AXIS);
+
+	sample = tablet_tool_event_history(event, index);
+
+	return evdev_device_transform_y(device, sample->point.y, height);
+}
+
+LIBINPUT_EXPORT double
+libinput_event_tablet_tool_get_history_pressure(struct libinput_event_tablet_tool *event,
+						unsigned int index)
+{
+	require_event_type(libinput_event_get_context(&event->base),
+			   event->base.type,
+			   0,
+			   LIBINPUT_EVENT_TABLET_TOOL_AXIS);
+
+	return tablet_tool_event_history(event, index)->pressure;
+}
+
+LIBINPUT_EXPORT double
+libinput_event_tablet_tool_get_history_tilt_x(struct libinput_event_tablet_tool *event,
+					      unsigned int index)
+{
+	require_event_type(libinput_event_get_context(&event->base),
+			   event->base.type,
+			   0,
+			   LIBINPUT_EVENT_TABLET_TOOL_AXIS);
+
+	return tablet_tool_event_history(event, index)->tilt.x;
+}
+
+LIBINPUT_EXPORT double
+libinput_event_tablet_tool_get_history_tilt_y(struct libinput_event_tablet_tool *event,
+					      unsigned int index)
+{
+	require_event_type(libinput_event_get_context(&event->base),
+			   event->base.type,
+			   0,
+			   LIBINPUT_EVENT_TABLET_TOOL_AXIS);
+
+	return tablet_tool_event_history(event, index)->tilt.y;
+}
+
+LIBINPUT_EXPORT uint64_t
+libinput_event_tablet_tool_get_history_time_usec(struct libinput_event_tablet_tool *event,
+						 unsigned int index)
+{
+	require_event_type(libinput_event_get_context(&event->base),
+			   event->base.type,
+			   0,
+			   LIBINPUT_EVENT_TABLET_TOOL_AXIS);
+
+	return tablet_tool_event_history(event, index)->time;
+}
+
 LIBINPUT_EXPORT uint32_t
 libinput_event_tablet_tool_get_button(struct libinput_event_tablet_tool *event)
 {
@@ -1817,10 +2081,215 @@ libinput_tablet_tool_unref(struct libinput_tablet_tool *tool)
 		return tool;
 
 	list_remove(&tool->link);
+	free(tool->pressure_curve.lut);
 	free(tool);
 	return NULL;
 }
 
+static const double default_pressure_curve[4] = { 0.0, 0.0, 1.0, 1.0 };
+
+LIBINPUT_EXPORT int
+libinput_tablet_tool_config_pressure_curve_is_available(struct libinput_tablet_tool *tool)
+{
+	return libinput_tablet_tool_has_pressure(tool);
+}
+
+LIBINPUT_EXPORT enum libinput_config_status
+libinput_tablet_tool_config_pressure_curve_set(struct libinput_tablet_tool *tool,
+					       const double curve[4])
+{
+	bool is_default = true;
+	size_t i;
+
+	if (!libinput_tablet_tool_config_pressure_curve_is_available(tool))
+		return LIBINPUT_CONFIG_STATUS_UNSUPPORTED;
+
+	for (i = 0; i < ARRAY_LENGTH(default_pressure_curve); i++) {
+		if (!(curve[i] >= 0.0 && curve[i] <= 1.0))
+			return LIBINPUT_CONFIG_STATUS_INVALID;
+		if (curve[i] != default_pressure_curve[i])
+			is_default = false;
+	}
+
+	/* The table is rebuilt on the next pressure event */
+	free(tool->pressure_curve.lut);
+	tool->pressure_curve.lut = NULL;
+	tool->pressure_curve.enabled = !is_default;
+	memcpy(tool->pressure_curve.points,
+	       curve,
+	       sizeof(tool->pressure_curve.points));
+
+	return LIBINPUT_CONFIG_STATUS_SUCCESS;
+}
+
+LIBINPUT_EXPORT int
+libinput_tablet_tool_config_pressure_curve_get(struct libinput_tablet_tool *tool,
+					       double curve[4])
+{
+	if (!tool->pressure_curve.enabled) {
+		memcpy(curve,
+		       default_pressure_curve,
+		       sizeof(default_pressure_curve));
+		return 0;
+	}
+
+	memcpy(curve,
+	       tool->pressure_curve.points,
+	       sizeof(tool->pressure_curve.points));
+	return 1;
+}
+
+LIBINPUT_EXPORT int
+libinput_tablet_tool_config_pressure_curve_get_default(struct libinput_tablet_tool *tool,
+						       double curve[4])
+{
+	memcpy(curve, default_pressure_curve, sizeof(default_pressure_curve));
+	return 0;
+}
+
+static inline struct list *
+tablet_tool_bucket(struct libinput *libinput,
+		   enum libinput_tablet_tool_type type,
+		   uint32_t serial)
+{
+	uint32_t hash = (serial ^ ((uint32_t)type << 16)) * 2654435761U;
+
+	/* Multiplicative hash, the high bits are the well-mixed ones */
+	return &libinput->tools.buckets[hash >> (32 - TABLET_TOOL_HASH_BITS)];
+}
+
+/**
+ * Find the tool with the given type and serial and mark it as the most
+ * recently used one.
+ *
+ * @return The tool or NULL if the registry doesn't have it
+ */
+struct libinput_tablet_tool *
+libinput_tablet_tool_registry_find(struct libinput *libinput,
+				   enum libinput_tablet_tool_type type,
+				   uint32_t serial)
+{
+	struct libinput_tablet_tool *tool;
+
+	libinput->tools.stats.lookups++;
+
+	list_for_each(tool,
+		      tablet_tool_bucket(libinput, type, serial),
+		      hash_link) {
+		libinput->tools.stats.compares++;
+		if (tool->type != type || tool->serial != serial)
+			continue;
+
+		list_remove(&tool->link);
+		list_insert(&libinput->tools.lru, &tool->link);
+		return tool;
+	}
+
+	return NULL;
+}
+
+static void
+tablet_tool_registry_evict(struct libinput *libinput)
+{
+	struct list *elm = libinput->tools.lru.prev;
+
+	/* Walk from the least recently used tool, anything the caller or
+	 * a tablet still holds a reference to stays. The most recently
+	 * used tool is the one just added, it always stays */
+	while (elm != libinput->tools.lru.next &&
+	       libinput->tools.count > TABLET_TOOL_REGISTRY_MAX) {
+		struct libinput_tablet_tool *tool;
+
+		tool = container_of(elm, struct libinput_tablet_tool, link);
+		elm = elm->prev;
+
+		if (tool->refcount > 1)
+			continue;
+
+		list_remove(&tool->hash_link);
+		libinput->tools.count--;
+		libinput->tools.stats.evictions++;
+		libinput_tablet_tool_unref(tool);
+	}
+}
+
+/**
+ * Add a tool with a serial number to the registry, which takes over the
+ * caller's reference. The registry evicts the least recently used tools
+ * nobody else references once it holds more than
+ * TABLET_TOOL_REGISTRY_MAX tools, a tool that comes back later is a new
+ * libinput_tablet_tool.
+ */
+void
+libinput_tablet_tool_registry_add(struct libinput *libinput,
+				  struct libinput_tablet_tool *tool)
+{
+	list_insert(&libinput->tools.lru, &tool->link);
+	list_insert(tablet_tool_bucket(libinput, tool->type, tool->serial),
+		    &tool->hash_link);
+	libinput->tools.count++;
+
+	tablet_tool_registry_evict(libinput);
+}
+
+#if HAVE_LIBWACOM
+/**
+ * Return the libwacom database of this context, it is loaded on the first
+ * call. Loading the database parses every tablet description on the
+ * system, so all tablets and pads share one copy. It stays loaded when the
+ * last reference goes away so a replugged tablet does not parse it again,
+ * it is only freed on libinput_suspend() and libinput_unref().
+ *
+ * Tablets and pads drop their reference when the device is removed, not
+ * when it is destroyed, so events still in the queue don't keep the
+ * database loaded across libinput_suspend().
+ *
+ * @return The database or NULL if it could not be loaded, in which case
+ * no reference is taken
+ */
+WacomDeviceDatabase *
+libinput_libwacom_ref(struct libinput *libinput)
+{
+	uint64_t start;
+
+	if (!libinput->libwacom.db) {
+		start = libinput_now(libinput);
+		libinput->libwacom.db = libwacom_database_new();
+		if (!libinput->libwacom.db) {
+			log_info(libinput,
+				 "Failed to initialize libwacom context.\n");
+			return NULL;
+		}
+		log_debug(libinput,
+			  "libwacom database loaded in %ums\n",
+			  us2ms(libinput_now(libinput) - start));
+	}
+
+	libinput->libwacom.refcount++;
+
+	return libinput->libwacom.db;
+}
+
+void
+libinput_libwacom_unref(struct libinput *libinput)
+{
+	assert(libinput->libwacom.refcount > 0);
+
+	libinput->libwacom.refcount--;
+}
+
+/* Frees the database once no tablet or pad is using it */
+static void
+libinput_libwacom_release(struct libinput *libinput)
+{
+	if (libinput->libwacom.refcount > 0 || !libinput->libwacom.db)
+		return;
+
+	libwacom_database_destroy(libinput->libwacom.db);
+	libinput->libwacom.db = NULL;
+}
+#endif
+
 LIBINPUT_EXPORT struct libinput_event *
 libinput_event_switch_get_base_event(struct libinput_event_switch *event)
 {
@@ -2051,6 +2520,8 @@ libinput_init(struct libinput *libinput,
 	      const struct libinput_interface_backend *interface_backend,
 	      void *user_data)
 {
+	size_t i;
+
 	assert(interface->open_restricted != NULL);
 	assert(interface->close_restricted != NULL);
 
@@ -2074,7 +2545,9 @@ libinput_init(struct libinput *libinput,
 	list_init(&libinput->source_destroy_list);
 	list_init(&libinput->seat_list);
 	list_init(&libinput->device_group_list);
-	list_init(&libinput->tool_list);
+	list_init(&libinput->tools.lru);
+	for (i = 0; i < ARRAY_LENGTH(libinput->tools.buckets); i++)
+		list_init(&libinput->tools.buckets[i]);
 
 	if (libinput_timer_subsys_init(libinput) != 0) {
 		free(libinput->events);
@@ -2150,7 +2623,20 @@ libinput_unref(struct libinput *libinput)
 		libinput_device_group_destroy(group);
 	}
 
-	list_for_each_safe(tool, next_tool, &libinput->tool_list, link) {
+#if HAVE_LIBWACOM
+	libinput_libwacom_release(libinput);
+#endif
+
+	if (libinput->tools.stats.lookups > 0)
+		log_debug(libinput,
+			  "tablet tools: %" PRIu64 " lookups, %.2f compares per lookup, %" PRIu64 " evictions\n",
+			  libinput->tools.stats.lookups,
+			  (double)libinput->tools.stats.compares/
+				  libinput->tools.stats.lookups,
+			  libinput->tools.stats.evictions);
+
+	list_for_each_safe(tool, next_tool, &libinput->tools.lru, link) {
+		list_remove(&tool->hash_link);
 		libinput_tablet_tool_unref(tool);
 	}
 
@@ -2374,26 +2860,43 @@ void
 libinput_device_init_event_listener(struct libinput_event_listener *listener)
 {
 	list_init(&listener->link);
+	listener->device = NULL;
 }
 
 void
 libinput_device_add_event_listener(struct libinput_device *device,
 				   struct libinput_event_listener *listener,
+				   uint64_t event_mask,
 				   void (*notify_func)(
 						uint64_t time,
 						struct libinput_event *event,
 						void *notify_func_data),
 				   void *notify_func_data)
 {
+	listener->device = device;
+	listener->event_mask = event_mask;
 	listener->notify_func = notify_func;
 	listener->notify_func_data = notify_func_data;
 	list_insert(&device->event_listeners, &listener->link);
+
+	device->event_listener_mask |= event_mask;
 }
 
 void
 libinput_device_remove_event_listener(struct libinput_event_listener *listener)
 {
+	struct libinput_device *device = listener->device;
+	struct libinput_event_listener *l;
+
 	list_remove(&listener->link);
+	listener->device = NULL;
+
+	if (!device)
+		return;
+
+	device->event_listener_mask = 0;
+	list_for_each(l, &device->event_listeners, link)
+		device->event_listener_mask |= l->event_mask;
 }
 
 static uint32_t
@@ -2464,6 +2967,7 @@ post_device_event(struct libinput_device *device,
 		  struct libinput_event *event)
 {
 	struct libinput_event_listener *listener, *tmp;
+	uint64_t mask;
 #if 0
 	struct libinput *libinput = device->seat->libinput;
 
@@ -2478,8 +2982,15 @@ post_device_event(struct libinput_device *device,
 
 	init_event_base(event, device, type);
 
-	list_for_each_safe(listener, tmp, &device->event_listeners, link)
-		listener->notify_func(time, event, listener->notify_func_data);
+	mask = event_listener_mask(type);
+	if (device->event_listener_mask & mask) {
+		list_for_each_safe(listener, tmp, &device->event_listeners, link) {
+			if (listener->event_mask & mask)
+				listener->notify_func(time,
+						      event,
+						      listener->notify_func_data);
+		}
+	}
 
 	libinput_post_event(device->seat->libinput, event);
 }
@@ -2524,15 +3035,13 @@ notify_removed_device(struct libinput_device *device)
 	TRACE_INPUT_END();
 }
 
-static inline bool
-device_has_cap(struct libinput_device *device,
-	       enum libinput_device_capability cap)
+/* Only reached on a bug, keep it out of the notify paths */
+static void LIBINPUT_ATTRIBUTE_COLD LIBINPUT_ATTRIBUTE_NOINLINE
+log_missing_cap(struct libinput_device *device,
+		enum libinput_device_capability cap)
 {
 	const char *capability;
 
-	if (libinput_device_has_capability(device, cap))
-		return true;
-
 	switch (cap) {
 	case LIBINPUT_DEVICE_CAP_POINTER:
 		capability = "CAP_POINTER";
@@ -2561,6 +3070,19 @@ device_has_cap(struct libinput_device *device,
 			 "Event for missing capability %s on device \"%s\"\n",
 			 capability,
 			 libinput_device_get_name(device));
+}
+
+/* Called for every event with a constant cap, so the check folds into a
+ * single test of the device's seat_caps. The capabilities are settled
+ * once evdev_configure_device() returns. */
+static inline bool
+device_has_cap(struct libinput_device *device,
+	       enum libinput_device_capability cap)
+{
+	if (evdev_device_has_capability(evdev_device(device), cap))
+		return true;
+
+	log_missing_cap(device, cap);
 
 	return false;
 }
@@ -2610,6 +3132,8 @@ pointer_notify_motion(struct libinput_device *device,
 		      const struct device_float_coords *raw)
 {
 	struct libinput_event_pointer *motion_event;
+	struct evdev_device *evdev = evdev_device(device);
+	struct device_float_coords velocity;
 
 	TRACE_INPUT_BEGIN(pointer_notify_motion);
 
@@ -2624,10 +3148,21 @@ pointer_notify_motion(struct libinput_device *device,
 		return;
 	}
 
+	/* The predictor works on positions, so feed it the sum of all
+	 * deltas so far */
+	evdev->pointer.position.x += delta->x;
+	evdev->pointer.position.y += delta->y;
+	motion_predictor_push(&evdev->pointer.predictor,
+			      &evdev->pointer.position,
+			      time);
+	velocity = motion_predictor_velocity(&evdev->pointer.predictor);
+
 	*motion_event = (struct libinput_event_pointer) {
 		.time = time,
 		.delta = *delta,
 		.delta_raw = *raw,
+		.velocity.x = velocity.x,
+		.velocity.y = velocity.y,
 	};
 
 	post_device_event(device, time,
@@ -2794,7 +3329,8 @@ touch_notify_touch_motion(struct libinput_device *device,
 			  int32_t seat_slot,
 			  const struct device_coords *point,
 			  const struct ellipse *area,
-			  int32_t pressure)
+			  int32_t pressure,
+			  const struct device_float_coords *velocity)
 {
 	struct libinput_event_touch *touch_event;
 
@@ -2818,6 +3354,7 @@ touch_notify_touch_motion(struct libinput_device *device,
 		.point = *point,
 		.area = *area,
 		.pressure = pressure,
+		.velocity = *velocity,
 	};
 
 	post_device_event(device, time,
@@ -2889,11 +3426,14 @@ tablet_notify_axis(struct libinput_device *device,
 		   struct libinput_tablet_tool *tool,
 		   enum libinput_tablet_tool_tip_state tip_state,
 		   unsigned char *changed_axes,
-		   const struct tablet_axes *axes)
+		   const struct tablet_axes *axes,
+		   const struct tablet_axes_sample *history,
+		   size_t history_size)
 {
 	struct libinput_event_tablet_tool *axis_event;
 
-	axis_event = zalloc(sizeof *axis_event);
+	axis_event = zalloc(sizeof *axis_event +
+			    history_size * sizeof(*history));
 	if (!axis_event)
 		return;
 
@@ -2909,6 +3449,13 @@ tablet_notify_axis(struct libinput_device *device,
 	       changed_axes,
 	       sizeof(axis_event->changed_axes));
 
+	if (history_size > 0) {
+		memcpy(axis_event->history,
+		       history,
+		       history_size * sizeof(*history));
+		axis_event->history_size = history_size;
+	}
+
 	post_device_event(device,
 			  time,
 			  LIBINPUT_EVENT_TABLET_TOOL_AXIS,
@@ -3352,6 +3899,10 @@ LIBINPUT_EXPORT void
 libinput_suspend(struct libinput *libinput)
 {
 	libinput->interface_backend->suspend(libinput);
+
+#if HAVE_LIBWACOM
+	libinput_libwacom_release(libinput);
+#endif
 }
 
 LIBINPUT_EXPORT void
@@ -4561,6 +5112,122 @@ libinput_device_config_dwt_get_default_enabled(struct libinput_device *device)
 	return device->config.dwt->get_default_enabled(device);
 }
 
+LIBINPUT_EXPORT int
+libinput_device_config_low_latency_is_available(struct libinput_device *device)
+{
+	if (!device->config.low_latency)
+		return 0;
+
+	return device->config.low_latency->is_available(device);
+}
+
+LIBINPUT_EXPORT enum libinput_config_status
+libinput_device_config_low_latency_set_enabled(struct libinput_device *device,
+					       enum libinput_config_low_latency_state enable)
+{
+	if (enable != LIBINPUT_CONFIG_LOW_LATENCY_ENABLED &&
+	    enable != LIBINPUT_CONFIG_LOW_LATENCY_DISABLED)
+		return LIBINPUT_CONFIG_STATUS_INVALID;
+
+	if (!libinput_device_config_low_latency_is_available(device))
+		return enable ? LIBINPUT_CONFIG_STATUS_UNSUPPORTED :
+				LIBINPUT_CONFIG_STATUS_SUCCESS;
+
+	return device->config.low_latency->set_enabled(device, enable);
+}
+
+LIBINPUT_EXPORT enum libinput_config_low_latency_state
+libinput_device_config_low_latency_get_enabled(struct libinput_device *device)
+{
+	if (!libinput_device_config_low_latency_is_available(device))
+		return LIBINPUT_CONFIG_LOW_LATENCY_DISABLED;
+
+	return device->config.low_latency->get_enabled(device);
+}
+
+LIBINPUT_EXPORT enum libinput_config_low_latency_state
+libinput_device_config_low_latency_get_default_enabled(struct libinput_device *device)
+{
+	if (!libinput_device_config_low_latency_is_available(device))
+		return LIBINPUT_CONFIG_LOW_LATENCY_DISABLED;
+
+	return device->config.low_latency->get_default_enabled(device);
+}
+
+LIBINPUT_EXPORT enum libinput_config_status
+libinput_device_config_low_latency_set_smoothing(struct libinput_device *device,
+						 double smoothing)
+{
+	/* Need the negation in case smoothing is NaN */
+	if (!(smoothing >= 0.0 && smoothing <= 1.0))
+		return LIBINPUT_CONFIG_STATUS_INVALID;
+
+	if (!libinput_device_config_low_latency_is_available(device))
+		return LIBINPUT_CONFIG_STATUS_UNSUPPORTED;
+
+	return device->config.low_latency->set_smoothing(device, smoothing);
+}
+
+LIBINPUT_EXPORT double
+libinput_device_config_low_latency_get_smoothing(struct libinput_device *device)
+{
+	if (!libinput_device_config_low_latency_is_available(device))
+		return 0.0;
+
+	return device->config.low_latency->get_smoothing(device);
+}
+
+LIBINPUT_EXPORT double
+libinput_device_config_low_latency_get_default_smoothing(struct libinput_device *device)
+{
+	if (!libinput_device_config_low_latency_is_available(device))
+		return 0.0;
+
+	return device->config.low_latency->get_default_smoothing(device);
+}
+
+LIBINPUT_EXPORT int
+libinput_device_config_batching_is_available(struct libinput_device *device)
+{
+	if (!device->config.batching)
+		return 0;
+
+	return device->config.batching->is_available(device);
+}
+
+LIBINPUT_EXPORT enum libinput_config_status
+libinput_device_config_batching_set_enabled(struct libinput_device *device,
+					    enum libinput_config_batching_state enable)
+{
+	if (enable != LIBINPUT_CONFIG_BATCHING_ENABLED &&
+	    enable != LIBINPUT_CONFIG_BATCHING_DISABLED)
+		return LIBINPUT_CONFIG_STATUS_INVALID;
+
+	if (!libinput_device_config_batching_is_available(device))
+		return enable ? LIBINPUT_CONFIG_STATUS_UNSUPPORTED :
+				LIBINPUT_CONFIG_STATUS_SUCCESS;
+
+	return device->config.batching->set_enabled(device, enable);
+}
+
+LIBINPUT_EXPORT enum libinput_config_batching_state
+libinput_device_config_batching_get_enabled(struct libinput_device *device)
+{
+	if (!libinput_device_config_batching_is_available(device))
+		return LIBINPUT_CONFIG_BATCHING_DISABLED;
+
+	return device->config.batching->get_enabled(device);
+}
+
+LIBINPUT_EXPORT enum libinput_config_batching_state
+libinput_device_config_batching_get_default_enabled(struct libinput_device *device)
+{
+	if (!libinput_device_config_batching_is_available(device))
+		return LIBINPUT_CONFIG_BATCHING_DISABLED;
+
+	return device->config.batching->get_default_enabled(device);
+}
+
 LIBINPUT_EXPORT int
 libinput_device_config_rotation_is_available(struct libinput_device *device)
 {
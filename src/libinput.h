@@ -1169,6 +1169,50 @@ double
 libinput_event_pointer_get_dy_unaccelerated(
 	struct libinput_event_pointer *event);
 
+/**
+ * @ingroup event_pointer
+ *
+ * Return the relative x delta of the current event plus the motion
+ * libinput expects within the given interval after the event, based on
+ * the recent motion history of the device. A caller that renders the
+ * pointer with a known display latency may use this to place the pointer
+ * where it is likely to be once the frame is visible. For pointer events
+ * that are not of type @ref LIBINPUT_EVENT_POINTER_MOTION, this function
+ * returns 0.
+ *
+ * The prediction is limited to 50ms, longer intervals are clamped. With an
+ * interval of 0 this function returns the same value as
+ * libinput_event_pointer_get_dx().
+ *
+ * @note It is an application bug to call this function for events other than
+ * @ref LIBINPUT_EVENT_POINTER_MOTION.
+ *
+ * @param event The libinput pointer event
+ * @param dt_us The interval to predict in microseconds
+ * @return The predicted relative x movement since the last event
+ */
+double
+libinput_event_pointer_get_predicted_dx(struct libinput_event_pointer *event,
+					uint64_t dt_us);
+
+/**
+ * @ingroup event_pointer
+ *
+ * Return the relative y delta of the current event plus the motion
+ * libinput expects within the given interval after the event. See
+ * libinput_event_pointer_get_predicted_dx() for details.
+ *
+ * @note It is an application bug to call this function for events other than
+ * @ref LIBINPUT_EVENT_POINTER_MOTION.
+ *
+ * @param event The libinput pointer event
+ * @param dt_us The interval to predict in microseconds
+ * @return The predicted relative y movement since the last event
+ */
+double
+libinput_event_pointer_get_predicted_dy(struct libinput_event_pointer *event,
+					uint64_t dt_us);
+
 /**
  * @ingroup event_pointer
  *
@@ -1574,6 +1618,94 @@ double
 libinput_event_touch_get_y_transformed(struct libinput_event_touch *event,
 				       uint32_t height);
 
+/**
+ * @ingroup event_touch
+ *
+ * Return the absolute x coordinate the touch is expected to be at the given
+ * interval after this event, in mm from the top left corner of the device.
+ * The prediction is based on the recent motion history of this touch and
+ * limited to 50ms, longer intervals are clamped.
+ *
+ * For events of type @ref LIBINPUT_EVENT_TOUCH_DOWN or with an interval
+ * of 0 this function returns the same value as libinput_event_touch_get_x().
+ * For events not of type @ref LIBINPUT_EVENT_TOUCH_DOWN, @ref
+ * LIBINPUT_EVENT_TOUCH_MOTION, this function returns 0.
+ *
+ * @note It is an application bug to call this function for events of type
+ * other than @ref LIBINPUT_EVENT_TOUCH_DOWN or @ref
+ * LIBINPUT_EVENT_TOUCH_MOTION.
+ *
+ * @param event The libinput touch event
+ * @param dt_us The interval to predict in microseconds
+ * @return The predicted absolute x coordinate
+ */
+double
+libinput_event_touch_get_predicted_x(struct libinput_event_touch *event,
+				     uint64_t dt_us);
+
+/**
+ * @ingroup event_touch
+ *
+ * Return the absolute y coordinate the touch is expected to be at the given
+ * interval after this event, in mm from the top left corner of the device.
+ * See libinput_event_touch_get_predicted_x() for details.
+ *
+ * @note It is an application bug to call this function for events of type
+ * other than @ref LIBINPUT_EVENT_TOUCH_DOWN or @ref
+ * LIBINPUT_EVENT_TOUCH_MOTION.
+ *
+ * @param event The libinput touch event
+ * @param dt_us The interval to predict in microseconds
+ * @return The predicted absolute y coordinate
+ */
+double
+libinput_event_touch_get_predicted_y(struct libinput_event_touch *event,
+				     uint64_t dt_us);
+
+/**
+ * @ingroup event_touch
+ *
+ * Return the predicted absolute x coordinate of the touch, transformed to
+ * screen coordinates. See libinput_event_touch_get_predicted_x() for
+ * details.
+ *
+ * @note It is an application bug to call this function for events of type
+ * other than @ref LIBINPUT_EVENT_TOUCH_DOWN or @ref
+ * LIBINPUT_EVENT_TOUCH_MOTION.
+ *
+ * @param event The libinput touch event
+ * @param dt_us The interval to predict in microseconds
+ * @param width The current output screen width
+ * @return The predicted absolute x coordinate transformed to a screen
+ * coordinate
+ */
+double
+libinput_event_touch_get_predicted_x_transformed(struct libinput_event_touch *event,
+						 uint64_t dt_us,
+						 uint32_t width);
+
+/**
+ * @ingroup event_touch
+ *
+ * Return the predicted absolute y coordinate of the touch, transformed to
+ * screen coordinates. See libinput_event_touch_get_predicted_x() for
+ * details.
+ *
+ * @note It is an application bug to call this function for events of type
+ * other than @ref LIBINPUT_EVENT_TOUCH_DOWN or @ref
+ * LIBINPUT_EVENT_TOUCH_MOTION.
+ *
+ * @param event The libinput touch event
+ * @param dt_us The interval to predict in microseconds
+ * @param height The current output screen height
+ * @return The predicted absolute y coordinate transformed to a screen
+ * coordinate
+ */
+double
+libinput_event_touch_get_predicted_y_transformed(struct libinput_event_touch *event,
+						 uint64_t dt_us,
+						 uint32_t height);
+
 /**
  * @ingroup event_touch
  *
@@ -2584,6 +2716,154 @@ libinput_event_tablet_tool_get_time(struct libinput_event_tablet_tool *event);
 uint64_t
 libinput_event_tablet_tool_get_time_usec(struct libinput_event_tablet_tool *event);
 
+/**
+ * @ingroup event_tablet
+ *
+ * Return the number of intermediate samples in this event. If batching is
+ * enabled with libinput_device_config_batching_set_enabled(), several
+ * frames of a tablet tool may be coalesced into one @ref
+ * LIBINPUT_EVENT_TABLET_TOOL_AXIS event. The event itself carries the most
+ * recent state, the samples before it are available with the
+ * libinput_event_tablet_tool_get_history_* functions, with index 0 being
+ * the oldest sample.
+ *
+ * The deltas and the wheel of a batched event are the sums over all
+ * samples, the axis change flags are set if the axis changed in any
+ * sample.
+ *
+ * For events that are not of type @ref LIBINPUT_EVENT_TABLET_TOOL_AXIS,
+ * this function returns 0.
+ *
+ * @param event The libinput tablet tool event
+ * @return The number of samples before the current state of this event
+ */
+unsigned int
+libinput_event_tablet_tool_get_history_size(struct libinput_event_tablet_tool *event);
+
+/**
+ * @ingroup event_tablet
+ *
+ * Return the X coordinate of the given intermediate sample, see
+ * libinput_event_tablet_tool_get_x() for the coordinate space.
+ *
+ * @param event The libinput tablet tool event
+ * @param index The sample index, less than
+ * libinput_event_tablet_tool_get_history_size()
+ * @return The x coordinate of the sample in mm from the top left corner
+ */
+double
+libinput_event_tablet_tool_get_history_x(struct libinput_event_tablet_tool *event,
+					 unsigned int index);
+
+/**
+ * @ingroup event_tablet
+ *
+ * Return the Y coordinate of the given intermediate sample, see
+ * libinput_event_tablet_tool_get_y() for the coordinate space.
+ *
+ * @param event The libinput tablet tool event
+ * @param index The sample index, less than
+ * libinput_event_tablet_tool_get_history_size()
+ * @return The y coordinate of the sample in mm from the top left corner
+ */
+double
+libinput_event_tablet_tool_get_history_y(struct libinput_event_tablet_tool *event,
+					 unsigned int index);
+
+/**
+ * @ingroup event_tablet
+ *
+ * Return the X coordinate of the given intermediate sample, transformed to
+ * screen coordinates like libinput_event_tablet_tool_get_x_transformed().
+ *
+ * @param event The libinput tablet tool event
+ * @param index The sample index, less than
+ * libinput_event_tablet_tool_get_history_size()
+ * @param width The current output screen width
+ * @return The x coordinate of the sample transformed to a screen coordinate
+ */
+double
+libinput_event_tablet_tool_get_history_x_transformed(struct libinput_event_tablet_tool *event,
+						     unsigned int index,
+						     uint32_t width);
+
+/**
+ * @ingroup event_tablet
+ *
+ * Return the Y coordinate of the given intermediate sample, transformed to
+ * screen coordinates like libinput_event_tablet_tool_get_y_transformed().
+ *
+ * @param event The libinput tablet tool event
+ * @param index The sample index, less than
+ * libinput_event_tablet_tool_get_history_size()
+ * @param height The current output screen height
+ * @return The y coordinate of the sample transformed to a screen coordinate
+ */
+double
+libinput_event_tablet_tool_get_history_y_transformed(struct libinput_event_tablet_tool *event,
+						     unsigned int index,
+						     uint32_t height);
+
+/**
+ * @ingroup event_tablet
+ *
+ * Return the pressure of the given intermediate sample, see
+ * libinput_event_tablet_tool_get_pressure(). If the tool does not have a
+ * pressure axis, this function returns 0.
+ *
+ * @param event The libinput tablet tool event
+ * @param index The sample index, less than
+ * libinput_event_tablet_tool_get_history_size()
+ * @return The pressure of the sample, normalized to the range [0, 1]
+ */
+double
+libinput_event_tablet_tool_get_history_pressure(struct libinput_event_tablet_tool *event,
+						unsigned int index);
+
+/**
+ * @ingroup event_tablet
+ *
+ * Return the tilt along the X axis of the given intermediate sample, see
+ * libinput_event_tablet_tool_get_tilt_x(). If the tool does not have a
+ * tilt axis, this function returns 0.
+ *
+ * @param event The libinput tablet tool event
+ * @param index The sample index, less than
+ * libinput_event_tablet_tool_get_history_size()
+ * @return The tilt along the X axis of the sample in degrees
+ */
+double
+libinput_event_tablet_tool_get_history_tilt_x(struct libinput_event_tablet_tool *event,
+					      unsigned int index);
+
+/**
+ * @ingroup event_tablet
+ *
+ * Return the tilt along the Y axis of the given intermediate sample, see
+ * libinput_event_tablet_tool_get_tilt_y(). If the tool does not have a
+ * tilt axis, this function returns 0.
+ *
+ * @param event The libinput tablet tool event
+ * @param index The sample index, less than
+ * libinput_event_tablet_tool_get_history_size()
+ * @return The tilt along the Y axis of the sample in degrees
+ */
+double
+libinput_event_tablet_tool_get_history_tilt_y(struct libinput_event_tablet_tool *event,
+					      unsigned int index);
+
+/**
+ * @ingroup event_tablet
+ *
+ * @param event The libinput tablet tool event
+ * @param index The sample index, less than
+ * libinput_event_tablet_tool_get_history_size()
+ * @return The time of the sample in microseconds
+ */
+uint64_t
+libinput_event_tablet_tool_get_history_time_usec(struct libinput_event_tablet_tool *event,
+						 unsigned int index);
+
 /**
  * @ingroup event_tablet
  *
@@ -2784,6 +3064,89 @@ void
 libinput_tablet_tool_set_user_data(struct libinput_tablet_tool *tool,
 				   void *user_data);
 
+/**
+ * @ingroup event_tablet
+ *
+ * Check if the pressure curve of this tool can be changed. This is the
+ * case for all tools with a pressure axis, see
+ * libinput_tablet_tool_has_pressure().
+ *
+ * @param tool The libinput tool
+ * @return Non-zero if the pressure curve can be changed, zero otherwise
+ *
+ * @see libinput_tablet_tool_config_pressure_curve_set
+ * @see libinput_tablet_tool_config_pressure_curve_get
+ * @see libinput_tablet_tool_config_pressure_curve_get_default
+ */
+int
+libinput_tablet_tool_config_pressure_curve_is_available(struct libinput_tablet_tool *tool);
+
+/**
+ * @ingroup event_tablet
+ *
+ * Set the pressure curve of this tool. The curve is a cubic Bezier curve
+ * from (0, 0) to (1, 1) with the two control points (x1, y1) and (x2, y2),
+ * it maps the normalized pressure on the x axis to the pressure returned
+ * by libinput_event_tablet_tool_get_pressure() on the y axis. The default
+ * curve { 0.0, 0.0, 1.0, 1.0 } is linear. A curve like
+ * { 0.0, 0.75, 0.25, 1.0 } makes the tool respond more to light pressure.
+ *
+ * The curve is a property of the tool, it applies on every tablet the tool
+ * is used with. See @ref tablet-pressure-curve for details.
+ *
+ * @param tool The libinput tool
+ * @param curve The control points as { x1, y1, x2, y2 }, each in the range
+ * [0, 1]
+ *
+ * @return A config status code
+ *
+ * @see libinput_tablet_tool_config_pressure_curve_is_available
+ * @see libinput_tablet_tool_config_pressure_curve_get
+ * @see libinput_tablet_tool_config_pressure_curve_get_default
+ */
+enum libinput_config_status
+libinput_tablet_tool_config_pressure_curve_set(struct libinput_tablet_tool *tool,
+					       const double curve[4]);
+
+/**
+ * @ingroup event_tablet
+ *
+ * Return the current pressure curve of this tool.
+ *
+ * @param tool The libinput tool
+ * @param curve Set to the control points as { x1, y1, x2, y2 }, see
+ * libinput_tablet_tool_config_pressure_curve_set()
+ *
+ * @return 0 if the returned curve is the default linear curve, 1 otherwise
+ *
+ * @see libinput_tablet_tool_config_pressure_curve_is_available
+ * @see libinput_tablet_tool_config_pressure_curve_set
+ * @see libinput_tablet_tool_config_pressure_curve_get_default
+ */
+int
+libinput_tablet_tool_config_pressure_curve_get(struct libinput_tablet_tool *tool,
+					       double curve[4]);
+
+/**
+ * @ingroup event_tablet
+ *
+ * Return the default pressure curve of this tool, this is always the
+ * linear curve { 0.0, 0.0, 1.0, 1.0 }.
+ *
+ * @param tool The libinput tool
+ * @param curve Set to the control points as { x1, y1, x2, y2 }, see
+ * libinput_tablet_tool_config_pressure_curve_set()
+ *
+ * @return 0, the default curve is the linear curve
+ *
+ * @see libinput_tablet_tool_config_pressure_curve_is_available
+ * @see libinput_tablet_tool_config_pressure_curve_set
+ * @see libinput_tablet_tool_config_pressure_curve_get
+ */
+int
+libinput_tablet_tool_config_pressure_curve_get_default(struct libinput_tablet_tool *tool,
+						       double curve[4]);
+
 /**
  * @defgroup event_tablet_pad Tablet pad events
  *
@@ -5535,6 +5898,251 @@ libinput_device_config_dwt_get_enabled(struct libinput_device *device);
 enum libinput_config_dwt_state
 libinput_device_config_dwt_get_default_enabled(struct libinput_device *device);
 
+/**
+ * @ingroup config
+ *
+ * Possible states for the low-latency mode.
+ */
+enum libinput_config_low_latency_state {
+	LIBINPUT_CONFIG_LOW_LATENCY_DISABLED,
+	LIBINPUT_CONFIG_LOW_LATENCY_ENABLED,
+};
+
+/**
+ * @ingroup config
+ *
+ * Check if this device supports a low-latency mode. By default, a touch
+ * only starts moving once it moved by more than a small threshold, this
+ * hides jitter from a resting finger but delays the start of every
+ * motion. In low-latency mode, pointer motion, two-finger scrolling and
+ * the deltas of swipe gestures follow a smoothed touch position instead,
+ * the filter follows the finger from the first movement onwards. The
+ * amount of smoothing is configurable with
+ * libinput_device_config_low_latency_set_smoothing(). Tapping and pinch
+ * gestures use the unfiltered touch position.
+ *
+ * The smoothed position only moves when the device sends a frame. If the
+ * finger stops and the device sends no further frames while it rests,
+ * the smoothed position, and thus the sum of all deltas, stops short of
+ * the finger's position until the next frame. Most touchpads keep
+ * sending frames while a finger rests on them, e.g. for pressure
+ * changes.
+ *
+ * @param device The device to configure
+ * @return 0 if this device does not support a low-latency mode, or 1
+ * otherwise.
+ *
+ * @see libinput_device_config_low_latency_set_enabled
+ * @see libinput_device_config_low_latency_get_enabled
+ * @see libinput_device_config_low_latency_get_default_enabled
+ */
+int
+libinput_device_config_low_latency_is_available(struct libinput_device *device);
+
+/**
+ * @ingroup config
+ *
+ * Enable or disable the low-latency mode.
+ *
+ * @param device The device to configure
+ * @param enable @ref LIBINPUT_CONFIG_LOW_LATENCY_DISABLED to disable
+ * low-latency mode, @ref LIBINPUT_CONFIG_LOW_LATENCY_ENABLED to enable
+ *
+ * @return A config status code. Disabling low-latency mode on a device
+ * that does not support it always succeeds.
+ *
+ * @see libinput_device_config_low_latency_is_available
+ * @see libinput_device_config_low_latency_get_enabled
+ * @see libinput_device_config_low_latency_get_default_enabled
+ */
+enum libinput_config_status
+libinput_device_config_low_latency_set_enabled(struct libinput_device *device,
+					       enum libinput_config_low_latency_state enable);
+
+/**
+ * @ingroup config
+ *
+ * Check if the low-latency mode is currently enabled on this device. If
+ * the device does not support a low-latency mode, this function returns
+ * @ref LIBINPUT_CONFIG_LOW_LATENCY_DISABLED.
+ *
+ * @param device The device to configure
+ * @return @ref LIBINPUT_CONFIG_LOW_LATENCY_DISABLED if disabled, @ref
+ * LIBINPUT_CONFIG_LOW_LATENCY_ENABLED if enabled.
+ *
+ * @see libinput_device_config_low_latency_is_available
+ * @see libinput_device_config_low_latency_set_enabled
+ * @see libinput_device_config_low_latency_get_default_enabled
+ */
+enum libinput_config_low_latency_state
+libinput_device_config_low_latency_get_enabled(struct libinput_device *device);
+
+/**
+ * @ingroup config
+ *
+ * Check if the low-latency mode is enabled on this device by default. If
+ * the device does not support a low-latency mode, this function returns
+ * @ref LIBINPUT_CONFIG_LOW_LATENCY_DISABLED.
+ *
+ * @param device The device to configure
+ * @return @ref LIBINPUT_CONFIG_LOW_LATENCY_DISABLED if disabled, @ref
+ * LIBINPUT_CONFIG_LOW_LATENCY_ENABLED if enabled.
+ *
+ * @see libinput_device_config_low_latency_is_available
+ * @see libinput_device_config_low_latency_set_enabled
+ * @see libinput_device_config_low_latency_get_enabled
+ */
+enum libinput_config_low_latency_state
+libinput_device_config_low_latency_get_default_enabled(struct libinput_device *device);
+
+/**
+ * @ingroup config
+ *
+ * Set the amount of smoothing applied in low-latency mode, in the range
+ * [0, 1]. A value of 0 applies the least smoothing and has the lowest
+ * latency but shows the most jitter from a resting or slowly moving
+ * finger. A value of 1 applies the most smoothing. Fast motion is always
+ * smoothed less than slow motion.
+ *
+ * The smoothing can be set while low-latency mode is disabled, it takes
+ * effect once low-latency mode is enabled.
+ *
+ * @param device The device to configure
+ * @param smoothing The amount of smoothing in the range [0, 1]
+ *
+ * @return A config status code
+ *
+ * @see libinput_device_config_low_latency_is_available
+ * @see libinput_device_config_low_latency_get_smoothing
+ * @see libinput_device_config_low_latency_get_default_smoothing
+ */
+enum libinput_config_status
+libinput_device_config_low_latency_set_smoothing(struct libinput_device *device,
+						 double smoothing);
+
+/**
+ * @ingroup config
+ *
+ * Get the current amount of smoothing applied in low-latency mode. If the
+ * device does not support a low-latency mode, this function returns 0.
+ *
+ * @param device The device to configure
+ * @return The amount of smoothing in the range [0, 1]
+ *
+ * @see libinput_device_config_low_latency_is_available
+ * @see libinput_device_config_low_latency_set_smoothing
+ * @see libinput_device_config_low_latency_get_default_smoothing
+ */
+double
+libinput_device_config_low_latency_get_smoothing(struct libinput_device *device);
+
+/**
+ * @ingroup config
+ *
+ * Get the default amount of smoothing applied in low-latency mode. If the
+ * device does not support a low-latency mode, this function returns 0.
+ *
+ * @param device The device to configure
+ * @return The default amount of smoothing in the range [0, 1]
+ *
+ * @see libinput_device_config_low_latency_is_available
+ * @see libinput_device_config_low_latency_set_smoothing
+ * @see libinput_device_config_low_latency_get_smoothing
+ */
+double
+libinput_device_config_low_latency_get_default_smoothing(struct libinput_device *device);
+
+/**
+ * @ingroup config
+ *
+ * Possible states for axis event batching.
+ */
+enum libinput_config_batching_state {
+	LIBINPUT_CONFIG_BATCHING_DISABLED,
+	LIBINPUT_CONFIG_BATCHING_ENABLED,
+};
+
+/**
+ * @ingroup config
+ *
+ * Check if this device supports batching of axis events. Tablets report
+ * tool positions at a higher rate than most callers consume them. With
+ * batching enabled, consecutive @ref LIBINPUT_EVENT_TABLET_TOOL_AXIS
+ * events of up to a few milliseconds are coalesced into one event that
+ * carries the intermediate samples, see
+ * libinput_event_tablet_tool_get_history_size(). Any other event flushes
+ * the batch first, so the order of events is unchanged.
+ *
+ * Batching is only useful for callers that read the intermediate samples
+ * and is disabled by default.
+ *
+ * @param device The device to configure
+ * @return 0 if this device does not support batching, or 1 otherwise.
+ *
+ * @see libinput_device_config_batching_set_enabled
+ * @see libinput_device_config_batching_get_enabled
+ * @see libinput_device_config_batching_get_default_enabled
+ */
+int
+libinput_device_config_batching_is_available(struct libinput_device *device);
+
+/**
+ * @ingroup config
+ *
+ * Enable or disable batching of axis events. Disabling batching posts any
+ * pending batch immediately.
+ *
+ * @param device The device to configure
+ * @param enable @ref LIBINPUT_CONFIG_BATCHING_DISABLED to disable
+ * batching, @ref LIBINPUT_CONFIG_BATCHING_ENABLED to enable
+ *
+ * @return A config status code. Disabling batching on a device that does
+ * not support it always succeeds.
+ *
+ * @see libinput_device_config_batching_is_available
+ * @see libinput_device_config_batching_get_enabled
+ * @see libinput_device_config_batching_get_default_enabled
+ */
+enum libinput_config_status
+libinput_device_config_batching_set_enabled(struct libinput_device *device,
+					    enum libinput_config_batching_state enable);
+
+/**
+ * @ingroup config
+ *
+ * Check if batching of axis events is currently enabled on this device.
+ * If the device does not support batching, this function returns @ref
+ * LIBINPUT_CONFIG_BATCHING_DISABLED.
+ *
+ * @param device The device to configure
+ * @return @ref LIBINPUT_CONFIG_BATCHING_DISABLED if disabled, @ref
+ * LIBINPUT_CONFIG_BATCHING_ENABLED if enabled.
+ *
+ * @see libinput_device_config_batching_is_available
+ * @see libinput_device_config_batching_set_enabled
+ * @see libinput_device_config_batching_get_default_enabled
+ */
+enum libinput_config_batching_state
+libinput_device_config_batching_get_enabled(struct libinput_device *device);
+
+/**
+ * @ingroup config
+ *
+ * Check if batching of axis events is enabled on this device by default.
+ * If the device does not support batching, this function returns @ref
+ * LIBINPUT_CONFIG_BATCHING_DISABLED.
+ *
+ * @param device The device to configure
+ * @return @ref LIBINPUT_CONFIG_BATCHING_DISABLED if disabled, @ref
+ * LIBINPUT_CONFIG_BATCHING_ENABLED if enabled.
+ *
+ * @see libinput_device_config_batching_is_available
+ * @see libinput_device_config_batching_set_enabled
+ * @see libinput_device_config_batching_get_enabled
+ */
+enum libinput_config_batching_state
+libinput_device_config_batching_get_default_enabled(struct libinput_device *device);
+
 /**
  * @ingroup config
  *
@@ -51,6 +51,10 @@ libinput_timer_arm_timer_fd(struct libinput *libinput)
 	struct itimerspec its = { { 0, 0 }, { 0, 0 } };
 	uint64_t earliest_expire = UINT64_MAX;
 
+	/* Virtual timers only expire in libinput_timer_advance() */
+	if (libinput->timer.virtual_now)
+		return;
+
 	list_for_each(timer, &libinput->timer.list, link) {
 		if (timer->expire < earliest_expire)
 			earliest_expire = timer->expire;
@@ -66,13 +70,23 @@ libinput_timer_arm_timer_fd(struct libinput *libinput)
 		log_error(libinput, "timer: timerfd_settime error: %s\n", strerror(errno));
 }
 
+/* The time the timers are checked against, see libinput_timer_advance() */
+static inline uint64_t
+libinput_timer_now(struct libinput *libinput)
+{
+	if (libinput->timer.virtual_now)
+		return libinput->timer.virtual_now;
+
+	return libinput_now(libinput);
+}
+
 void
 libinput_timer_set_flags(struct libinput_timer *timer,
 			 uint64_t expire,
 			 uint32_t flags)
 {
 #ifndef NDEBUG
-	uint64_t now = libinput_now(timer->libinput);
+	uint64_t now = libinput_timer_now(timer->libinput);
 	if (expire < now) {
 		if ((flags & TIMER_FLAG_ALLOW_NEGATIVE) == 0)
 			log_bug_libinput(timer->libinput,
@@ -112,11 +126,25 @@ libinput_timer_cancel(struct libinput_timer *timer)
 	libinput_timer_arm_timer_fd(timer->libinput);
 }
 
+static void
+libinput_timer_dispatch_expired(struct libinput *libinput, uint64_t now)
+{
+	struct libinput_timer *timer, *tmp;
+
+	list_for_each_safe(timer, tmp, &libinput->timer.list, link) {
+		if (timer->expire <= now) {
+			/* Clear the timer before calling timer_func,
+			   as timer_func may re-arm it */
+			libinput_timer_cancel(timer);
+			timer->timer_func(now, timer->timer_func_data);
+		}
+	}
+}
+
 static void
 libinput_timer_handler(void *data)
 {
 	struct libinput *libinput = data;
-	struct libinput_timer *timer, *tmp;
 	uint64_t now;
 	uint64_t discard;
 	int r;
@@ -132,14 +160,21 @@ libinput_timer_handler(void *data)
 	if (now == 0)
 		return;
 
-	list_for_each_safe(timer, tmp, &libinput->timer.list, link) {
-		if (timer->expire <= now) {
-			/* Clear the timer before calling timer_func,
-			   as timer_func may re-arm it */
-			libinput_timer_cancel(timer);
-			timer->timer_func(now, timer->timer_func_data);
-		}
-	}
+	libinput_timer_dispatch_expired(libinput, now);
+}
+
+void
+libinput_timer_advance(struct libinput *libinput, uint64_t now)
+{
+	struct itimerspec its = { { 0, 0 }, { 0, 0 } };
+
+	assert(now >= libinput->timer.virtual_now);
+
+	if (!libinput->timer.virtual_now)
+		timerfd_settime(libinput->timer.fd, TFD_TIMER_ABSTIME, &its, NULL);
+
+	libinput->timer.virtual_now = now;
+	libinput_timer_dispatch_expired(libinput, now);
 }
 
 int
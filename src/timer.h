@@ -60,6 +60,14 @@ libinput_timer_set_flags(struct libinput_timer *timer,
 void
 libinput_timer_cancel(struct libinput_timer *timer);
 
+/* Switch the timers of the context to a virtual clock at now, in us, and
+ * call all timers expired by then. From then on the timerfd is never
+ * armed and the timers only expire in here, the time must not go
+ * backwards. libinput_now() is not affected, the caller passes the
+ * virtual time in with the events. For replaying recordings in tools. */
+void
+libinput_timer_advance(struct libinput *libinput, uint64_t now);
+
 int
 libinput_timer_subsys_init(struct libinput *libinput);
 
@@ -416,6 +416,11 @@ extern struct litest_test_device litest_mouse_wheel_tilt_device;
 extern struct litest_test_device litest_lid_switch_device;
 extern struct litest_test_device litest_lid_switch_surface3_device;
 extern struct litest_test_device litest_appletouch_device;
+extern struct litest_test_device litest_touchscreen_palm_device;
+extern struct litest_test_device litest_mouse_coalesce_device;
+extern struct litest_test_device litest_tablet_smoothing_min_device;
+extern struct litest_test_device litest_tablet_smoothing_max_device;
+extern struct litest_test_device litest_keyboard_pointer_device;
 
 struct litest_test_device* devices[] = {
 	&litest_synaptics_clickpad_device,
@@ -481,6 +486,11 @@ struct litest_test_device* devices[] = {
 	&litest_lid_switch_device,
 	&litest_lid_switch_surface3_device,
 	&litest_appletouch_device,
+	&litest_touchscreen_palm_device,
+	&litest_mouse_coalesce_device,
+	&litest_tablet_smoothing_min_device,
+	&litest_tablet_smoothing_max_device,
+	&litest_keyboard_pointer_device,
 	NULL,
 };
 
@@ -232,6 +232,11 @@ enum litest_device_type {
 	LITEST_LID_SWITCH,
 	LITEST_LID_SWITCH_SURFACE3,
 	LITEST_APPLETOUCH,
+	LITEST_TOUCHSCREEN_PALM,
+	LITEST_MOUSE_COALESCE,
+	LITEST_TABLET_SMOOTHING_MIN,
+	LITEST_TABLET_SMOOTHING_MAX,
+	LITEST_KEYBOARD_POINTER,
 };
 
 enum litest_device_feature {
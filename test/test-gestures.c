@@ -1173,6 +1173,175 @@ START_TEST(gestures_spread)
 }
 END_TEST
 
+static void
+move_x_raw(struct litest_device *dev, unsigned int slot, int x)
+{
+	litest_event(dev, EV_ABS, ABS_MT_SLOT, slot);
+	litest_event(dev, EV_ABS, ABS_MT_POSITION_X, x);
+	/* WARNING: no SYN_REPORT! */
+}
+
+static double
+normalize_x(struct litest_device *dev, int dx)
+{
+	const struct input_absinfo *abs;
+
+	/* libinput normalizes to a 1000dpi mouse */
+	abs = libevdev_get_abs_info(dev->evdev, ABS_MT_POSITION_X);
+	return dx * 1000.0/25.4/abs->resolution;
+}
+
+static int
+scale_x(struct litest_device *dev, double x)
+{
+	const struct input_absinfo *abs;
+
+	abs = libevdev_get_abs_info(dev->evdev, ABS_MT_POSITION_X);
+	return (abs->maximum - abs->minimum) * x/100.0 + abs->minimum;
+}
+
+START_TEST(gestures_swipe_3fg_delta)
+{
+	struct litest_device *dev = litest_current_device();
+	struct libinput *li = dev->libinput;
+	struct libinput_event *event;
+	struct libinput_event_gesture *gevent;
+	int x0, x1, x2;
+	const int step = 20;
+
+	litest_drain_events(li);
+
+	litest_touch_down(dev, 0, 30, 50);
+	litest_touch_down(dev, 1, 40, 50);
+	litest_touch_down(dev, 2, 50, 50);
+	libinput_dispatch(li);
+	litest_touch_move_three_touches(dev,
+					30, 50,
+					40, 50,
+					50, 50,
+					20, 0,
+					10, 2);
+	libinput_dispatch(li);
+	litest_drain_events(li);
+
+	x0 = scale_x(dev, 50);
+	x1 = scale_x(dev, 60);
+	x2 = scale_x(dev, 70);
+
+	/* One finger moves: the delta is averaged over all three */
+	move_x_raw(dev, 0, x0 + step);
+	litest_event(dev, EV_SYN, SYN_REPORT, 0);
+	libinput_dispatch(li);
+
+	event = libinput_get_event(li);
+	gevent = litest_is_gesture_event(event,
+					 LIBINPUT_EVENT_GESTURE_SWIPE_UPDATE,
+					 3);
+	ck_assert_double_eq(libinput_event_gesture_get_dx_unaccelerated(gevent),
+			    normalize_x(dev, step)/3);
+	ck_assert(libinput_event_gesture_get_dy_unaccelerated(gevent) == 0.0);
+	libinput_event_destroy(event);
+	litest_assert_empty_queue(li);
+
+	/* All three move in the same frame */
+	move_x_raw(dev, 0, x0 + 2 * step);
+	move_x_raw(dev, 1, x1 + step);
+	move_x_raw(dev, 2, x2 + step);
+	litest_event(dev, EV_SYN, SYN_REPORT, 0);
+	libinput_dispatch(li);
+
+	event = libinput_get_event(li);
+	gevent = litest_is_gesture_event(event,
+					 LIBINPUT_EVENT_GESTURE_SWIPE_UPDATE,
+					 3);
+	ck_assert_double_eq(libinput_event_gesture_get_dx_unaccelerated(gevent),
+			    normalize_x(dev, step));
+	ck_assert(libinput_event_gesture_get_dy_unaccelerated(gevent) == 0.0);
+	libinput_event_destroy(event);
+	litest_assert_empty_queue(li);
+
+	litest_touch_up(dev, 0);
+	litest_touch_up(dev, 1);
+	litest_touch_up(dev, 2);
+	libinput_dispatch(li);
+}
+END_TEST
+
+START_TEST(gestures_pinch_3fg_delta)
+{
+	struct litest_device *dev = litest_current_device();
+	struct libinput *li = dev->libinput;
+	struct libinput_event *event;
+	struct libinput_event_gesture *gevent;
+	double scale = 0.0;
+	int i;
+	int x1, x2;
+	const int step = 20;
+
+	litest_drain_events(li);
+
+	litest_touch_down(dev, 0, 30, 50);
+	litest_touch_down(dev, 1, 50, 50);
+	litest_touch_down(dev, 2, 70, 50);
+	libinput_dispatch(li);
+
+	/* spread the outer fingers, the middle one stays put */
+	for (i = 1; i <= 10; i++) {
+		litest_push_event_frame(dev);
+		litest_touch_move(dev, 0, 30 - i, 50);
+		litest_touch_move(dev, 2, 70 + i, 50);
+		litest_pop_event_frame(dev);
+		libinput_dispatch(li);
+	}
+
+	event = libinput_get_event(li);
+	litest_is_gesture_event(event,
+				LIBINPUT_EVENT_GESTURE_PINCH_BEGIN,
+				3);
+	libinput_event_destroy(event);
+
+	while ((event = libinput_get_event(li)) != NULL) {
+		gevent = litest_is_gesture_event(event,
+						 LIBINPUT_EVENT_GESTURE_PINCH_UPDATE,
+						 3);
+		scale = libinput_event_gesture_get_scale(gevent);
+		libinput_event_destroy(event);
+	}
+	ck_assert_double_gt(scale, 1.0);
+
+	x1 = scale_x(dev, 50);
+	x2 = scale_x(dev, 80);
+
+	/* The pinch only follows the two outer fingers */
+	move_x_raw(dev, 1, x1 + step);
+	litest_event(dev, EV_SYN, SYN_REPORT, 0);
+	libinput_dispatch(li);
+	litest_assert_empty_queue(li);
+
+	/* One outer finger moves: the center moves half of that */
+	move_x_raw(dev, 2, x2 + step);
+	litest_event(dev, EV_SYN, SYN_REPORT, 0);
+	libinput_dispatch(li);
+
+	event = libinput_get_event(li);
+	gevent = litest_is_gesture_event(event,
+					 LIBINPUT_EVENT_GESTURE_PINCH_UPDATE,
+					 3);
+	ck_assert_double_eq(libinput_event_gesture_get_dx_unaccelerated(gevent),
+			    normalize_x(dev, step)/2);
+	ck_assert(libinput_event_gesture_get_dy_unaccelerated(gevent) == 0.0);
+	ck_assert(libinput_event_gesture_get_angle_delta(gevent) == 0.0);
+	ck_assert_double_gt(libinput_event_gesture_get_scale(gevent), scale);
+	libinput_event_destroy(event);
+	litest_assert_empty_queue(li);
+
+	litest_touch_up(dev, 0);
+	litest_touch_up(dev, 1);
+	litest_touch_up(dev, 2);
+	libinput_dispatch(li);
+}
+END_TEST
+
 START_TEST(gestures_time_usec)
 {
 	struct litest_device *dev = litest_current_device();
@@ -1292,4 +1461,7 @@ litest_setup_tests_gestures(void)
 	litest_add("gestures:swipe", gestures_3fg_buttonarea_scroll_btntool, LITEST_CLICKPAD, LITEST_SINGLE_TOUCH);
 
 	litest_add("gestures:time", gestures_time_usec, LITEST_TOUCHPAD, LITEST_SINGLE_TOUCH);
+
+	litest_add_for_device("gestures:delta", gestures_swipe_3fg_delta, LITEST_SYNAPTICS_RMI4);
+	litest_add_for_device("gestures:delta", gestures_pinch_3fg_delta, LITEST_SYNAPTICS_RMI4);
 }
@@ -375,6 +375,49 @@ START_TEST(lid_open_on_key)
 }
 END_TEST
 
+START_TEST(lid_open_on_key_repeated)
+{
+	struct litest_device *sw = litest_current_device();
+	struct litest_device *keyboard;
+	struct libinput *li = sw->libinput;
+	struct libinput_event *event;
+	int i;
+
+	keyboard = litest_add_device(li, LITEST_KEYBOARD);
+	litest_drain_events(li);
+
+	for (i = 0; i < 3; i++) {
+		litest_lid_action(sw, LIBINPUT_SWITCH_STATE_ON);
+		litest_drain_events(li);
+
+		litest_event(keyboard, EV_KEY, KEY_A, 1);
+		litest_event(keyboard, EV_SYN, SYN_REPORT, 0);
+		litest_event(keyboard, EV_KEY, KEY_A, 0);
+		litest_event(keyboard, EV_SYN, SYN_REPORT, 0);
+		libinput_dispatch(li);
+
+		event = libinput_get_event(li);
+		litest_is_switch_event(event,
+				       LIBINPUT_SWITCH_LID,
+				       LIBINPUT_SWITCH_STATE_OFF);
+		libinput_event_destroy(event);
+		litest_assert_only_typed_events(li,
+						LIBINPUT_EVENT_KEYBOARD_KEY);
+
+		/* the lid is known to be open, keys are just keys */
+		litest_keyboard_key(keyboard, KEY_A, true);
+		litest_keyboard_key(keyboard, KEY_A, false);
+		litest_assert_only_typed_events(li,
+						LIBINPUT_EVENT_KEYBOARD_KEY);
+
+		litest_lid_action(sw, LIBINPUT_SWITCH_STATE_OFF);
+		litest_assert_empty_queue(li);
+	}
+
+	litest_delete_device(keyboard);
+}
+END_TEST
+
 START_TEST(lid_open_on_key_touchpad_enabled)
 {
 	struct litest_device *sw = litest_current_device();
@@ -555,6 +598,83 @@ START_TEST(lid_update_hw_on_key_closed_on_init)
 }
 END_TEST
 
+static void
+lid_keyboard_listener_log(struct libinput *li,
+			  enum libinput_log_priority priority,
+			  const char *format,
+			  va_list args)
+{
+	unsigned int *ncalls = libinput_get_user_data(li);
+	char buf[256];
+
+	if (!strstr(format, "keyboard listener called"))
+		return;
+
+	vsnprintf(buf, sizeof(buf), format, args);
+	ck_assert_int_eq(sscanf(buf,
+				"lid: keyboard listener called %u times",
+				ncalls),
+			 1);
+}
+
+START_TEST(lid_keyboard_listener_ignores_pointer)
+{
+	struct libinput *li;
+	struct litest_device *sw, *keyboard;
+	struct libinput_event *event;
+	unsigned int ncalls = 0;
+	int i;
+
+	li = litest_create_context();
+	sw = litest_add_device(li, LITEST_LID_SWITCH);
+	keyboard = litest_add_device(li, LITEST_KEYBOARD_POINTER);
+	litest_drain_events(li);
+
+	libinput_set_user_data(li, &ncalls);
+	libinput_log_set_handler(li, lid_keyboard_listener_log);
+	libinput_log_set_priority(li, LIBINPUT_LOG_PRIORITY_DEBUG);
+
+	litest_lid_action(sw, LIBINPUT_SWITCH_STATE_ON);
+	litest_drain_events(li);
+
+	/* Pointer events from the keyboard must not reach the lid's key
+	 * listener, so they don't open the lid either */
+	for (i = 0; i < 10; i++) {
+		litest_event(keyboard, EV_REL, REL_X, 1);
+		litest_event(keyboard, EV_SYN, SYN_REPORT, 0);
+	}
+	litest_button_click(keyboard, BTN_LEFT, true);
+	litest_button_click(keyboard, BTN_LEFT, false);
+	libinput_dispatch(li);
+
+	while ((event = libinput_get_event(li))) {
+		ck_assert_int_ne(libinput_event_get_type(event),
+				 LIBINPUT_EVENT_SWITCH_TOGGLE);
+		libinput_event_destroy(event);
+	}
+
+	/* The first key opens the lid and the listener goes away */
+	litest_keyboard_key(keyboard, KEY_A, true);
+	litest_keyboard_key(keyboard, KEY_A, false);
+	libinput_dispatch(li);
+
+	event = libinput_get_event(li);
+	litest_is_switch_event(event,
+			       LIBINPUT_SWITCH_LID,
+			       LIBINPUT_SWITCH_STATE_OFF);
+	libinput_event_destroy(event);
+	litest_assert_only_typed_events(li, LIBINPUT_EVENT_KEYBOARD_KEY);
+
+	/* The lid logs the listener calls when it goes away */
+	litest_delete_device(sw);
+	litest_drain_events(li);
+	ck_assert_int_eq(ncalls, 1);
+
+	litest_delete_device(keyboard);
+	libinput_unref(li);
+}
+END_TEST
+
 void
 litest_setup_tests_lid(void)
 {
@@ -569,9 +689,11 @@ litest_setup_tests_lid(void)
 	litest_add("lid:disable_touchpad", lid_disable_touchpad_already_open, LITEST_SWITCH, LITEST_ANY);
 
 	litest_add("lid:keyboard", lid_open_on_key, LITEST_SWITCH, LITEST_ANY);
+	litest_add("lid:keyboard", lid_open_on_key_repeated, LITEST_SWITCH, LITEST_ANY);
 	litest_add("lid:keyboard", lid_open_on_key_touchpad_enabled, LITEST_SWITCH, LITEST_ANY);
 
 	litest_add_no_device("lid:keyboard", lid_suspend_with_keyboard);
+	litest_add_no_device("lid:keyboard", lid_keyboard_listener_ignores_pointer);
 	litest_add_no_device("lid:disable_touchpad", lid_suspend_with_touchpad);
 
 	litest_add_for_device("lid:buggy", lid_update_hw_on_key, LITEST_LID_SWITCH_SURFACE3);
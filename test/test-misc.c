@@ -730,6 +730,49 @@ START_TEST(ratelimit_helpers)
 }
 END_TEST
 
+START_TEST(fuzz_filter_helpers)
+{
+	int fuzz[10] = { 0, 0, 1, 2, 3, 4, 5, 10, 100, 0 };
+	int values[10], accepted[10] = {0}, expected[10] = {0};
+	unsigned int seed = 0x4b1d;
+	uint32_t changed, expected_changed;
+	int i, n;
+
+	for (n = 0; n < 1000; n++) {
+		expected_changed = 0;
+
+		for (i = 0; i < 10; i++) {
+			/* small steps around the accepted value and the
+			 * occasional big jump, in both directions */
+			values[i] = expected[i] + (int)(rand_r(&seed) % 25) - 12;
+			if (rand_r(&seed) % 10 == 0)
+				values[i] = (int)(rand_r(&seed) % 2000) - 1000;
+
+			if (abs(values[i] - expected[i]) > fuzz[i]) {
+				expected[i] = values[i];
+				expected_changed |= 1 << i;
+			}
+		}
+
+		changed = filter_fuzz_packed(values, accepted, fuzz, 10);
+		ck_assert_int_eq(changed, expected_changed);
+		for (i = 0; i < 10; i++)
+			ck_assert_int_eq(accepted[i], expected[i]);
+	}
+
+	/* exactly on the fuzz is filtered, one more is not */
+	accepted[0] = 100;
+	fuzz[0] = 4;
+	values[0] = 104;
+	ck_assert_int_eq(filter_fuzz_packed(values, accepted, fuzz, 1), 0);
+	values[0] = 96;
+	ck_assert_int_eq(filter_fuzz_packed(values, accepted, fuzz, 1), 0);
+	values[0] = 95;
+	ck_assert_int_eq(filter_fuzz_packed(values, accepted, fuzz, 1), 1);
+	ck_assert_int_eq(accepted[0], 95);
+}
+END_TEST
+
 struct parser_test {
 	char *tag;
 	int expected_value;
@@ -1044,6 +1087,51 @@ START_TEST(pressure_range_prop_parser)
 }
 END_TEST
 
+struct parser_test_motion_coalesce {
+	char *tag;
+	bool success;
+	unsigned int window_ms, count;
+};
+
+START_TEST(motion_coalesce_prop_parser)
+{
+	struct parser_test_motion_coalesce tests[] = {
+		{ "4:8", true, 4, 8 },
+		{ "2:0", true, 2, 0 },
+		{ "0:16", false, 0, 0 },
+		{ "0:0", false, 0, 0 },
+		{ "-1:8", false, 0, 0 },
+		{ "4:-8", false, 0, 0 },
+		{ "4", false, 0, 0 },
+		{ "4:8:2", false, 0, 0 },
+		{ "", false, 0, 0 },
+		{ "abcd", false, 0, 0 },
+		{ NULL, false, 0, 0 }
+	};
+	int i;
+	unsigned int window_ms, count;
+	bool success;
+
+	for (i = 0; tests[i].tag != NULL; i++) {
+		window_ms = count = 0xad;
+		success = parse_motion_coalesce_property(tests[i].tag,
+							 &window_ms,
+							 &count);
+		ck_assert(success == tests[i].success);
+		if (success) {
+			ck_assert_int_eq(window_ms, tests[i].window_ms);
+			ck_assert_int_eq(count, tests[i].count);
+		} else {
+			ck_assert_int_eq(window_ms, 0xad);
+			ck_assert_int_eq(count, 0xad);
+		}
+	}
+
+	success = parse_motion_coalesce_property(NULL, NULL, NULL);
+	ck_assert(success == false);
+}
+END_TEST
+
 START_TEST(time_conversion)
 {
 	ck_assert_int_eq(us(10), 10);
@@ -1300,6 +1388,7 @@ litest_setup_tests_misc(void)
 
 	litest_add_no_device("misc:matrix", matrix_helpers);
 	litest_add_no_device("misc:ratelimit", ratelimit_helpers);
+	litest_add_no_device("misc:fuzz", fuzz_filter_helpers);
 	litest_add_no_device("misc:parser", dpi_parser);
 	litest_add_no_device("misc:parser", wheel_click_parser);
 	litest_add_no_device("misc:parser", wheel_click_count_parser);
@@ -1308,6 +1397,7 @@ litest_setup_tests_misc(void)
 	litest_add_no_device("misc:parser", reliability_prop_parser);
 	litest_add_no_device("misc:parser", calibration_prop_parser);
 	litest_add_no_device("misc:parser", pressure_range_prop_parser);
+	litest_add_no_device("misc:parser", motion_coalesce_prop_parser);
 	litest_add_no_device("misc:parser", safe_atoi_test);
 	litest_add_no_device("misc:parser", safe_atod_test);
 	litest_add_no_device("misc:parser", strsplit_test);
@@ -33,6 +33,8 @@
 #include <values.h>
 
 #include "libinput-util.h"
+#include "evdev.h"
+#include "filter.h"
 #include "litest.h"
 
 static void
@@ -325,6 +327,182 @@ test_unaccel_event(struct litest_device *dev, int dx, int dy)
       litest_drain_events(dev->libinput);
 }
 
+START_TEST(pointer_motion_coalesce_count)
+{
+	struct litest_device *dev = litest_current_device();
+	struct libinput *li = dev->libinput;
+	struct libinput_event *event;
+	struct libinput_event_pointer *ptrev;
+	double dx = 0.0;
+	int i, nevents = 0;
+
+	litest_drain_events(li);
+
+	/* The device coalesces 4 events or 20ms, whichever comes first */
+	for (i = 0; i < 8; i++) {
+		litest_event(dev, EV_REL, REL_X, 1);
+		litest_event(dev, EV_SYN, SYN_REPORT, 0);
+	}
+	libinput_dispatch(li);
+
+	while ((event = libinput_get_event(li))) {
+		ptrev = litest_is_motion_event(event);
+		dx += libinput_event_pointer_get_dx_unaccelerated(ptrev);
+		nevents++;
+		libinput_event_destroy(event);
+	}
+
+	ck_assert_int_eq(nevents, 2);
+	ck_assert_double_eq(dx, 8.0);
+}
+END_TEST
+
+START_TEST(pointer_motion_coalesce_window)
+{
+	struct litest_device *dev = litest_current_device();
+	struct libinput *li = dev->libinput;
+	struct libinput_event *event;
+	struct libinput_event_pointer *ptrev;
+
+	litest_drain_events(li);
+
+	litest_event(dev, EV_REL, REL_X, 1);
+	litest_event(dev, EV_SYN, SYN_REPORT, 0);
+	litest_event(dev, EV_REL, REL_X, 2);
+	litest_event(dev, EV_SYN, SYN_REPORT, 0);
+	libinput_dispatch(li);
+	litest_assert_empty_queue(li);
+
+	/* the window expires and posts the sum of both */
+	msleep(25);
+	libinput_dispatch(li);
+
+	event = libinput_get_event(li);
+	ptrev = litest_is_motion_event(event);
+	ck_assert_double_eq(libinput_event_pointer_get_dx_unaccelerated(ptrev),
+			    3.0);
+	libinput_event_destroy(event);
+	litest_assert_empty_queue(li);
+
+	/* a button flushes the pending motion first */
+	litest_event(dev, EV_REL, REL_X, 1);
+	litest_event(dev, EV_SYN, SYN_REPORT, 0);
+	litest_button_click(dev, BTN_LEFT, true);
+	libinput_dispatch(li);
+
+	event = libinput_get_event(li);
+	litest_is_motion_event(event);
+	libinput_event_destroy(event);
+	event = libinput_get_event(li);
+	litest_is_button_event(event, BTN_LEFT, LIBINPUT_BUTTON_STATE_PRESSED);
+	libinput_event_destroy(event);
+
+	litest_button_click(dev, BTN_LEFT, false);
+	litest_drain_events(li);
+}
+END_TEST
+
+struct accel_sample {
+	uint64_t time;
+	struct device_float_coords raw;
+	struct normalized_coords accel;
+};
+
+static size_t
+accel_replay_device(struct litest_device *dev,
+		    struct accel_sample *samples,
+		    size_t nsamples)
+{
+	struct libinput *li = dev->libinput;
+	struct libinput_event *event;
+	struct libinput_event_pointer *ptrev;
+	size_t i, n = 0;
+
+	litest_drain_events(li);
+
+	/* Varying speed and direction, a pause every few frames so the
+	 * velocity trackers see more than one time delta */
+	for (i = 0; i < nsamples; i++) {
+		litest_event(dev, EV_REL, REL_X, 1 + (i * 7) % 23);
+		litest_event(dev, EV_REL, REL_Y, (i % 2) ? -(int)(i % 5) : 3);
+		litest_event(dev, EV_SYN, SYN_REPORT, 0);
+		if (i % 8 == 7)
+			msleep(3);
+	}
+	libinput_dispatch(li);
+
+	while ((event = libinput_get_event(li))) {
+		ptrev = litest_is_motion_event(event);
+		ck_assert_int_lt(n, nsamples);
+		samples[n].time = libinput_event_pointer_get_time_usec(ptrev);
+		samples[n].raw.x = libinput_event_pointer_get_dx_unaccelerated(ptrev);
+		samples[n].raw.y = libinput_event_pointer_get_dy_unaccelerated(ptrev);
+		samples[n].accel.x = libinput_event_pointer_get_dx(ptrev);
+		samples[n].accel.y = libinput_event_pointer_get_dy(ptrev);
+		n++;
+		libinput_event_destroy(event);
+	}
+
+	return n;
+}
+
+START_TEST(pointer_accel_batch_matches_sequential)
+{
+	struct litest_device *dev = litest_current_device();
+	struct libinput_device *device = dev->libinput_device;
+	struct evdev_device *evdev = evdev_device(device);
+	enum libinput_config_accel_profile profiles[] = {
+		LIBINPUT_CONFIG_ACCEL_PROFILE_ADAPTIVE,
+		LIBINPUT_CONFIG_ACCEL_PROFILE_FLAT,
+	};
+	struct accel_sample samples[32];
+	struct device_float_coords raw[ARRAY_LENGTH(samples)];
+	struct normalized_coords accel[ARRAY_LENGTH(samples)];
+	uint64_t times[ARRAY_LENGTH(samples)];
+	size_t p, i, n;
+
+	for (p = 0; p < ARRAY_LENGTH(profiles); p++) {
+		struct motion_filter *filter;
+		enum libinput_config_status status;
+		double speed = 0.5;
+
+		/* A new profile is a new filter, so the device's filter and
+		 * ours start from the same state */
+		status = libinput_device_config_accel_set_profile(device,
+								  profiles[p]);
+		litest_assert_int_eq(status, LIBINPUT_CONFIG_STATUS_SUCCESS);
+		status = libinput_device_config_accel_set_speed(device, speed);
+		litest_assert_int_eq(status, LIBINPUT_CONFIG_STATUS_SUCCESS);
+
+		/* The device dispatches each frame on its own */
+		n = accel_replay_device(dev, samples, ARRAY_LENGTH(samples));
+		ck_assert_int_eq(n, ARRAY_LENGTH(samples));
+
+		if (profiles[p] == LIBINPUT_CONFIG_ACCEL_PROFILE_FLAT)
+			filter = create_pointer_accelerator_filter_flat(evdev->dpi);
+		else
+			filter = create_pointer_accelerator_filter_linear(evdev->dpi);
+		ck_assert_notnull(filter);
+		ck_assert(filter_set_speed(filter, speed));
+
+		for (i = 0; i < n; i++) {
+			raw[i] = samples[i].raw;
+			times[i] = samples[i].time;
+		}
+
+		/* The same frames in one batch */
+		filter_dispatch_batch(filter, raw, evdev, times, accel, n);
+
+		for (i = 0; i < n; i++) {
+			ck_assert_double_eq(accel[i].x, samples[i].accel.x);
+			ck_assert_double_eq(accel[i].y, samples[i].accel.y);
+		}
+
+		filter_destroy(filter);
+	}
+}
+END_TEST
+
 START_TEST(pointer_motion_unaccel)
 {
       struct litest_device *dev = litest_current_device();
@@ -343,6 +521,107 @@ START_TEST(pointer_motion_unaccel)
 }
 END_TEST
 
+static struct device_float_coords
+predictor_velocity(const double *x, const double *y, const uint64_t *t,
+		   size_t n)
+{
+	struct motion_predictor predictor;
+	size_t i;
+
+	motion_predictor_reset(&predictor);
+	for (i = 0; i < n; i++) {
+		struct device_float_coords p = { x[i], y[i] };
+
+		motion_predictor_push(&predictor, &p, t[i]);
+	}
+
+	return motion_predictor_velocity(&predictor);
+}
+
+START_TEST(motion_predictor_constant_velocity)
+{
+	/* 2 units right and 1 unit up every 8ms */
+	double x[] = { 0, 2, 4, 6 };
+	double y[] = { 0, -1, -2, -3 };
+	uint64_t t[] = { s2us(1), s2us(1) + ms2us(8),
+			 s2us(1) + ms2us(16), s2us(1) + ms2us(24) };
+	struct device_float_coords v;
+
+	v = predictor_velocity(x, y, t, 1);
+	ck_assert_double_eq(v.x, 0.0);
+	ck_assert_double_eq(v.y, 0.0);
+
+	v = predictor_velocity(x, y, t, 2);
+	ck_assert_double_eq_tol(v.x, 2.0/ms2us(8), 1e-12);
+	ck_assert_double_eq_tol(v.y, -1.0/ms2us(8), 1e-12);
+
+	v = predictor_velocity(x, y, t, ARRAY_LENGTH(t));
+	ck_assert_double_eq_tol(v.x, 2.0/ms2us(8), 1e-12);
+	ck_assert_double_eq_tol(v.y, -1.0/ms2us(8), 1e-12);
+}
+END_TEST
+
+START_TEST(motion_predictor_clustered_timestamps)
+{
+	/* Samples a microsecond apart, a fit would give 1 unit/us */
+	double x[] = { 0, 1, 2, 3 };
+	double y[] = { 0, 0, 0, 0 };
+	uint64_t t[] = { s2us(1), s2us(1) + 1, s2us(1) + 2, s2us(1) + 3 };
+	/* A fit over these would be 20% faster than the history moved */
+	double xc[] = { 6, 6, 9, 9 };
+	uint64_t tc[] = { s2us(1) + 271, s2us(1) + 987,
+			  s2us(1) + 1899, s2us(1) + 2677 };
+	struct device_float_coords v;
+
+	v = predictor_velocity(x, y, t, ARRAY_LENGTH(t));
+	ck_assert_double_eq(v.x, 0.0);
+	ck_assert_double_eq(v.y, 0.0);
+
+	v = predictor_velocity(xc, y, tc, ARRAY_LENGTH(tc));
+	ck_assert_double_eq_tol(v.x, 3.0/2406, 1e-12);
+	ck_assert_double_eq(v.y, 0.0);
+}
+END_TEST
+
+START_TEST(pointer_motion_predicted)
+{
+	struct litest_device *dev = litest_current_device();
+	struct libinput *li = dev->libinput;
+	struct libinput_event *event;
+	struct libinput_event_pointer *ptrev;
+	int i;
+
+	litest_drain_events(li);
+
+	for (i = 0; i < 5; i++) {
+		litest_event(dev, EV_REL, REL_X, 5);
+		litest_event(dev, EV_SYN, SYN_REPORT, 0);
+	}
+	libinput_dispatch(li);
+
+	while ((event = libinput_get_event(li))) {
+		double dx, dy;
+
+		ptrev = litest_is_motion_event(event);
+		dx = libinput_event_pointer_get_dx(ptrev);
+		dy = libinput_event_pointer_get_dy(ptrev);
+
+		ck_assert_double_eq(libinput_event_pointer_get_predicted_dx(ptrev, 0),
+				    dx);
+		ck_assert_double_ge(libinput_event_pointer_get_predicted_dx(ptrev, ms2us(10)),
+				    dx);
+		ck_assert_double_eq(libinput_event_pointer_get_predicted_dy(ptrev, ms2us(10)),
+				    dy);
+
+		/* Intervals beyond the limit are clamped */
+		ck_assert_double_eq(libinput_event_pointer_get_predicted_dx(ptrev, ms2us(50)),
+				    libinput_event_pointer_get_predicted_dx(ptrev, s2us(5)));
+
+		libinput_event_destroy(event);
+	}
+}
+END_TEST
+
 static void
 test_button_event(struct litest_device *dev, unsigned int button, int state)
 {
@@ -2084,6 +2363,11 @@ litest_setup_tests_pointer(void)
 	litest_add_ranged("pointer:motion", pointer_motion_relative_min_decel, LITEST_RELATIVE, LITEST_ANY, &compass);
 	litest_add("pointer:motion", pointer_motion_absolute, LITEST_ABSOLUTE, LITEST_ANY);
 	litest_add("pointer:motion", pointer_motion_unaccel, LITEST_RELATIVE, LITEST_ANY);
+	litest_add("pointer:motion", pointer_motion_predicted, LITEST_RELATIVE, LITEST_ANY);
+	litest_add_no_device("pointer:motion", motion_predictor_constant_velocity);
+	litest_add_no_device("pointer:motion", motion_predictor_clustered_timestamps);
+	litest_add_for_device("pointer:motion", pointer_motion_coalesce_count, LITEST_MOUSE_COALESCE);
+	litest_add_for_device("pointer:motion", pointer_motion_coalesce_window, LITEST_MOUSE_COALESCE);
 	litest_add("pointer:button", pointer_button, LITEST_BUTTON, LITEST_CLICKPAD);
 	litest_add_no_device("pointer:button", pointer_button_auto_release);
 	litest_add_no_device("pointer:button", pointer_seat_button_count);
@@ -2112,6 +2396,7 @@ litest_setup_tests_pointer(void)
 
 	litest_add("pointer:accel", pointer_accel_defaults, LITEST_RELATIVE, LITEST_ANY);
 	litest_add("pointer:accel", pointer_accel_invalid, LITEST_RELATIVE, LITEST_ANY);
+	litest_add_for_device("pointer:accel", pointer_accel_batch_matches_sequential, LITEST_MOUSE);
 	litest_add("pointer:accel", pointer_accel_defaults_absolute, LITEST_ABSOLUTE, LITEST_RELATIVE);
 	litest_add("pointer:accel", pointer_accel_defaults_absolute_relative, LITEST_ABSOLUTE|LITEST_RELATIVE, LITEST_ANY);
 	litest_add("pointer:accel", pointer_accel_direction_change, LITEST_RELATIVE, LITEST_ANY);
@@ -1791,6 +1791,328 @@ START_TEST(motion_event_state)
 }
 END_TEST
 
+START_TEST(motion_smoothing_settles)
+{
+	struct litest_device *dev = litest_current_device();
+	struct libinput *li = dev->libinput;
+	struct libinput_event *event;
+	struct libinput_event_tablet_tool *tablet_event;
+	double x = 0, y = 0, expected_x, expected_y;
+	int i;
+	struct axis_replacement axes[] = {
+		{ ABS_DISTANCE, 10 },
+		{ ABS_PRESSURE, 0 },
+		{ -1, -1 }
+	};
+
+	/* The first event in proximity is never smoothed */
+	litest_drain_events(li);
+	litest_tablet_proximity_in(dev, 50, 50, axes);
+	libinput_dispatch(li);
+	event = libinput_get_event(li);
+	tablet_event = litest_is_tablet_event(event,
+					      LIBINPUT_EVENT_TABLET_TOOL_PROXIMITY);
+	expected_x = libinput_event_tablet_tool_get_x(tablet_event);
+	expected_y = libinput_event_tablet_tool_get_y(tablet_event);
+	libinput_event_destroy(event);
+	litest_tablet_proximity_out(dev);
+	litest_drain_events(li);
+
+	litest_tablet_proximity_in(dev, 10, 10, axes);
+	for (i = 1; i <= 10; i++)
+		litest_tablet_motion(dev, 10 + i * 4, 10 + i * 4, axes);
+	litest_drain_events(li);
+
+	/* Hold still but change the distance so we get axis events, the
+	 * smoothed position must end up exactly on the real one */
+	for (i = 0; i < 10; i++) {
+		litest_axis_set_value(axes, ABS_DISTANCE, 20 + i);
+		litest_tablet_motion(dev, 50, 50, axes);
+	}
+	libinput_dispatch(li);
+
+	while ((event = libinput_get_event(li))) {
+		tablet_event = litest_is_tablet_event(event,
+						      LIBINPUT_EVENT_TABLET_TOOL_AXIS);
+		x = libinput_event_tablet_tool_get_x(tablet_event);
+		y = libinput_event_tablet_tool_get_y(tablet_event);
+		libinput_event_destroy(event);
+	}
+
+	litest_assert_double_eq(x, expected_x);
+	litest_assert_double_eq(y, expected_y);
+}
+END_TEST
+
+/* The position in device units as litest sends it for a percentage */
+static int
+smoothing_abs_value(struct litest_device *dev, unsigned int code, int percent)
+{
+	const struct input_absinfo *abs;
+
+	abs = libevdev_get_abs_info(dev->evdev, code);
+	return (abs->maximum - abs->minimum) * percent/100.0 + abs->minimum;
+}
+
+/* A position in mm as libinput reports it back in device units */
+static int
+smoothing_mm_to_abs(struct litest_device *dev, unsigned int code, double mm)
+{
+	const struct input_absinfo *abs;
+
+	abs = libevdev_get_abs_info(dev->evdev, code);
+	return round(mm * abs->resolution) + abs->minimum;
+}
+
+static int
+smoothing_event_value(struct litest_device *dev,
+		      struct libinput_event_tablet_tool *tev,
+		      unsigned int code)
+{
+	double mm;
+
+	if (code == ABS_X)
+		mm = libinput_event_tablet_tool_get_x(tev);
+	else
+		mm = libinput_event_tablet_tool_get_y(tev);
+
+	return smoothing_mm_to_abs(dev, code, mm);
+}
+
+static unsigned int
+smoothing_window(struct litest_device *dev)
+{
+	struct udev_device *d;
+	const char *prop;
+	unsigned int window = TABLET_HISTORY_LENGTH;
+
+	d = libinput_device_get_udev_device(dev->libinput_device);
+	litest_assert_ptr_notnull(d);
+
+	prop = udev_device_get_property_value(d,
+					      "LIBINPUT_ATTR_TABLET_SMOOTHING_WINDOW");
+	if (prop)
+		window = atoi(prop);
+	udev_device_unref(d);
+
+	return window;
+}
+
+static inline uint64_t
+now_usec(void)
+{
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return s2us(ts.tv_sec) + ts.tv_nsec/1000;
+}
+
+START_TEST(motion_batching)
+{
+	struct litest_device *dev = litest_current_device();
+	struct libinput *li = dev->libinput;
+	struct libinput_device *device = dev->libinput_device;
+	struct libinput_event *event;
+	struct libinput_event_tablet_tool *tev;
+	enum libinput_config_status status;
+	struct tablet_history history;
+	struct tablet_axes first = {0}, sent[5];
+	uint64_t before[5], after[5];
+	unsigned int idx, nframes;
+	int i;
+	struct axis_replacement axes[] = {
+		{ ABS_DISTANCE, 10 },
+		{ ABS_PRESSURE, 0 },
+		{ -1, -1 }
+	};
+
+	if (!libevdev_has_event_code(dev->evdev, EV_KEY, BTN_STYLUS))
+		return;
+
+	ck_assert(libinput_device_config_batching_is_available(device));
+	ck_assert_int_eq(libinput_device_config_batching_get_default_enabled(device),
+			 LIBINPUT_CONFIG_BATCHING_DISABLED);
+	status = libinput_device_config_batching_set_enabled(device, 3);
+	ck_assert_int_eq(status, LIBINPUT_CONFIG_STATUS_INVALID);
+	status = libinput_device_config_batching_set_enabled(device,
+					LIBINPUT_CONFIG_BATCHING_ENABLED);
+	ck_assert_int_eq(status, LIBINPUT_CONFIG_STATUS_SUCCESS);
+	ck_assert_int_eq(libinput_device_config_batching_get_enabled(device),
+			 LIBINPUT_CONFIG_BATCHING_ENABLED);
+
+	/* The samples carry the smoothed position, run what we send
+	 * through the same smoothing to know what to expect */
+	tablet_history_init(&history, smoothing_window(dev));
+
+	litest_tablet_proximity_in(dev, 10, 10, axes);
+	litest_drain_events(li);
+	first.point.x = smoothing_abs_value(dev, ABS_X, 10);
+	first.point.y = smoothing_abs_value(dev, ABS_Y, 10);
+	tablet_history_push(&history, &first);
+
+	for (i = 0; i < 5; i++) {
+		int pos = 15 + i * 5;
+
+		before[i] = now_usec();
+		litest_tablet_motion(dev, pos, pos, axes);
+		after[i] = now_usec();
+
+		memset(&sent[i], 0, sizeof(sent[i]));
+		sent[i].point.x = smoothing_abs_value(dev, ABS_X, pos);
+		sent[i].point.y = smoothing_abs_value(dev, ABS_Y, pos);
+		tablet_history_push(&history, &sent[i]);
+		tablet_history_smoothen(&history, &sent[i]);
+	}
+
+	/* The button press posts the batched motion before the button */
+	litest_event(dev, EV_KEY, BTN_STYLUS, 1);
+	litest_event(dev, EV_SYN, SYN_REPORT, 0);
+	libinput_dispatch(li);
+
+	/* Frames closer together than TABLET_BATCH_WINDOW end up in one
+	 * event, the earlier ones in its history. How many batches there
+	 * are depends on the timing of the frames, but every frame is in
+	 * exactly one of them, in order. */
+	nframes = 0;
+	while (libinput_next_event_type(li) == LIBINPUT_EVENT_TABLET_TOOL_AXIS) {
+		unsigned int nhistory;
+
+		event = libinput_get_event(li);
+		tev = litest_is_tablet_event(event,
+					     LIBINPUT_EVENT_TABLET_TOOL_AXIS);
+		nhistory = libinput_event_tablet_tool_get_history_size(tev);
+		ck_assert_int_le(nframes + nhistory + 1, ARRAY_LENGTH(sent));
+
+		for (idx = 0; idx < nhistory; idx++) {
+			struct tablet_axes *s = &sent[nframes++];
+			double x, y;
+			uint64_t time;
+
+			x = libinput_event_tablet_tool_get_history_x(tev, idx);
+			y = libinput_event_tablet_tool_get_history_y(tev, idx);
+			ck_assert_int_eq(smoothing_mm_to_abs(dev, ABS_X, x),
+					 s->point.x);
+			ck_assert_int_eq(smoothing_mm_to_abs(dev, ABS_Y, y),
+					 s->point.y);
+
+			time = libinput_event_tablet_tool_get_history_time_usec(tev, idx);
+			ck_assert_int_ge(time, before[nframes - 1]);
+			ck_assert_int_le(time, after[nframes - 1]);
+		}
+
+		ck_assert_int_eq(smoothing_event_value(dev, tev, ABS_X),
+				 sent[nframes].point.x);
+		ck_assert_int_eq(smoothing_event_value(dev, tev, ABS_Y),
+				 sent[nframes].point.y);
+		ck_assert_int_ge(libinput_event_tablet_tool_get_time_usec(tev),
+				 before[nframes]);
+		ck_assert_int_le(libinput_event_tablet_tool_get_time_usec(tev),
+				 after[nframes]);
+		nframes++;
+		libinput_event_destroy(event);
+	}
+	ck_assert_int_eq(nframes, ARRAY_LENGTH(sent));
+
+	event = libinput_get_event(li);
+	tev = litest_is_tablet_event(event, LIBINPUT_EVENT_TABLET_TOOL_BUTTON);
+	ck_assert_int_eq(libinput_event_tablet_tool_get_button(tev),
+			 BTN_STYLUS);
+	libinput_event_destroy(event);
+	litest_assert_empty_queue(li);
+
+	libinput_device_config_batching_set_enabled(device,
+					LIBINPUT_CONFIG_BATCHING_DISABLED);
+}
+END_TEST
+
+START_TEST(motion_smoothing_window_min)
+{
+	struct litest_device *dev = litest_current_device();
+	struct libinput *li = dev->libinput;
+	struct libinput_event *event;
+	struct libinput_event_tablet_tool *tev;
+	int i;
+	struct axis_replacement axes[] = {
+		{ ABS_PRESSURE, 0 },
+		{ -1, -1 }
+	};
+
+	litest_drain_events(li);
+
+	litest_tablet_proximity_in(dev, 10, 10, axes);
+	libinput_dispatch(li);
+	event = libinput_get_event(li);
+	tev = litest_is_tablet_event(event,
+				     LIBINPUT_EVENT_TABLET_TOOL_PROXIMITY);
+	libinput_event_destroy(event);
+
+	/* With a window of 1 every event is exactly where the tool is, even
+	 * when it jumps back and forth */
+	for (i = 1; i <= 20; i++) {
+		int x = 10 + i * 3,
+		    y = 10 + i * 2 + (i % 2 ? 5 : 0);
+
+		litest_tablet_motion(dev, x, y, axes);
+		libinput_dispatch(li);
+
+		event = libinput_get_event(li);
+		tev = litest_is_tablet_event(event,
+					     LIBINPUT_EVENT_TABLET_TOOL_AXIS);
+		litest_assert_int_eq(smoothing_event_value(dev, tev, ABS_X),
+				     smoothing_abs_value(dev, ABS_X, x));
+		litest_assert_int_eq(smoothing_event_value(dev, tev, ABS_Y),
+				     smoothing_abs_value(dev, ABS_Y, y));
+		libinput_event_destroy(event);
+		litest_assert_empty_queue(li);
+	}
+}
+END_TEST
+
+START_TEST(motion_smoothing_window_max)
+{
+	struct litest_device *dev = litest_current_device();
+	struct libinput *li = dev->libinput;
+	struct libinput_event *event;
+	struct libinput_event_tablet_tool *tev;
+	const int window = 8;
+	int64_t x0, x1;
+	int i;
+	struct axis_replacement axes[] = {
+		{ ABS_PRESSURE, 0 },
+		{ -1, -1 }
+	};
+
+	x0 = smoothing_abs_value(dev, ABS_X, 20);
+	x1 = smoothing_abs_value(dev, ABS_X, 60);
+
+	litest_drain_events(li);
+	litest_tablet_proximity_in(dev, 20, 20, axes);
+	litest_drain_events(li);
+
+	/* Jump in x and stay there, only y keeps moving so we get events.
+	 * Each event replaces one more of the window samples, x must only
+	 * arrive after a full window of them. */
+	for (i = 1; i <= window + 2; i++) {
+		int n = min(i, window);
+		int expected = ((window - n) * x0 + n * x1)/window;
+
+		litest_tablet_motion(dev, 60, 20 + i, axes);
+		libinput_dispatch(li);
+
+		event = libinput_get_event(li);
+		tev = litest_is_tablet_event(event,
+					     LIBINPUT_EVENT_TABLET_TOOL_AXIS);
+		litest_assert_int_eq(smoothing_event_value(dev, tev, ABS_X),
+				     expected);
+		if (i < window)
+			litest_assert_int_ne(smoothing_event_value(dev, tev, ABS_X),
+					     x1);
+		libinput_event_destroy(event);
+		litest_assert_empty_queue(li);
+	}
+}
+END_TEST
+
 START_TEST(motion_outside_bounds)
 {
 	struct litest_device *dev = litest_current_device();
@@ -2189,6 +2511,63 @@ START_TEST(tools_with_serials)
 }
 END_TEST
 
+static struct libinput_tablet_tool *
+tool_prox_in_out(struct litest_device *dev, int serial)
+{
+	struct libinput *li = dev->libinput;
+	struct libinput_event *event;
+	struct libinput_event_tablet_tool *tev;
+	struct libinput_tablet_tool *tool;
+
+	litest_push_event_frame(dev);
+	litest_tablet_proximity_in(dev, 10, 10, NULL);
+	litest_event(dev, EV_MSC, MSC_SERIAL, serial);
+	litest_pop_event_frame(dev);
+
+	libinput_dispatch(li);
+	event = libinput_get_event(li);
+	tev = litest_is_tablet_event(event, LIBINPUT_EVENT_TABLET_TOOL_PROXIMITY);
+	tool = libinput_event_tablet_tool_get_tool(tev);
+	ck_assert_int_eq(libinput_tablet_tool_get_serial(tool), serial);
+	libinput_event_destroy(event);
+
+	litest_tablet_proximity_out(dev);
+	litest_drain_events(li);
+
+	return tool;
+}
+
+START_TEST(tools_with_serials_evicted)
+{
+	struct litest_device *dev = litest_current_device();
+	struct libinput *li = dev->libinput;
+	struct libinput_tablet_tool *kept, *dropped, *tool;
+	int serial;
+
+	litest_drain_events(li);
+
+	kept = libinput_tablet_tool_ref(tool_prox_in_out(dev, 1000));
+	libinput_tablet_tool_set_user_data(kept, dev);
+	dropped = tool_prox_in_out(dev, 1001);
+	libinput_tablet_tool_set_user_data(dropped, dev);
+
+	/* Many more tools than the registry keeps around */
+	for (serial = 2000; serial < 2100; serial++)
+		tool_prox_in_out(dev, serial);
+
+	/* The referenced tool must survive, the unreferenced one is gone
+	 * and comes back without its user data */
+	tool = tool_prox_in_out(dev, 1000);
+	ck_assert_ptr_eq(tool, kept);
+	ck_assert_ptr_eq(libinput_tablet_tool_get_user_data(tool), dev);
+
+	tool = tool_prox_in_out(dev, 1001);
+	ck_assert_ptr_eq(libinput_tablet_tool_get_user_data(tool), NULL);
+
+	libinput_tablet_tool_unref(kept);
+}
+END_TEST
+
 START_TEST(tools_without_serials)
 {
 	struct libinput *li = litest_create_context();
@@ -3442,6 +3821,97 @@ START_TEST(tablet_pressure_range)
 }
 END_TEST
 
+static double
+pressure_after_motion(struct litest_device *dev,
+		      struct axis_replacement *axes,
+		      int pressure)
+{
+	struct libinput *li = dev->libinput;
+	struct libinput_event *event;
+	struct libinput_event_tablet_tool *tev;
+	double p = -1.0;
+
+	litest_axis_set_value(axes, ABS_PRESSURE, pressure);
+	litest_tablet_motion(dev, 70, 70, axes);
+	libinput_dispatch(li);
+
+	while ((event = libinput_get_event(li))) {
+		tev = libinput_event_get_tablet_tool_event(event);
+		ck_assert_notnull(tev);
+		p = libinput_event_tablet_tool_get_pressure(tev);
+		libinput_event_destroy(event);
+	}
+
+	return p;
+}
+
+START_TEST(tablet_pressure_curve)
+{
+	struct litest_device *dev = litest_current_device();
+	struct libinput *li = dev->libinput;
+	struct libinput_event *event;
+	struct libinput_event_tablet_tool *tev;
+	struct libinput_tablet_tool *tool;
+	struct axis_replacement axes[] = {
+		{ ABS_DISTANCE, 0 },
+		{ ABS_PRESSURE, 10 },
+		{ -1, -1 },
+	};
+	const double curve[4] = { 0.0, 0.5, 0.5, 1.0 };
+	const double invalid[4] = { 0.0, 0.5, 1.5, 1.0 };
+	double current[4];
+	double linear, curved;
+	enum libinput_config_status status;
+
+	litest_drain_events(li);
+	litest_tablet_proximity_in(dev, 5, 100, axes);
+	libinput_dispatch(li);
+	event = libinput_get_event(li);
+	tev = litest_is_tablet_event(event,
+				     LIBINPUT_EVENT_TABLET_TOOL_PROXIMITY);
+	tool = libinput_tablet_tool_ref(libinput_event_tablet_tool_get_tool(tev));
+	libinput_event_destroy(event);
+	litest_drain_events(li);
+
+	ck_assert(libinput_tablet_tool_config_pressure_curve_is_available(tool));
+	ck_assert_int_eq(libinput_tablet_tool_config_pressure_curve_get(tool,
+									current),
+			 0);
+	ck_assert_double_eq(current[0], 0.0);
+	ck_assert_double_eq(current[3], 1.0);
+
+	pressure_after_motion(dev, axes, 40);
+	linear = pressure_after_motion(dev, axes, 50);
+	ck_assert_double_gt(linear, 0.0);
+
+	status = libinput_tablet_tool_config_pressure_curve_set(tool, invalid);
+	ck_assert_int_eq(status, LIBINPUT_CONFIG_STATUS_INVALID);
+	status = libinput_tablet_tool_config_pressure_curve_set(tool, curve);
+	ck_assert_int_eq(status, LIBINPUT_CONFIG_STATUS_SUCCESS);
+	ck_assert_int_eq(libinput_tablet_tool_config_pressure_curve_get(tool,
+									current),
+			 1);
+	ck_assert_double_eq(current[1], 0.5);
+	ck_assert_double_eq(current[2], 0.5);
+
+	/* The curve bends upwards, same input gives more pressure */
+	pressure_after_motion(dev, axes, 40);
+	curved = pressure_after_motion(dev, axes, 50);
+	ck_assert_double_gt(curved, linear);
+	ck_assert_double_le(curved, 1.0);
+
+	ck_assert_double_eq(pressure_after_motion(dev, axes, 100), 1.0);
+
+	libinput_tablet_tool_config_pressure_curve_get_default(tool, current);
+	status = libinput_tablet_tool_config_pressure_curve_set(tool, current);
+	ck_assert_int_eq(status, LIBINPUT_CONFIG_STATUS_SUCCESS);
+	pressure_after_motion(dev, axes, 40);
+	ck_assert_double_eq(pressure_after_motion(dev, axes, 50), linear);
+
+	libinput_tablet_tool_unref(tool);
+}
+END_TEST
+
 START_TEST(tablet_pressure_offset_exceed_threshold)
 {
 	struct litest_device *dev = litest_current_device();
@@ -4320,6 +4790,62 @@ START_TEST(cintiq_touch_arbitration_remove_tablet)
 }
 END_TEST
 
+static void
+libwacom_load_counter(struct libinput *libinput,
+		      enum libinput_log_priority priority,
+		      const char *format,
+		      va_list args)
+{
+	int *loads = (int*)libinput_get_user_data(libinput);
+
+	if (strstr(format, "libwacom database loaded"))
+		(*loads)++;
+}
+
+START_TEST(libwacom_db_kept_on_replug)
+{
+#if HAVE_LIBWACOM
+	struct libinput *li;
+	struct litest_device *dev;
+	int loads = 0;
+
+	li = litest_create_context();
+	libinput_set_user_data(li, &loads);
+	libinput_log_set_handler(li, libwacom_load_counter);
+	libinput_log_set_priority(li, LIBINPUT_LOG_PRIORITY_DEBUG);
+
+	dev = litest_add_device(li, LITEST_WACOM_INTUOS);
+	litest_drain_events(li);
+	ck_assert_int_eq(loads, 1);
+
+	/* Unplugging the only tablet keeps the database around */
+	litest_delete_device(dev);
+	litest_drain_events(li);
+	dev = litest_add_device(li, LITEST_WACOM_INTUOS);
+	litest_drain_events(li);
+	ck_assert_int_eq(loads, 1);
+
+	/* Suspending drops it */
+	litest_delete_device(dev);
+	litest_drain_events(li);
+	libinput_suspend(li);
+	libinput_resume(li);
+	dev = litest_add_device(li, LITEST_WACOM_INTUOS);
+	litest_drain_events(li);
+	ck_assert_int_eq(loads, 2);
+
+	/* Also when suspended before the removal events are drained */
+	libinput_suspend(li);
+	libinput_resume(li);
+	litest_drain_events(li);
+	ck_assert_int_eq(loads, 3);
+
+	litest_delete_device(dev);
+	libinput_unref(li);
+#endif
+}
+END_TEST
+
 void
 litest_setup_tests_tablet(void)
 {
@@ -4335,6 +4861,7 @@ litest_setup_tests_tablet(void)
 	litest_add("tablet:tool_serial", serial_changes_tool, LITEST_TABLET | LITEST_TOOL_SERIAL, LITEST_ANY);
 	litest_add("tablet:tool_serial", invalid_serials, LITEST_TABLET | LITEST_TOOL_SERIAL, LITEST_ANY);
 	litest_add_no_device("tablet:tool_serial", tools_with_serials);
+	litest_add_for_device("tablet:tool_serial", tools_with_serials_evicted, LITEST_WACOM_INTUOS);
 	litest_add_no_device("tablet:tool_serial", tools_without_serials);
 	litest_add_for_device("tablet:tool_serial", tool_delayed_serial, LITEST_WACOM_HID4800_PEN);
 	litest_add("tablet:proximity", proximity_out_clear_buttons, LITEST_TABLET, LITEST_ANY);
@@ -4362,6 +4889,10 @@ litest_setup_tests_tablet(void)
 	litest_add("tablet:tip", tip_state_button, LITEST_TABLET, LITEST_ANY);
 	litest_add("tablet:motion", motion, LITEST_TABLET, LITEST_ANY);
 	litest_add("tablet:motion", motion_event_state, LITEST_TABLET, LITEST_ANY);
+	litest_add("tablet:motion", motion_smoothing_settles, LITEST_TABLET|LITEST_DISTANCE, LITEST_ANY);
+	litest_add_for_device("tablet:motion", motion_smoothing_window_min, LITEST_TABLET_SMOOTHING_MIN);
+	litest_add_for_device("tablet:motion", motion_smoothing_window_max, LITEST_TABLET_SMOOTHING_MAX);
+	litest_add("tablet:motion", motion_batching, LITEST_TABLET|LITEST_DISTANCE, LITEST_ANY);
 	litest_add_for_device("tablet:motion", motion_outside_bounds, LITEST_WACOM_CINTIQ_24HD);
 	litest_add("tablet:tilt", tilt_available, LITEST_TABLET|LITEST_TILT, LITEST_ANY);
 	litest_add("tablet:tilt", tilt_not_available, LITEST_TABLET, LITEST_TILT);
@@ -4391,6 +4922,7 @@ litest_setup_tests_tablet(void)
 
 	litest_add("tablet:pressure", tablet_pressure_min_max, LITEST_TABLET, LITEST_ANY);
 	litest_add_for_device("tablet:pressure", tablet_pressure_range, LITEST_WACOM_INTUOS);
+	litest_add_for_device("tablet:pressure", tablet_pressure_curve, LITEST_WACOM_INTUOS);
 	litest_add_for_device("tablet:pressure", tablet_pressure_offset, LITEST_WACOM_INTUOS);
 	litest_add_for_device("tablet:pressure", tablet_pressure_offset_decrease, LITEST_WACOM_INTUOS);
 	litest_add_for_device("tablet:pressure", tablet_pressure_offset_increase, LITEST_WACOM_INTUOS);
@@ -4415,4 +4947,5 @@ litest_setup_tests_tablet(void)
 	litest_add_for_device("tablet:touch-arbitration", cintiq_touch_arbitration_suspend_touch_device, LITEST_WACOM_CINTIQ_13HDT_FINGER);
 	litest_add_for_device("tablet:touch-arbitration", cintiq_touch_arbitration_remove_touch, LITEST_WACOM_CINTIQ_13HDT_PEN);
 	litest_add_for_device("tablet:touch-arbitration", cintiq_touch_arbitration_remove_tablet, LITEST_WACOM_CINTIQ_13HDT_FINGER);
+	litest_add_no_device("tablet:libwacom", libwacom_db_kept_on_replug);
 }
@@ -867,6 +867,52 @@ START_TEST(touch_time_usec)
 }
 END_TEST
 
+START_TEST(touch_predicted_position)
+{
+	struct litest_device *dev = litest_current_device();
+	struct libinput *li = dev->libinput;
+	struct libinput_event *event;
+	struct libinput_event_touch *tev;
+	double x, y;
+
+	litest_drain_events(li);
+
+	litest_touch_down(dev, 0, 10, 50);
+	libinput_dispatch(li);
+
+	event = libinput_get_event(li);
+	tev = litest_is_touch_event(event, LIBINPUT_EVENT_TOUCH_DOWN);
+	x = libinput_event_touch_get_x(tev);
+	y = libinput_event_touch_get_y(tev);
+	ck_assert_double_eq(libinput_event_touch_get_predicted_x(tev, ms2us(10)), x);
+	ck_assert_double_eq(libinput_event_touch_get_predicted_y(tev, ms2us(10)), y);
+	libinput_event_destroy(event);
+	litest_drain_events(li);
+
+	litest_touch_move_to(dev, 0, 10, 50, 80, 50, 10, 0);
+	libinput_dispatch(li);
+
+	while ((event = libinput_get_event(li))) {
+		if (libinput_event_get_type(event) != LIBINPUT_EVENT_TOUCH_MOTION) {
+			libinput_event_destroy(event);
+			continue;
+		}
+
+		tev = libinput_event_get_touch_event(event);
+		x = libinput_event_touch_get_x(tev);
+		y = libinput_event_touch_get_y(tev);
+
+		ck_assert_double_eq(libinput_event_touch_get_predicted_x(tev, 0), x);
+		ck_assert_double_ge(libinput_event_touch_get_predicted_x(tev, ms2us(10)), x);
+		ck_assert_double_eq(libinput_event_touch_get_predicted_y(tev, ms2us(10)), y);
+		ck_assert_double_eq(libinput_event_touch_get_predicted_x_transformed(tev, 0, 1024),
+				    libinput_event_touch_get_x_transformed(tev, 1024));
+
+		libinput_event_destroy(event);
+	}
+}
+END_TEST
+
 START_TEST(touch_fuzz)
 {
 	struct litest_device *dev = litest_current_device();
@@ -911,6 +957,106 @@ START_TEST(touch_fuzz)
 }
 END_TEST
 
+START_TEST(touch_palm_size_on_down)
+{
+	struct litest_device *dev = litest_current_device();
+	struct libinput *li = dev->libinput;
+	struct libinput_event *event;
+	struct axis_replacement axes[] = {
+		{ ABS_MT_TOUCH_MAJOR, 50 },
+		{ ABS_MT_PRESSURE, 10 },
+		{ -1, 0 }
+	};
+
+	litest_drain_events(li);
+
+	/* 50mm touch major against a 25mm threshold */
+	litest_touch_down_extended(dev, 0, 50, 50, axes);
+	litest_touch_move_to_extended(dev, 0, 50, 50, 70, 50, axes, 10, 0);
+	litest_touch_up(dev, 0);
+	litest_assert_empty_queue(li);
+
+	litest_axis_set_value(axes, ABS_MT_TOUCH_MAJOR, 5);
+	litest_touch_down_extended(dev, 0, 50, 50, axes);
+	libinput_dispatch(li);
+	event = libinput_get_event(li);
+	litest_is_touch_event(event, LIBINPUT_EVENT_TOUCH_DOWN);
+	libinput_event_destroy(event);
+}
+END_TEST
+
+START_TEST(touch_palm_pressure_on_down)
+{
+	struct litest_device *dev = litest_current_device();
+	struct libinput *li = dev->libinput;
+	struct axis_replacement axes[] = {
+		{ ABS_MT_TOUCH_MAJOR, 5 },
+		{ ABS_MT_PRESSURE, 90 },
+		{ -1, 0 }
+	};
+
+	litest_drain_events(li);
+
+	litest_touch_down_extended(dev, 0, 50, 50, axes);
+	litest_touch_move_to_extended(dev, 0, 50, 50, 70, 50, axes, 10, 0);
+	litest_touch_up(dev, 0);
+	litest_assert_empty_queue(li);
+}
+END_TEST
+
+START_TEST(touch_palm_during_motion)
+{
+	struct litest_device *dev = litest_current_device();
+	struct libinput *li = dev->libinput;
+	struct libinput_event *event;
+	struct libinput_event_touch *tev;
+	struct axis_replacement axes[] = {
+		{ ABS_MT_TOUCH_MAJOR, 5 },
+		{ ABS_MT_PRESSURE, 10 },
+		{ -1, 0 }
+	};
+
+	litest_touch_down_extended(dev, 0, 20, 50, axes);
+	litest_touch_down_extended(dev, 1, 50, 50, axes);
+	litest_drain_events(li);
+
+	litest_axis_set_value(axes, ABS_MT_TOUCH_MAJOR, 50);
+	litest_touch_move_extended(dev, 1, 52, 50, axes);
+	libinput_dispatch(li);
+
+	event = libinput_get_event(li);
+	tev = litest_is_touch_event(event, LIBINPUT_EVENT_TOUCH_UP);
+	ck_assert_int_eq(libinput_event_touch_get_slot(tev), 1);
+	libinput_event_destroy(event);
+	event = libinput_get_event(li);
+	litest_is_touch_event(event, LIBINPUT_EVENT_TOUCH_FRAME);
+	libinput_event_destroy(event);
+
+	/* Stays a palm even after dropping below the threshold */
+	litest_axis_set_value(axes, ABS_MT_TOUCH_MAJOR, 5);
+	litest_touch_move_to_extended(dev, 1, 52, 50, 70, 50, axes, 10, 0);
+	litest_assert_empty_queue(li);
+
+	litest_touch_move_extended(dev, 0, 22, 50, axes);
+	libinput_dispatch(li);
+	event = libinput_get_event(li);
+	tev = litest_is_touch_event(event, LIBINPUT_EVENT_TOUCH_MOTION);
+	ck_assert_int_eq(libinput_event_touch_get_slot(tev), 0);
+	libinput_event_destroy(event);
+	litest_drain_events(li);
+
+	litest_touch_up(dev, 1);
+	litest_assert_empty_queue(li);
+
+	litest_touch_up(dev, 0);
+	libinput_dispatch(li);
+	event = libinput_get_event(li);
+	tev = litest_is_touch_event(event, LIBINPUT_EVENT_TOUCH_UP);
+	ck_assert_int_eq(libinput_event_touch_get_slot(tev), 0);
+	libinput_event_destroy(event);
+}
+END_TEST
+
 void
 litest_setup_tests_touch(void)
 {
@@ -942,6 +1088,11 @@ litest_setup_tests_touch(void)
 	litest_add_ranged("touch:state", touch_initial_state, LITEST_TOUCH, LITEST_PROTOCOL_A, &axes);
 
 	litest_add("touch:time", touch_time_usec, LITEST_TOUCH, LITEST_TOUCHPAD);
+	litest_add("touch:prediction", touch_predicted_position, LITEST_TOUCH, LITEST_TOUCHPAD);
 
 	litest_add_for_device("touch:fuzz", touch_fuzz, LITEST_MULTITOUCH_FUZZ_SCREEN);
+
+	litest_add_for_device("touch:palm", touch_palm_size_on_down, LITEST_TOUCHSCREEN_PALM);
+	litest_add_for_device("touch:palm", touch_palm_pressure_on_down, LITEST_TOUCHSCREEN_PALM);
+	litest_add_for_device("touch:palm", touch_palm_during_motion, LITEST_TOUCHSCREEN_PALM);
 }
@@ -30,6 +30,7 @@
 #include <unistd.h>
 
 #include "libinput-util.h"
+#include "evdev-mt-touchpad.h"
 #include "litest.h"
 
 START_TEST(touchpad_1fg_tap)
@@ -2375,12 +2376,541 @@ START_TEST(touchpad_drag_lock_default_unavailable)
 }
 END_TEST
 
+START_TEST(touchpad_tap_state_machine_complete)
+{
+	struct transition {
+		enum tp_tap_state state;
+		enum tap_event event;
+		enum tp_tap_state next;
+	} transitions[] = {
+#define T(state_, event_, action_, next_) \
+		{ TAP_STATE_##state_, TAP_EVENT_##event_, TAP_STATE_##next_ },
+		TAP_TRANSITIONS(T)
+#undef T
+	};
+	int handled[TAP_STATE_COUNT][TAP_EVENT_COUNT] = {{0}};
+	bool reachable[TAP_STATE_COUNT] = { false };
+	bool changed = true;
+	unsigned int i;
+	int s, e;
+
+	for (i = 0; i < ARRAY_LENGTH(transitions); i++) {
+		struct transition *t = &transitions[i];
+
+		ck_assert_int_ge(t->state, TAP_STATE_IDLE);
+		ck_assert_int_le(t->state, TAP_STATE_DEAD);
+		ck_assert_int_ge(t->next, TAP_STATE_IDLE);
+		ck_assert_int_le(t->next, TAP_STATE_DEAD);
+		ck_assert_int_ge(t->event, TAP_EVENT_TOUCH);
+		ck_assert_int_le(t->event, TAP_EVENT_THUMB);
+
+		handled[t->state - TAP_STATE_IDLE][t->event - TAP_EVENT_TOUCH]++;
+	}
+
+	/* every event is handled exactly once in every state */
+	for (s = 0; s < TAP_STATE_COUNT; s++) {
+		for (e = 0; e < TAP_EVENT_COUNT; e++)
+			ck_assert_int_eq(handled[s][e], 1);
+	}
+
+	/* and every state can be reached from idle */
+	reachable[0] = true;
+	while (changed) {
+		changed = false;
+		for (i = 0; i < ARRAY_LENGTH(transitions); i++) {
+			struct transition *t = &transitions[i];
+			int from = t->state - TAP_STATE_IDLE,
+			    to = t->next - TAP_STATE_IDLE;
+
+			if (reachable[from] && !reachable[to]) {
+				reachable[to] = true;
+				changed = true;
+			}
+		}
+	}
+
+	for (s = 0; s < TAP_STATE_COUNT; s++)
+		ck_assert(reachable[s]);
+}
+END_TEST
+
+/* The results of the switch-based state machine the TAP_TRANSITIONS
+ * table replaced, one case per state */
+static enum tp_tap_state
+tap_fsm_reference(enum tp_tap_state state,
+		  enum tap_event event,
+		  unsigned int nfingers_down,
+		  bool drag_enabled,
+		  bool drag_lock_enabled)
+{
+	if (event == TAP_EVENT_BUTTON) {
+		if (state == TAP_STATE_MULTITAP)
+			return TAP_STATE_IDLE;
+		return TAP_STATE_DEAD;
+	}
+
+	switch (state) {
+	case TAP_STATE_IDLE:
+		if (event == TAP_EVENT_TOUCH)
+			return TAP_STATE_TOUCH;
+		break;
+	case TAP_STATE_TOUCH:
+		switch (event) {
+		case TAP_EVENT_TOUCH:
+			return TAP_STATE_TOUCH_2;
+		case TAP_EVENT_RELEASE:
+			return drag_enabled ? TAP_STATE_TAPPED : TAP_STATE_IDLE;
+		case TAP_EVENT_MOTION:
+		case TAP_EVENT_TIMEOUT:
+			return TAP_STATE_HOLD;
+		case TAP_EVENT_THUMB:
+			return TAP_STATE_IDLE;
+		default:
+			break;
+		}
+		break;
+	case TAP_STATE_HOLD:
+		switch (event) {
+		case TAP_EVENT_TOUCH:
+			return TAP_STATE_TOUCH_2;
+		case TAP_EVENT_RELEASE:
+		case TAP_EVENT_THUMB:
+			return TAP_STATE_IDLE;
+		default:
+			break;
+		}
+		break;
+	case TAP_STATE_TAPPED:
+		switch (event) {
+		case TAP_EVENT_TOUCH:
+			return TAP_STATE_DRAGGING_OR_DOUBLETAP;
+		case TAP_EVENT_TIMEOUT:
+			return TAP_STATE_IDLE;
+		default:
+			break;
+		}
+		break;
+	case TAP_STATE_TOUCH_2:
+		switch (event) {
+		case TAP_EVENT_TOUCH:
+			return TAP_STATE_TOUCH_3;
+		case TAP_EVENT_RELEASE:
+			return TAP_STATE_TOUCH_2_RELEASE;
+		case TAP_EVENT_MOTION:
+		case TAP_EVENT_TIMEOUT:
+			return TAP_STATE_TOUCH_2_HOLD;
+		default:
+			break;
+		}
+		break;
+	case TAP_STATE_TOUCH_2_HOLD:
+		switch (event) {
+		case TAP_EVENT_TOUCH:
+			return TAP_STATE_TOUCH_3;
+		case TAP_EVENT_RELEASE:
+			return TAP_STATE_HOLD;
+		default:
+			break;
+		}
+		break;
+	case TAP_STATE_TOUCH_2_RELEASE:
+		switch (event) {
+		case TAP_EVENT_TOUCH:
+			return TAP_STATE_TOUCH_2_HOLD;
+		case TAP_EVENT_RELEASE:
+			return TAP_STATE_IDLE;
+		case TAP_EVENT_MOTION:
+		case TAP_EVENT_TIMEOUT:
+			return TAP_STATE_HOLD;
+		default:
+			break;
+		}
+		break;
+	case TAP_STATE_TOUCH_3:
+		switch (event) {
+		case TAP_EVENT_TOUCH:
+			return TAP_STATE_DEAD;
+		case TAP_EVENT_RELEASE:
+			return TAP_STATE_TOUCH_2_HOLD;
+		case TAP_EVENT_MOTION:
+		case TAP_EVENT_TIMEOUT:
+			return TAP_STATE_TOUCH_3_HOLD;
+		default:
+			break;
+		}
+		break;
+	case TAP_STATE_TOUCH_3_HOLD:
+		switch (event) {
+		case TAP_EVENT_TOUCH:
+			return TAP_STATE_DEAD;
+		case TAP_EVENT_RELEASE:
+			return TAP_STATE_TOUCH_2_HOLD;
+		default:
+			break;
+		}
+		break;
+	case TAP_STATE_DRAGGING_OR_DOUBLETAP:
+		switch (event) {
+		case TAP_EVENT_TOUCH:
+			return TAP_STATE_DRAGGING_2;
+		case TAP_EVENT_RELEASE:
+			return TAP_STATE_MULTITAP;
+		case TAP_EVENT_MOTION:
+		case TAP_EVENT_TIMEOUT:
+			return TAP_STATE_DRAGGING;
+		default:
+			break;
+		}
+		break;
+	case TAP_STATE_DRAGGING_OR_TAP:
+		switch (event) {
+		case TAP_EVENT_TOUCH:
+			return TAP_STATE_DRAGGING_2;
+		case TAP_EVENT_RELEASE:
+			return TAP_STATE_IDLE;
+		case TAP_EVENT_MOTION:
+		case TAP_EVENT_TIMEOUT:
+			return TAP_STATE_DRAGGING;
+		default:
+			break;
+		}
+		break;
+	case TAP_STATE_DRAGGING:
+		switch (event) {
+		case TAP_EVENT_TOUCH:
+			return TAP_STATE_DRAGGING_2;
+		case TAP_EVENT_RELEASE:
+			return drag_lock_enabled ?
+				TAP_STATE_DRAGGING_WAIT : TAP_STATE_IDLE;
+		default:
+			break;
+		}
+		break;
+	case TAP_STATE_DRAGGING_WAIT:
+		switch (event) {
+		case TAP_EVENT_TOUCH:
+			return TAP_STATE_DRAGGING_OR_TAP;
+		case TAP_EVENT_TIMEOUT:
+			return TAP_STATE_IDLE;
+		default:
+			break;
+		}
+		break;
+	case TAP_STATE_DRAGGING_2:
+		switch (event) {
+		case TAP_EVENT_TOUCH:
+			return TAP_STATE_DEAD;
+		case TAP_EVENT_RELEASE:
+			return TAP_STATE_DRAGGING;
+		default:
+			break;
+		}
+		break;
+	case TAP_STATE_MULTITAP:
+		switch (event) {
+		case TAP_EVENT_TOUCH:
+			return TAP_STATE_MULTITAP_DOWN;
+		case TAP_EVENT_TIMEOUT:
+			return TAP_STATE_IDLE;
+		default:
+			break;
+		}
+		break;
+	case TAP_STATE_MULTITAP_DOWN:
+		switch (event) {
+		case TAP_EVENT_TOUCH:
+			return TAP_STATE_DRAGGING_2;
+		case TAP_EVENT_RELEASE:
+			return TAP_STATE_MULTITAP;
+		case TAP_EVENT_MOTION:
+		case TAP_EVENT_TIMEOUT:
+			return TAP_STATE_DRAGGING;
+		default:
+			break;
+		}
+		break;
+	case TAP_STATE_DEAD:
+		if (event == TAP_EVENT_RELEASE && nfingers_down == 0)
+			return TAP_STATE_IDLE;
+		break;
+	}
+
+	return state;
+}
+
+#define TAP_FSM_MAX_FINGERS 4
+#define TAP_FSM_MAX_PATH 16
+
+/* Follows the "tap state: from → event → to" debug messages of the
+ * touchpad and checks every transition against tap_fsm_reference() */
+struct tap_fsm_test {
+	struct litest_device *dev;
+	bool drag_enabled;
+	bool drag_lock_enabled;
+
+	enum tp_tap_state state;
+	unsigned int nfingers;
+	double y[TAP_FSM_MAX_FINGERS];
+
+	bool seen[TAP_STATE_COUNT][TAP_EVENT_COUNT];
+	bool reached[TAP_STATE_COUNT];
+	char path[TAP_STATE_COUNT][TAP_FSM_MAX_PATH];
+};
+
+static int
+tap_fsm_lookup(const char *name, const char * const *names, size_t len)
+{
+	size_t i;
+
+	for (i = 0; i < len; i++) {
+		if (streq(name, names[i]))
+			return i;
+	}
+
+	litest_abort_msg("Unknown tap state or event '%s'\n", name);
+	return -1;
+}
+
+LIBINPUT_ATTRIBUTE_PRINTF(3, 0)
+static void
+tap_fsm_log_handler(struct libinput *libinput,
+		    enum libinput_log_priority priority,
+		    const char *format,
+		    va_list args)
+{
+	static const char * const states[TAP_STATE_COUNT] = {
+		"TAP_STATE_IDLE",
+		"TAP_STATE_TOUCH",
+		"TAP_STATE_HOLD",
+		"TAP_STATE_TAPPED",
+		"TAP_STATE_TOUCH_2",
+		"TAP_STATE_TOUCH_2_HOLD",
+		"TAP_STATE_TOUCH_2_RELEASE",
+		"TAP_STATE_TOUCH_3",
+		"TAP_STATE_TOUCH_3_HOLD",
+		"TAP_STATE_DRAGGING_OR_DOUBLETAP",
+		"TAP_STATE_DRAGGING_OR_TAP",
+		"TAP_STATE_DRAGGING",
+		"TAP_STATE_DRAGGING_WAIT",
+		"TAP_STATE_DRAGGING_2",
+		"TAP_STATE_MULTITAP",
+		"TAP_STATE_MULTITAP_DOWN",
+		"TAP_STATE_DEAD",
+	};
+	static const char * const events[TAP_EVENT_COUNT] = {
+		"TAP_EVENT_TOUCH",
+		"TAP_EVENT_MOTION",
+		"TAP_EVENT_RELEASE",
+		"TAP_EVENT_BUTTON",
+		"TAP_EVENT_TIMEOUT",
+		"TAP_EVENT_THUMB",
+	};
+	struct tap_fsm_test *test = libinput_get_user_data(libinput);
+	char msg[256], from[64], event[64], to[64];
+	enum tp_tap_state s_from, s_to, expected;
+	enum tap_event e;
+	const char *p;
+
+	vsnprintf(msg, sizeof(msg), format, args);
+	p = strstr(msg, "tap state: ");
+	if (!p)
+		return;
+
+	ck_assert_int_eq(sscanf(p, "tap state: %63s → %63s → %63s",
+				from, event, to),
+			 3);
+
+	s_from = TAP_STATE_IDLE + tap_fsm_lookup(from, states,
+						 ARRAY_LENGTH(states));
+	e = TAP_EVENT_TOUCH + tap_fsm_lookup(event, events,
+					     ARRAY_LENGTH(events));
+	s_to = TAP_STATE_IDLE + tap_fsm_lookup(to, states,
+					       ARRAY_LENGTH(states));
+
+	ck_assert_int_eq(s_from, test->state);
+
+	expected = tap_fsm_reference(s_from, e,
+				     test->nfingers,
+				     test->drag_enabled,
+				     test->drag_lock_enabled);
+	if (s_to != expected)
+		litest_abort_msg("%s → %s → %s, expected %s\n",
+				 from, event, to,
+				 states[expected - TAP_STATE_IDLE]);
+
+	test->seen[s_from - TAP_STATE_IDLE][e - TAP_EVENT_TOUCH] = true;
+	test->state = s_to;
+}
+
+/* One step on the touchpad:
+ * d ... put a finger down
+ * m ... move the last finger put down
+ * u ... lift the last finger put down
+ * c ... click the clickpad
+ * t ... wait for the tap or drag lock timeout */
+static void
+tap_fsm_step(struct tap_fsm_test *test, char step)
+{
+	struct litest_device *dev = test->dev;
+	struct libinput *li = dev->libinput;
+	unsigned int slot;
+	double x, y;
+
+	switch (step) {
+	case 'd':
+		if (test->nfingers == TAP_FSM_MAX_FINGERS)
+			return;
+		slot = test->nfingers;
+		test->y[slot] = 50;
+		test->nfingers++;
+		litest_touch_down(dev, slot, 30 + 10 * slot, test->y[slot]);
+		break;
+	case 'm':
+		if (test->nfingers == 0)
+			return;
+		slot = test->nfingers - 1;
+		x = 30 + 10 * slot;
+		y = test->y[slot] == 50 ? 70 : 50;
+		litest_touch_move_to(dev, slot, x, test->y[slot], x, y, 10, 0);
+		test->y[slot] = y;
+		break;
+	case 'u':
+		if (test->nfingers == 0)
+			return;
+		test->nfingers--;
+		litest_touch_up(dev, test->nfingers);
+		break;
+	case 'c':
+		litest_button_click(dev, BTN_LEFT, true);
+		litest_button_click(dev, BTN_LEFT, false);
+		break;
+	case 't':
+		if (test->state == TAP_STATE_DRAGGING_WAIT)
+			litest_timeout_tapndrag();
+		else
+			litest_timeout_tap();
+		break;
+	default:
+		litest_abort_msg("Invalid step '%c'\n", step);
+	}
+
+	litest_drain_events(li);
+}
+
+static void
+tap_fsm_reset(struct tap_fsm_test *test)
+{
+	int i;
+
+	while (test->nfingers > 0)
+		tap_fsm_step(test, 'u');
+
+	/* A click goes to DEAD (or IDLE from MULTITAP) from every state
+	 * without a timer, a touch and release leave DEAD */
+	for (i = 0; i < 3 && test->state != TAP_STATE_IDLE; i++) {
+		if (test->state == TAP_STATE_DEAD) {
+			tap_fsm_step(test, 'd');
+			tap_fsm_step(test, 'u');
+		} else {
+			tap_fsm_step(test, 'c');
+		}
+	}
+
+	ck_assert_int_eq(test->state, TAP_STATE_IDLE);
+}
+
+START_TEST(touchpad_tap_state_machine_transitions)
+{
+	struct litest_device *dev = litest_current_device();
+	struct libinput *li = dev->libinput;
+	struct tap_fsm_test test = {
+		.dev = dev,
+		.drag_enabled = _i != 2, /* ranged test */
+		.drag_lock_enabled = _i == 0,
+		.state = TAP_STATE_IDLE,
+	};
+	const char steps[] = "dmuct";
+	enum libinput_log_priority priority;
+	enum tp_tap_state queue[TAP_STATE_COUNT];
+	unsigned int head = 0, tail = 0;
+	int s;
+
+	litest_enable_tap(dev->libinput_device);
+	if (test.drag_enabled)
+		litest_enable_tap_drag(dev->libinput_device);
+	else
+		litest_disable_tap_drag(dev->libinput_device);
+	if (test.drag_lock_enabled)
+		litest_enable_drag_lock(dev->libinput_device);
+	else
+		litest_disable_drag_lock(dev->libinput_device);
+	litest_drain_events(li);
+
+	priority = libinput_log_get_priority(li);
+	libinput_set_user_data(li, &test);
+	libinput_log_set_handler(li, tap_fsm_log_handler);
+	libinput_log_set_priority(li, LIBINPUT_LOG_PRIORITY_DEBUG);
+
+	/* Breadth-first from IDLE: replay the shortest known path to each
+	 * state, then try every step from there */
+	test.reached[0] = true;
+	queue[tail++] = TAP_STATE_IDLE;
+
+	while (head < tail) {
+		enum tp_tap_state current = queue[head++];
+		const char *path = test.path[current - TAP_STATE_IDLE];
+		const char *step;
+
+		for (step = steps; *step; step++) {
+			enum tp_tap_state next;
+			const char *p;
+			int idx;
+
+			for (p = path; *p; p++)
+				tap_fsm_step(&test, *p);
+			ck_assert_int_eq(test.state, current);
+
+			tap_fsm_step(&test, *step);
+			next = test.state;
+			idx = next - TAP_STATE_IDLE;
+
+			if (!test.reached[idx]) {
+				ck_assert_int_lt(strlen(path) + 1, TAP_FSM_MAX_PATH);
+				test.reached[idx] = true;
+				snprintf(test.path[idx], TAP_FSM_MAX_PATH,
+					 "%s%c", path, *step);
+				queue[tail++] = next;
+			}
+
+			tap_fsm_reset(&test);
+		}
+	}
+
+	/* A touch and a click can be driven in every state reached, with
+	 * drag lock every state can be reached */
+	for (s = 0; s < TAP_STATE_COUNT; s++) {
+		if (test.drag_lock_enabled)
+			ck_assert(test.reached[s]);
+		if (!test.reached[s])
+			continue;
+
+		ck_assert(test.seen[s][TAP_EVENT_TOUCH - TAP_EVENT_TOUCH]);
+		ck_assert(test.seen[s][TAP_EVENT_BUTTON - TAP_EVENT_TOUCH]);
+	}
+
+	libinput_log_set_priority(li, priority);
+	litest_restore_log_handler(li);
+	libinput_set_user_data(li, NULL);
+}
+END_TEST
+
 void
 litest_setup_tests_touchpad_tap(void)
 {
 	struct range multitap_range = {3, 8};
 	struct range tap_map_range = { LIBINPUT_CONFIG_TAP_MAP_LRM,
 				       LIBINPUT_CONFIG_TAP_MAP_LMR + 1 };
+	struct range tap_fsm_configs = {0, 3}; /* drag lock, drag, no drag */
 
 	litest_add("tap-1fg:1fg", touchpad_1fg_tap, LITEST_TOUCHPAD, LITEST_ANY);
 	litest_add("tap-1fg:1fg", touchpad_1fg_doubletap, LITEST_TOUCHPAD, LITEST_ANY);
@@ -2455,4 +2985,7 @@ litest_setup_tests_touchpad_tap(void)
 	litest_add("tap:drag", touchpad_drag_disabled, LITEST_TOUCHPAD, LITEST_ANY);
 	litest_add("tap:drag", touchpad_drag_disabled_immediate, LITEST_TOUCHPAD, LITEST_ANY);
 	litest_add_ranged("tap-multitap:drag", touchpad_drag_disabled_multitap_no_drag, LITEST_TOUCHPAD, LITEST_ANY, &multitap_range);
+
+	litest_add_no_device("tap:state-machine", touchpad_tap_state_machine_complete);
+	litest_add_ranged_for_device("tap:state-machine", touchpad_tap_state_machine_transitions, LITEST_SYNAPTICS_RMI4, &tap_fsm_configs);
 }
@@ -27,6 +27,7 @@
 #include <errno.h>
 #include <fcntl.h>
 #include <libinput.h>
+#include <math.h>
 #include <unistd.h>
 
 #include "libinput-util.h"
@@ -3047,6 +3048,50 @@ START_TEST(touchpad_dwt_type_short_timeout)
 }
 END_TEST
 
+START_TEST(touchpad_dwt_type_extends_timeout)
+{
+	struct litest_device *touchpad = litest_current_device();
+	struct litest_device *keyboard;
+	struct libinput *li = touchpad->libinput;
+
+	if (!has_disable_while_typing(touchpad))
+		return;
+
+	keyboard = dwt_init_paired_keyboard(li, touchpad);
+	litest_disable_tap(touchpad->libinput_device);
+	litest_drain_events(li);
+
+	litest_keyboard_key(keyboard, KEY_A, true);
+	litest_keyboard_key(keyboard, KEY_A, false);
+	libinput_dispatch(li);
+	msleep(150);
+
+	/* the second key press pushes the timeout out past the
+	 * first one */
+	litest_keyboard_key(keyboard, KEY_A, true);
+	litest_keyboard_key(keyboard, KEY_A, false);
+	libinput_dispatch(li);
+	litest_assert_only_typed_events(li, LIBINPUT_EVENT_KEYBOARD_KEY);
+
+	msleep(150);
+	libinput_dispatch(li);
+
+	litest_touch_down(touchpad, 0, 50, 50);
+	litest_touch_move_to(touchpad, 0, 50, 50, 70, 50, 5, 1);
+	litest_touch_up(touchpad, 0);
+	litest_assert_empty_queue(li);
+
+	litest_timeout_dwt_long();
+	libinput_dispatch(li);
+	litest_touch_down(touchpad, 0, 50, 50);
+	litest_touch_move_to(touchpad, 0, 50, 50, 70, 50, 5, 1);
+	litest_touch_up(touchpad, 0);
+	litest_assert_only_typed_events(li, LIBINPUT_EVENT_POINTER_MOTION);
+
+	litest_delete_device(keyboard);
+}
+END_TEST
+
 START_TEST(touchpad_dwt_modifier_no_dwt)
 {
 	struct litest_device *touchpad = litest_current_device();
@@ -4490,6 +4535,172 @@ START_TEST(touchpad_finger_always_down)
 }
 END_TEST
 
+START_TEST(touchpad_low_latency_config)
+{
+	struct litest_device *dev = litest_current_device();
+	struct libinput_device *device = dev->libinput_device;
+	enum libinput_config_status status;
+	enum libinput_config_low_latency_state state;
+
+	ck_assert(libinput_device_config_low_latency_is_available(device));
+	state = libinput_device_config_low_latency_get_enabled(device);
+	ck_assert_int_eq(state, LIBINPUT_CONFIG_LOW_LATENCY_DISABLED);
+	state = libinput_device_config_low_latency_get_default_enabled(device);
+	ck_assert_int_eq(state, LIBINPUT_CONFIG_LOW_LATENCY_DISABLED);
+
+	status = libinput_device_config_low_latency_set_enabled(device,
+					LIBINPUT_CONFIG_LOW_LATENCY_ENABLED);
+	ck_assert_int_eq(status, LIBINPUT_CONFIG_STATUS_SUCCESS);
+	state = libinput_device_config_low_latency_get_enabled(device);
+	ck_assert_int_eq(state, LIBINPUT_CONFIG_LOW_LATENCY_ENABLED);
+	status = libinput_device_config_low_latency_set_enabled(device,
+					LIBINPUT_CONFIG_LOW_LATENCY_DISABLED);
+	ck_assert_int_eq(status, LIBINPUT_CONFIG_STATUS_SUCCESS);
+
+	status = libinput_device_config_low_latency_set_enabled(device, 3);
+	ck_assert_int_eq(status, LIBINPUT_CONFIG_STATUS_INVALID);
+
+	ck_assert_double_eq(libinput_device_config_low_latency_get_smoothing(device),
+			    libinput_device_config_low_latency_get_default_smoothing(device));
+	status = libinput_device_config_low_latency_set_smoothing(device, 0.0);
+	ck_assert_int_eq(status, LIBINPUT_CONFIG_STATUS_SUCCESS);
+	status = libinput_device_config_low_latency_set_smoothing(device, 1.0);
+	ck_assert_int_eq(status, LIBINPUT_CONFIG_STATUS_SUCCESS);
+	ck_assert_double_eq(libinput_device_config_low_latency_get_smoothing(device),
+			    1.0);
+
+	status = libinput_device_config_low_latency_set_smoothing(device, -0.1);
+	ck_assert_int_eq(status, LIBINPUT_CONFIG_STATUS_INVALID);
+	status = libinput_device_config_low_latency_set_smoothing(device, 1.1);
+	ck_assert_int_eq(status, LIBINPUT_CONFIG_STATUS_INVALID);
+	status = libinput_device_config_low_latency_set_smoothing(device, NAN);
+	ck_assert_int_eq(status, LIBINPUT_CONFIG_STATUS_INVALID);
+	ck_assert_double_eq(libinput_device_config_low_latency_get_smoothing(device),
+			    1.0);
+}
+END_TEST
+
+START_TEST(touchpad_low_latency_config_unavailable)
+{
+	struct litest_device *dev = litest_current_device();
+	struct libinput_device *device = dev->libinput_device;
+	enum libinput_config_status status;
+	enum libinput_config_low_latency_state state;
+
+	ck_assert(!libinput_device_config_low_latency_is_available(device));
+	state = libinput_device_config_low_latency_get_enabled(device);
+	ck_assert_int_eq(state, LIBINPUT_CONFIG_LOW_LATENCY_DISABLED);
+
+	status = libinput_device_config_low_latency_set_enabled(device,
+					LIBINPUT_CONFIG_LOW_LATENCY_ENABLED);
+	ck_assert_int_eq(status, LIBINPUT_CONFIG_STATUS_UNSUPPORTED);
+	status = libinput_device_config_low_latency_set_enabled(device,
+					LIBINPUT_CONFIG_LOW_LATENCY_DISABLED);
+	ck_assert_int_eq(status, LIBINPUT_CONFIG_STATUS_SUCCESS);
+	status = libinput_device_config_low_latency_set_smoothing(device, 0.5);
+	ck_assert_int_eq(status, LIBINPUT_CONFIG_STATUS_UNSUPPORTED);
+}
+END_TEST
+
+static void
+move_below_hysteresis(struct litest_device *dev)
+{
+	const struct input_absinfo *abs;
+	double width_mm, dx;
+
+	/* 0.3mm, below the 0.5mm hysteresis margin */
+	abs = libevdev_get_abs_info(dev->evdev, ABS_X);
+	width_mm = (abs->maximum - abs->minimum)/(double)abs->resolution;
+	dx = 0.3/width_mm * 100.0;
+
+	litest_touch_down(dev, 0, 50, 50);
+	litest_touch_move_to(dev, 0, 50, 50, 50 + dx, 50, 10, 10);
+	litest_touch_up(dev, 0);
+}
+
+START_TEST(touchpad_low_latency_small_motion)
+{
+	struct litest_device *dev = litest_current_device();
+	struct libinput_device *device = dev->libinput_device;
+	struct libinput *li = dev->libinput;
+	enum libinput_config_status status;
+
+	litest_disable_tap(device);
+	litest_drain_events(li);
+
+	/* default mode: the hysteresis swallows the motion */
+	move_below_hysteresis(dev);
+	litest_assert_empty_queue(li);
+
+	status = libinput_device_config_low_latency_set_enabled(device,
+					LIBINPUT_CONFIG_LOW_LATENCY_ENABLED);
+	ck_assert_int_eq(status, LIBINPUT_CONFIG_STATUS_SUCCESS);
+	status = libinput_device_config_low_latency_set_smoothing(device, 0.0);
+	ck_assert_int_eq(status, LIBINPUT_CONFIG_STATUS_SUCCESS);
+
+	move_below_hysteresis(dev);
+	libinput_dispatch(li);
+	ck_assert_int_ne(libinput_next_event_type(li), LIBINPUT_EVENT_NONE);
+	litest_assert_only_typed_events(li, LIBINPUT_EVENT_POINTER_MOTION);
+}
+END_TEST
+
+START_TEST(touchpad_low_latency_stationary_converges)
+{
+	struct litest_device *dev = litest_current_device();
+	struct libinput_device *device = dev->libinput_device;
+	struct libinput *li = dev->libinput;
+	struct libinput_event *event;
+	enum libinput_config_status status;
+	const struct input_absinfo *abs;
+	double dx = 0.0, expected;
+	int i;
+
+	litest_disable_tap(device);
+	status = libinput_device_config_low_latency_set_enabled(device,
+					LIBINPUT_CONFIG_LOW_LATENCY_ENABLED);
+	ck_assert_int_eq(status, LIBINPUT_CONFIG_STATUS_SUCCESS);
+	litest_drain_events(li);
+
+	litest_touch_down(dev, 0, 50, 50);
+	litest_touch_move_to(dev, 0, 50, 50, 60, 50, 10, 10);
+
+	/* The finger rests: the kernel still sends frames, but only the
+	 * pressure changes. The smoothed position only catches up on
+	 * these frames, without them it would stop short of the kernel
+	 * position, see libinput_device_config_low_latency_is_available() */
+	for (i = 0; i < 50; i++) {
+		msleep(10);
+		litest_event(dev, EV_ABS, ABS_MT_PRESSURE, i % 2 ? 30 : 32);
+		litest_event(dev, EV_ABS, ABS_PRESSURE, i % 2 ? 30 : 32);
+		litest_event(dev, EV_SYN, SYN_REPORT, 0);
+		libinput_dispatch(li);
+	}
+
+	libinput_dispatch(li);
+	while ((event = libinput_get_event(li))) {
+		struct libinput_event_pointer *ptrev;
+
+		ptrev = litest_is_motion_event(event);
+		dx += libinput_event_pointer_get_dx_unaccelerated(ptrev);
+		ck_assert_double_eq(libinput_event_pointer_get_dy_unaccelerated(ptrev),
+				    0.0);
+		libinput_event_destroy(event);
+	}
+
+	/* The smoothed position has caught up with the kernel position, so
+	 * all motion adds up to the distance the touch moved, in 1000dpi
+	 * units. Allow for the rounding of both positions. */
+	abs = libevdev_get_abs_info(dev->evdev, ABS_MT_POSITION_X);
+	expected = (abs->maximum - abs->minimum) * 0.1 / abs->resolution *
+		   1000.0/25.4;
+	ck_assert_double_ge(dx, expected - 2 * 1000.0/25.4/abs->resolution);
+	ck_assert_double_le(dx, expected + 2 * 1000.0/25.4/abs->resolution);
+
+	litest_touch_up(dev, 0);
+}
+END_TEST
+
 START_TEST(touchpad_time_usec)
 {
 	struct litest_device *dev = litest_current_device();
@@ -5051,6 +5262,7 @@ litest_setup_tests_touchpad(void)
 	litest_add("touchpad:dwt", touchpad_dwt_key_hold_timeout_existing_touch_cornercase, LITEST_TOUCHPAD, LITEST_ANY);
 	litest_add("touchpad:dwt", touchpad_dwt_type, LITEST_TOUCHPAD, LITEST_ANY);
 	litest_add("touchpad:dwt", touchpad_dwt_type_short_timeout, LITEST_TOUCHPAD, LITEST_ANY);
+	litest_add("touchpad:dwt", touchpad_dwt_type_extends_timeout, LITEST_TOUCHPAD, LITEST_ANY);
 	litest_add("touchpad:dwt", touchpad_dwt_modifier_no_dwt, LITEST_TOUCHPAD, LITEST_ANY);
 	litest_add("touchpad:dwt", touchpad_dwt_modifier_combo_no_dwt, LITEST_TOUCHPAD, LITEST_ANY);
 	litest_add("touchpad:dwt", touchpad_dwt_modifier_combo_dwt_after, LITEST_TOUCHPAD, LITEST_ANY);
@@ -5092,6 +5304,11 @@ litest_setup_tests_touchpad(void)
 
 	litest_add("touchpad:time", touchpad_time_usec, LITEST_TOUCHPAD, LITEST_ANY);
 
+	litest_add("touchpad:low-latency", touchpad_low_latency_config, LITEST_TOUCHPAD, LITEST_ANY);
+	litest_add("touchpad:low-latency", touchpad_low_latency_config_unavailable, LITEST_ANY, LITEST_TOUCHPAD);
+	litest_add_for_device("touchpad:low-latency", touchpad_low_latency_small_motion, LITEST_SYNAPTICS_CLICKPAD_X220);
+	litest_add_for_device("touchpad:low-latency", touchpad_low_latency_stationary_converges, LITEST_SYNAPTICS_RMI4);
+
 	litest_add_for_device("touchpad:jumps", touchpad_jump_finger_motion, LITEST_SYNAPTICS_CLICKPAD_X220);
 
 	litest_add_for_device("touchpad:sendevents", touchpad_disabled_on_mouse, LITEST_SYNAPTICS_CLICKPAD_X220);
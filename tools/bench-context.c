@@ -0,0 +1,96 @@
+/*
+ * Copyright © 2017 Red Hat, Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice (including the next
+ * paragraph) shall be included in all copies or substantial portions of the
+ * Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+
+#include "config.h"
+
+#include <errno.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "bench-context.h"
+
+static int
+bench_open_restricted(const char *path, int flags, void *user_data)
+{
+	return -ENODEV;
+}
+
+static void
+bench_close_restricted(int fd, void *user_data)
+{
+}
+
+static const struct libinput_interface interface = {
+	.open_restricted = bench_open_restricted,
+	.close_restricted = bench_close_restricted,
+};
+
+static void
+seat_destroy(struct libinput_seat *seat)
+{
+	free(seat);
+}
+
+void
+bench_context_init(struct bench_context *ctx)
+{
+	ctx->li = libinput_path_create_context(&interface, NULL);
+	ctx->seat = zalloc(sizeof(*ctx->seat));
+	if (!ctx->li || !ctx->seat) {
+		fprintf(stderr, "Out of memory\n");
+		exit(1);
+	}
+
+	libinput_seat_init(ctx->seat, ctx->li, "seat0", "default",
+			   seat_destroy);
+}
+
+void
+bench_context_fini(struct bench_context *ctx)
+{
+	libinput_seat_unref(ctx->seat);
+	libinput_unref(ctx->li);
+}
+
+struct evdev_device *
+bench_context_add_virtual_device(struct bench_context *ctx,
+				 const char *name,
+				 enum evdev_device_seat_capability seat_caps)
+{
+	struct evdev_device *device;
+
+	device = evdev_device_create_virtual(ctx->seat, name, seat_caps);
+	if (!device) {
+		fprintf(stderr, "Out of memory\n");
+		exit(1);
+	}
+
+	return device;
+}
+
+void
+bench_context_remove_virtual_device(struct evdev_device *device)
+{
+	list_remove(&device->base.link);
+	libinput_device_unref(&device->base);
+}
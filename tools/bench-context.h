@@ -0,0 +1,54 @@
+/*
+ * Copyright © 2017 Red Hat, Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice (including the next
+ * paragraph) shall be included in all copies or substantial portions of the
+ * Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+
+#ifndef BENCH_CONTEXT_H
+#define BENCH_CONTEXT_H
+
+#include "libinput-private.h"
+#include "evdev.h"
+
+/* A path context without any kernel devices and one seat for the
+ * benchmarks that post events directly into libinput */
+struct bench_context {
+	struct libinput *li;
+	struct libinput_seat *seat;
+};
+
+/* Exits on failure */
+void
+bench_context_init(struct bench_context *ctx);
+
+void
+bench_context_fini(struct bench_context *ctx);
+
+/* A device without a dispatch, see evdev_device_create_virtual(). Exits
+ * on failure */
+struct evdev_device *
+bench_context_add_virtual_device(struct bench_context *ctx,
+				 const char *name,
+				 enum evdev_device_seat_capability seat_caps);
+
+void
+bench_context_remove_virtual_device(struct evdev_device *device);
+
+#endif
@@ -0,0 +1,404 @@
+/*
+ * Copyright © 2017 Red Hat, Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice (including the next
+ * paragraph) shall be included in all copies or substantial portions of the
+ * Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+
+#include "config.h"
+
+#include <errno.h>
+#include <getopt.h>
+#include <inttypes.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "bench-context.h"
+#include "bench-util.h"
+
+/* A keyboard with a built-in trackpoint on one device node. Every paired
+ * touchpad listens to its keys for disable-while-typing and to its motion
+ * for palm detection, the lid switch listens to its keys. */
+struct bench {
+	struct bench_context ctx;
+	struct evdev_device *device;
+	struct libinput_event_listener *dwt;
+	struct libinput_event_listener *trackpoint;
+	struct libinput_event_listener lid;
+	unsigned int npaired;
+};
+
+struct counter {
+	unsigned int calls;	/* listener invocations */
+	unsigned int handled;	/* events the listener wanted */
+};
+
+static struct counter counter;
+
+/* The listeners as they were before they had an event mask, each one
+ * checks the event type itself */
+static void
+key_listener_filtered(uint64_t time, struct libinput_event *event, void *data)
+{
+	struct counter *c = data;
+
+	c->calls++;
+	if (event->type != LIBINPUT_EVENT_KEYBOARD_KEY)
+		return;
+	c->handled++;
+}
+
+static void
+trackpoint_listener_filtered(uint64_t time,
+			     struct libinput_event *event,
+			     void *data)
+{
+	struct counter *c = data;
+
+	c->calls++;
+	if (event->type == LIBINPUT_EVENT_POINTER_BUTTON)
+		return;
+	c->handled++;
+}
+
+static void
+listener_typed(uint64_t time, struct libinput_event *event, void *data)
+{
+	struct counter *c = data;
+
+	c->calls++;
+	c->handled++;
+}
+
+static void
+add_listener(struct bench *b,
+	     struct libinput_event_listener *listener,
+	     uint64_t mask,
+	     bool typed,
+	     void (*filtered)(uint64_t, struct libinput_event *, void *))
+{
+	libinput_device_init_event_listener(listener);
+	libinput_device_add_event_listener(&b->device->base,
+					   listener,
+					   typed ? mask : UINT64_MAX,
+					   typed ? listener_typed : filtered,
+					   &counter);
+}
+
+static void
+bench_init(struct bench *b, unsigned int npaired, bool typed)
+{
+	uint64_t key_mask, trackpoint_mask;
+	unsigned int i;
+
+	/* Same masks as tp_dwt_pair_keyboard(), tp_pair_trackpoint() and
+	 * the lid switch */
+	key_mask = event_listener_mask(LIBINPUT_EVENT_KEYBOARD_KEY);
+	trackpoint_mask = event_listener_mask(LIBINPUT_EVENT_POINTER_MOTION) |
+			  event_listener_mask(LIBINPUT_EVENT_POINTER_MOTION_ABSOLUTE) |
+			  event_listener_mask(LIBINPUT_EVENT_POINTER_AXIS);
+
+	memset(b, 0, sizeof(*b));
+	b->npaired = npaired;
+
+	b->dwt = zalloc(npaired * sizeof(*b->dwt));
+	b->trackpoint = zalloc(npaired * sizeof(*b->trackpoint));
+	if (!b->dwt || !b->trackpoint) {
+		fprintf(stderr, "Out of memory\n");
+		exit(1);
+	}
+
+	bench_context_init(&b->ctx);
+	b->device = bench_context_add_virtual_device(&b->ctx,
+						     "bench keyboard with trackpoint",
+						     EVDEV_DEVICE_KEYBOARD |
+						     EVDEV_DEVICE_POINTER);
+
+	for (i = 0; i < npaired; i++) {
+		add_listener(b, &b->dwt[i], key_mask, typed,
+			     key_listener_filtered);
+		add_listener(b, &b->trackpoint[i], trackpoint_mask, typed,
+			     trackpoint_listener_filtered);
+	}
+	add_listener(b, &b->lid, key_mask, typed, key_listener_filtered);
+}
+
+static void
+bench_fini(struct bench *b)
+{
+	unsigned int i;
+
+	for (i = 0; i < b->npaired; i++) {
+		libinput_device_remove_event_listener(&b->dwt[i]);
+		libinput_device_remove_event_listener(&b->trackpoint[i]);
+	}
+	libinput_device_remove_event_listener(&b->lid);
+
+	bench_context_remove_virtual_device(b->device);
+	bench_context_fini(&b->ctx);
+
+	free(b->dwt);
+	free(b->trackpoint);
+}
+
+/* Mostly trackpoint motion with the occasional key, button and scroll
+ * event */
+static enum libinput_event_type *
+generate_stream(unsigned int nevents)
+{
+	enum libinput_event_type *types;
+	unsigned int seed = 0x5eed;
+	unsigned int i;
+
+	types = zalloc(nevents * sizeof(*types));
+	if (!types) {
+		fprintf(stderr, "Out of memory\n");
+		exit(1);
+	}
+
+	for (i = 0; i < nevents; i++) {
+		unsigned int r = rand_r(&seed) % 100;
+
+		if (r < 80)
+			types[i] = LIBINPUT_EVENT_POINTER_MOTION;
+		else if (r < 90)
+			types[i] = LIBINPUT_EVENT_KEYBOARD_KEY;
+		else if (r < 95)
+			types[i] = LIBINPUT_EVENT_POINTER_BUTTON;
+		else
+			types[i] = LIBINPUT_EVENT_POINTER_AXIS;
+	}
+
+	return types;
+}
+
+static void
+drain(struct libinput *li)
+{
+	struct libinput_event *event;
+
+	while ((event = libinput_get_event(li)))
+		libinput_event_destroy(event);
+}
+
+/* Posts the stream through the device's notify functions, the same path
+ * the fallback dispatch takes */
+static uint64_t
+run(struct bench *b, const enum libinput_event_type *types,
+    unsigned int nevents)
+{
+	struct libinput_device *device = &b->device->base;
+	struct normalized_coords delta = { 1.0, 1.0 };
+	struct device_float_coords raw = { 1.0, 1.0 };
+	struct discrete_coords discrete = { 0, 1 };
+	bool key_down = false, button_down = false;
+	uint64_t start;
+	unsigned int i;
+
+	start = now_ns();
+
+	for (i = 0; i < nevents; i++) {
+		uint64_t time = i + 1;
+
+		switch (types[i]) {
+		case LIBINPUT_EVENT_KEYBOARD_KEY:
+			key_down = !key_down;
+			keyboard_notify_key(device, time, KEY_A,
+					    key_down ?
+					    LIBINPUT_KEY_STATE_PRESSED :
+					    LIBINPUT_KEY_STATE_RELEASED);
+			break;
+		case LIBINPUT_EVENT_POINTER_MOTION:
+			pointer_notify_motion(device, time, &delta, &raw);
+			break;
+		case LIBINPUT_EVENT_POINTER_BUTTON:
+			button_down = !button_down;
+			pointer_notify_button(device, time, BTN_LEFT,
+					      button_down ?
+					      LIBINPUT_BUTTON_STATE_PRESSED :
+					      LIBINPUT_BUTTON_STATE_RELEASED);
+			break;
+		case LIBINPUT_EVENT_POINTER_AXIS:
+			pointer_notify_axis(device, time,
+					    AS_MASK(LIBINPUT_POINTER_AXIS_SCROLL_VERTICAL),
+					    LIBINPUT_POINTER_AXIS_SOURCE_WHEEL,
+					    &delta, &discrete);
+			break;
+		default:
+			abort();
+		}
+
+		/* Keep the queue from growing, the caller would too */
+		if (i % 64 == 63)
+			drain(b->ctx.li);
+	}
+	drain(b->ctx.li);
+
+	return now_ns() - start;
+}
+
+static void
+usage(void)
+{
+	printf("Usage: %s [options]\n", program_invocation_short_name);
+	printf("\n"
+	       "Posts a generated event stream of a keyboard with a trackpoint\n"
+	       "through libinput's notify functions to the event listeners of a\n"
+	       "number of paired touchpads, once with every listener filtering\n"
+	       "the event type itself and once with typed listener masks, and\n"
+	       "prints the time per event.\n"
+	       "The typed listeners must handle exactly the events in their\n"
+	       "masks. The filtered trackpoint listener also counts keys, like\n"
+	       "the trackpoint listener did before it had a mask.\n"
+	       "\n"
+	       "Options:\n"
+	       "--devices=<int> ... number of paired touchpads (default: 16)\n"
+	       "--events=<int> .... number of events (default: 1000000)\n"
+	       "--runs=<int> ...... number of runs (default: 5)\n");
+}
+
+int
+main(int argc, char **argv)
+{
+	struct bench bench;
+	enum libinput_event_type *types;
+	unsigned int npaired = 16;
+	unsigned int nevents = 1000000;
+	int nruns = 5;
+	uint64_t best_filtered = UINT64_MAX, best_typed = UINT64_MAX;
+	struct counter filtered = { 0 }, typed = { 0 };
+	unsigned int nkeys = 0, ntrackpoint = 0, expected;
+	unsigned int i;
+	int r;
+
+	enum {
+		OPT_HELP = 1,
+		OPT_DEVICES,
+		OPT_EVENTS,
+		OPT_RUNS,
+	};
+
+	while (1) {
+		int c;
+		int option_index = 0;
+		static struct option long_options[] = {
+			{"help", 0, 0, OPT_HELP },
+			{"devices", 1, 0, OPT_DEVICES },
+			{"events", 1, 0, OPT_EVENTS },
+			{"runs", 1, 0, OPT_RUNS },
+			{0, 0, 0, 0}
+		};
+
+		c = getopt_long(argc, argv, "",
+				long_options, &option_index);
+		if (c == -1)
+			break;
+
+		switch (c) {
+		case OPT_HELP:
+			usage();
+			exit(0);
+			break;
+		case OPT_DEVICES:
+			if (atoi(optarg) <= 0) {
+				usage();
+				return 1;
+			}
+			npaired = atoi(optarg);
+			break;
+		case OPT_EVENTS:
+			if (atoi(optarg) <= 0) {
+				usage();
+				return 1;
+			}
+			nevents = atoi(optarg);
+			break;
+		case OPT_RUNS:
+			nruns = atoi(optarg);
+			if (nruns <= 0) {
+				usage();
+				return 1;
+			}
+			break;
+		default:
+			usage();
+			exit(1);
+			break;
+		}
+	}
+
+	types = generate_stream(nevents);
+
+	for (r = 0; r < nruns; r++) {
+		uint64_t t;
+
+		bench_init(&bench, npaired, false);
+		memset(&counter, 0, sizeof(counter));
+		t = run(&bench, types, nevents);
+		best_filtered = min(best_filtered, t);
+		filtered = counter;
+		bench_fini(&bench);
+
+		bench_init(&bench, npaired, true);
+		memset(&counter, 0, sizeof(counter));
+		t = run(&bench, types, nevents);
+		best_typed = min(best_typed, t);
+		typed = counter;
+		bench_fini(&bench);
+	}
+
+	printf("# %u paired devices, %u listeners\n",
+	       npaired, 2 * npaired + 1);
+	printf("# dispatch\tevents\tcalls\thandled\tbest ns/event\n");
+	printf("filtered\t%u\t%u\t%u\t%.2f\n",
+	       nevents, filtered.calls, filtered.handled,
+	       (double)best_filtered/nevents);
+	printf("typed\t%u\t%u\t%u\t%.2f\n",
+	       nevents, typed.calls, typed.handled,
+	       (double)best_typed/nevents);
+
+	for (i = 0; i < nevents; i++) {
+		switch (types[i]) {
+		case LIBINPUT_EVENT_KEYBOARD_KEY:
+			nkeys++;
+			break;
+		case LIBINPUT_EVENT_POINTER_MOTION:
+		case LIBINPUT_EVENT_POINTER_AXIS:
+			ntrackpoint++;
+			break;
+		default:
+			break;
+		}
+	}
+	free(types);
+
+	/* DWT and lid get the keys, the trackpoint listeners the motion and
+	 * scroll events */
+	expected = (npaired + 1) * nkeys + npaired * ntrackpoint;
+	if (typed.calls != expected || typed.handled != expected ||
+	    filtered.handled != expected + npaired * nkeys) {
+		fprintf(stderr, "Error: the listeners got the wrong events\n");
+		return 1;
+	}
+
+	return 0;
+}
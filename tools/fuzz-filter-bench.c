@@ -0,0 +1,267 @@
+/*
+ * Copyright © 2017 Red Hat, Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice (including the next
+ * paragraph) shall be included in all copies or substantial portions of the
+ * Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+
+#include "config.h"
+
+#include <getopt.h>
+#include <inttypes.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "libinput-util.h"
+#include "bench-util.h"
+
+/* Same layout as the tablet axes, index 0 is unused */
+#define NAXES 10
+#define AXIS_DISTANCE 3
+
+struct axis_event {
+	unsigned int axis;
+	int value;
+	bool syn; /* end of frame after this event */
+};
+
+struct stream {
+	struct axis_event *events;
+	size_t nevents;
+	unsigned int nframes;
+};
+
+/* Fuzz of a typical pen: x/y, distance, pressure, tilt, rotation, slider */
+static const int fuzz[NAXES] = { 0, 4, 4, 0, 0, 0, 0, 0, 0, 0 };
+
+/* A hovering then drawing pen: every frame updates x/y and distance or
+ * pressure, every other frame the tilt. Values jitter around a slow
+ * motion, so most of the distance and tilt updates are filtered. */
+static void
+generate_stream(struct stream *s, unsigned int nframes)
+{
+	unsigned int seed = 0x5eed;
+	unsigned int f;
+	size_t n = 0;
+
+	s->events = zalloc(nframes * 5 * sizeof(*s->events));
+	if (!s->events) {
+		fprintf(stderr, "Out of memory\n");
+		exit(1);
+	}
+
+	for (f = 0; f < nframes; f++) {
+		int jitter = (int)(rand_r(&seed) % 7) - 3;
+
+		s->events[n++] = (struct axis_event) { 1, 1000 + f + jitter, false };
+		s->events[n++] = (struct axis_event) { 2, 2000 + f/2 - jitter, false };
+		if (f % 200 < 100)
+			s->events[n++] = (struct axis_event) { AXIS_DISTANCE, 20 + jitter/2, false };
+		else
+			s->events[n++] = (struct axis_event) { 4, 500 + jitter * 10, false };
+		if (f % 2)
+			s->events[n++] = (struct axis_event) { 5, jitter/3, false };
+		s->events[n - 1].syn = true;
+	}
+
+	s->nevents = n;
+	s->nframes = nframes;
+}
+
+/* The filter as it was: one axis event at a time, the fuzz looked up
+ * for every event */
+static uint64_t
+run_per_event(const struct stream *s, unsigned int *nchanged)
+{
+	int prev_value[NAXES] = {0}, current_value[NAXES] = {0};
+	unsigned char changed[NCHARS(NAXES)];
+	uint64_t start;
+	size_t i;
+	unsigned int axis;
+
+	memset(changed, 0, sizeof(changed));
+	start = now_ns();
+
+	for (i = 0; i < s->nevents; i++) {
+		const struct axis_event *e = &s->events[i];
+		int f = fuzz[e->axis];
+
+		switch (e->axis) {
+		case AXIS_DISTANCE:
+			f = max(2, f);
+			break;
+		default:
+			break;
+		}
+
+		prev_value[e->axis] = current_value[e->axis];
+		if (abs(prev_value[e->axis] - e->value) > f) {
+			current_value[e->axis] = e->value;
+			set_bit(changed, e->axis);
+		}
+
+		if (e->syn) {
+			for (axis = 0; axis < NAXES; axis++)
+				*nchanged += bit_is_set(changed, axis);
+			memset(changed, 0, sizeof(changed));
+		}
+	}
+
+	return now_ns() - start;
+}
+
+/* The packed filter: the events only store the value, the whole frame is
+ * filtered at once */
+static uint64_t
+run_packed(const struct stream *s, unsigned int *nchanged)
+{
+	int prev_value[NAXES] = {0}, current_value[NAXES] = {0};
+	int packed_fuzz[NAXES];
+	uint64_t start;
+	size_t i;
+
+	memcpy(packed_fuzz, fuzz, sizeof(fuzz));
+	packed_fuzz[AXIS_DISTANCE] = max(2, packed_fuzz[AXIS_DISTANCE]);
+
+	start = now_ns();
+
+	for (i = 0; i < s->nevents; i++) {
+		const struct axis_event *e = &s->events[i];
+
+		current_value[e->axis] = e->value;
+
+		if (e->syn) {
+			uint32_t changed;
+
+			changed = filter_fuzz_packed(current_value,
+						     prev_value,
+						     packed_fuzz,
+						     NAXES);
+			*nchanged += __builtin_popcount(changed);
+		}
+	}
+
+	return now_ns() - start;
+}
+
+static void
+usage(void)
+{
+	printf("Usage: %s [options]\n", program_invocation_short_name);
+	printf("\n"
+	       "Runs the tablet axis fuzz filter over a generated pen stream,\n"
+	       "once per axis event and once per frame with the packed filter,\n"
+	       "and prints the time per frame. Both must accept the same\n"
+	       "number of axis changes.\n"
+	       "\n"
+	       "Options:\n"
+	       "--frames=<int> ... number of frames (default: 1000000)\n"
+	       "--runs=<int> ..... number of runs (default: 5)\n");
+}
+
+int
+main(int argc, char **argv)
+{
+	struct stream stream = { 0 };
+	unsigned int nframes = 1000000;
+	int nruns = 5;
+	uint64_t best_event = UINT64_MAX, best_packed = UINT64_MAX;
+	unsigned int changed_event = 0, changed_packed = 0;
+	int r;
+
+	enum {
+		OPT_HELP = 1,
+		OPT_FRAMES,
+		OPT_RUNS,
+	};
+
+	while (1) {
+		int c;
+		int option_index = 0;
+		static struct option long_options[] = {
+			{"help", 0, 0, OPT_HELP },
+			{"frames", 1, 0, OPT_FRAMES },
+			{"runs", 1, 0, OPT_RUNS },
+			{0, 0, 0, 0}
+		};
+
+		c = getopt_long(argc, argv, "",
+				long_options, &option_index);
+		if (c == -1)
+			break;
+
+		switch (c) {
+		case OPT_HELP:
+			usage();
+			exit(0);
+			break;
+		case OPT_FRAMES:
+			if (atoi(optarg) <= 0) {
+				usage();
+				return 1;
+			}
+			nframes = atoi(optarg);
+			break;
+		case OPT_RUNS:
+			nruns = atoi(optarg);
+			if (nruns <= 0) {
+				usage();
+				return 1;
+			}
+			break;
+		default:
+			usage();
+			exit(1);
+			break;
+		}
+	}
+
+	generate_stream(&stream, nframes);
+
+	for (r = 0; r < nruns; r++) {
+		uint64_t t;
+
+		changed_event = 0;
+		changed_packed = 0;
+		t = run_per_event(&stream, &changed_event);
+		best_event = min(best_event, t);
+		t = run_packed(&stream, &changed_packed);
+		best_packed = min(best_packed, t);
+	}
+
+	printf("# filter\tframes\tchanged axes\tbest ns/frame\n");
+	printf("per-event\t%u\t%u\t%.2f\n",
+	       stream.nframes, changed_event,
+	       (double)best_event/stream.nframes);
+	printf("packed\t%u\t%u\t%.2f\n",
+	       stream.nframes, changed_packed,
+	       (double)best_packed/stream.nframes);
+
+	free(stream.events);
+
+	if (changed_event != changed_packed) {
+		fprintf(stderr, "Error: the filters disagree\n");
+		return 1;
+	}
+
+	return 0;
+}
@@ -491,6 +491,9 @@ print_tablet_axis_event(struct libinput_event *ev)
 
 	print_event_time(libinput_event_tablet_tool_get_time(t));
 	print_tablet_axes(t);
+	if (libinput_event_tablet_tool_get_history_size(t) > 0)
+		printq(" (%u batched)",
+		       libinput_event_tablet_tool_get_history_size(t));
 	printq("\n");
 }
 
@@ -0,0 +1,333 @@
+/*
+ * Copyright © 2017 Red Hat, Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice (including the next
+ * paragraph) shall be included in all copies or substantial portions of the
+ * Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+
+#include "config.h"
+
+#include <errno.h>
+#include <getopt.h>
+#include <inttypes.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "bench-context.h"
+#include "bench-util.h"
+
+struct device_class {
+	const char *name;
+	enum evdev_device_seat_capability seat_caps;
+	enum libinput_device_capability cap;
+	enum libinput_event_type type;
+};
+
+static const struct device_class classes[] = {
+	{ "keyboard", EVDEV_DEVICE_KEYBOARD, LIBINPUT_DEVICE_CAP_KEYBOARD,
+	  LIBINPUT_EVENT_KEYBOARD_KEY },
+	{ "pointer", EVDEV_DEVICE_POINTER, LIBINPUT_DEVICE_CAP_POINTER,
+	  LIBINPUT_EVENT_POINTER_MOTION },
+	{ "touch", EVDEV_DEVICE_TOUCH, LIBINPUT_DEVICE_CAP_TOUCH,
+	  LIBINPUT_EVENT_TOUCH_MOTION },
+	{ "gesture", EVDEV_DEVICE_POINTER|EVDEV_DEVICE_GESTURE,
+	  LIBINPUT_DEVICE_CAP_GESTURE, LIBINPUT_EVENT_GESTURE_SWIPE_UPDATE },
+	{ "switch", EVDEV_DEVICE_SWITCH, LIBINPUT_DEVICE_CAP_SWITCH,
+	  LIBINPUT_EVENT_SWITCH_TOGGLE },
+	{ "tablet-tool", EVDEV_DEVICE_TABLET, LIBINPUT_DEVICE_CAP_TABLET_TOOL,
+	  LIBINPUT_EVENT_TABLET_TOOL_AXIS },
+};
+
+struct bench {
+	struct bench_context ctx;
+	struct evdev_device *device;
+	struct libinput_tablet_tool *tool; /* tablet-tool class only */
+	unsigned int nreceived;	/* events of the class's type */
+	unsigned int nmissing;	/* failed capability checks */
+};
+
+static void
+bench_init(struct bench *b, const struct device_class *class)
+{
+	memset(b, 0, sizeof(*b));
+
+	bench_context_init(&b->ctx);
+	b->device = bench_context_add_virtual_device(&b->ctx, "bench device",
+						     class->seat_caps);
+
+	if (class->cap == LIBINPUT_DEVICE_CAP_TABLET_TOOL) {
+		b->tool = zalloc(sizeof(*b->tool));
+		if (!b->tool) {
+			fprintf(stderr, "Out of memory\n");
+			exit(1);
+		}
+
+		/* A pen without serial, the events hold their own
+		 * references */
+		b->tool->type = LIBINPUT_TABLET_TOOL_TYPE_PEN;
+		b->tool->refcount = 1;
+		list_init(&b->tool->link);
+	}
+}
+
+static void
+bench_fini(struct bench *b)
+{
+	if (b->tool)
+		libinput_tablet_tool_unref(b->tool);
+	bench_context_remove_virtual_device(b->device);
+	bench_context_fini(&b->ctx);
+}
+
+static void
+drain(struct bench *b, enum libinput_event_type type)
+{
+	struct libinput_event *event;
+
+	while ((event = libinput_get_event(b->ctx.li))) {
+		if (libinput_event_get_type(event) == type)
+			b->nreceived++;
+		libinput_event_destroy(event);
+	}
+}
+
+static void
+notify(struct bench *b,
+       const struct device_class *class,
+       uint64_t time)
+{
+	struct libinput_device *device = &b->device->base;
+	struct normalized_coords delta = { 1.0, 1.0 };
+	struct device_float_coords raw = { 1.0, 1.0 };
+	struct device_coords point = { 100, 100 };
+	struct ellipse area = { 0, 0, 0 };
+	struct tablet_axes axes = { .point = point, .pressure = 0.5 };
+	unsigned char changed_axes[NCHARS(LIBINPUT_TABLET_TOOL_AXIS_MAX + 1)] = { 0 };
+
+	switch (class->cap) {
+	case LIBINPUT_DEVICE_CAP_KEYBOARD:
+		keyboard_notify_key(device, time, KEY_A,
+				    (time & 1) ?
+				    LIBINPUT_KEY_STATE_PRESSED :
+				    LIBINPUT_KEY_STATE_RELEASED);
+		break;
+	case LIBINPUT_DEVICE_CAP_POINTER:
+		pointer_notify_motion(device, time, &delta, &raw);
+		break;
+	case LIBINPUT_DEVICE_CAP_TOUCH:
+		touch_notify_touch_motion(device, time, 0, 0,
+					  &point, &area, 0, &raw);
+		break;
+	case LIBINPUT_DEVICE_CAP_GESTURE:
+		gesture_notify_swipe(device, time,
+				     LIBINPUT_EVENT_GESTURE_SWIPE_UPDATE,
+				     3, &delta, &delta);
+		break;
+	case LIBINPUT_DEVICE_CAP_SWITCH:
+		switch_notify_toggle(device, time, LIBINPUT_SWITCH_LID,
+				     (time & 1) ?
+				     LIBINPUT_SWITCH_STATE_ON :
+				     LIBINPUT_SWITCH_STATE_OFF);
+		break;
+	case LIBINPUT_DEVICE_CAP_TABLET_TOOL:
+		set_bit(changed_axes, LIBINPUT_TABLET_TOOL_AXIS_X);
+		set_bit(changed_axes, LIBINPUT_TABLET_TOOL_AXIS_Y);
+		set_bit(changed_axes, LIBINPUT_TABLET_TOOL_AXIS_PRESSURE);
+		tablet_notify_axis(device, time, b->tool,
+				   LIBINPUT_TABLET_TOOL_TIP_DOWN,
+				   changed_axes, &axes, NULL, 0);
+		break;
+	default:
+		abort();
+	}
+}
+
+/* Posts nevents through the class's notify function, the same path the
+ * dispatch takes */
+static uint64_t
+run_notify(struct bench *b, const struct device_class *class,
+	   unsigned int nevents)
+{
+	uint64_t start;
+	unsigned int i;
+
+	start = now_ns();
+
+	for (i = 0; i < nevents; i++) {
+		notify(b, class, i + 1);
+
+		/* Keep the queue from growing, the caller would too */
+		if (i % 64 == 63)
+			drain(b, class->type);
+	}
+	drain(b, class->type);
+
+	return now_ns() - start;
+}
+
+/* The capability check alone, once through the exported
+ * libinput_device_has_capability() with the capability only known at
+ * runtime and once through the inline check the notify functions use */
+static uint64_t
+run_check(struct bench *b, const struct device_class *class,
+	  bool exported, unsigned int nevents)
+{
+	struct libinput_device *device = &b->device->base;
+	volatile unsigned int nfound = 0;
+	uint64_t start;
+	unsigned int i;
+
+	start = now_ns();
+
+	if (exported) {
+		for (i = 0; i < nevents; i++)
+			if (libinput_device_has_capability(device, class->cap))
+				nfound++;
+	} else {
+		for (i = 0; i < nevents; i++)
+			if (evdev_device_has_capability(b->device, class->cap))
+				nfound++;
+	}
+
+	if (nfound != nevents)
+		b->nmissing += nevents - nfound;
+
+	return now_ns() - start;
+}
+
+static void
+usage(void)
+{
+	printf("Usage: %s [options]\n", program_invocation_short_name);
+	printf("\n"
+	       "Posts events through libinput's notify function of each device\n"
+	       "class and prints the time per event. Also times the capability\n"
+	       "check alone, once through the exported\n"
+	       "libinput_device_has_capability() and once through the inline\n"
+	       "check the notify functions use.\n"
+	       "Every event must reach the queue, none may be dropped by the\n"
+	       "capability check.\n"
+	       "\n"
+	       "Options:\n"
+	       "--events=<int> ... number of events (default: 1000000)\n"
+	       "--runs=<int> ..... number of runs (default: 5)\n");
+}
+
+int
+main(int argc, char **argv)
+{
+	unsigned int nevents = 1000000;
+	int nruns = 5;
+	size_t c;
+	int r;
+
+	enum {
+		OPT_HELP = 1,
+		OPT_EVENTS,
+		OPT_RUNS,
+	};
+
+	while (1) {
+		int opt;
+		int option_index = 0;
+		static struct option long_options[] = {
+			{"help", 0, 0, OPT_HELP },
+			{"events", 1, 0, OPT_EVENTS },
+			{"runs", 1, 0, OPT_RUNS },
+			{0, 0, 0, 0}
+		};
+
+		opt = getopt_long(argc, argv, "",
+				  long_options, &option_index);
+		if (opt == -1)
+			break;
+
+		switch (opt) {
+		case OPT_HELP:
+			usage();
+			exit(0);
+			break;
+		case OPT_EVENTS:
+			if (atoi(optarg) <= 0) {
+				usage();
+				return 1;
+			}
+			nevents = atoi(optarg);
+			break;
+		case OPT_RUNS:
+			nruns = atoi(optarg);
+			if (nruns <= 0) {
+				usage();
+				return 1;
+			}
+			break;
+		default:
+			usage();
+			exit(1);
+			break;
+		}
+	}
+
+	printf("# class\tevents\tnotify ns/event\t"
+	       "exported check ns\tinline check ns\n");
+
+	for (c = 0; c < ARRAY_LENGTH(classes); c++) {
+		const struct device_class *class = &classes[c];
+		struct bench bench;
+		uint64_t best_notify = UINT64_MAX,
+			 best_exported = UINT64_MAX,
+			 best_inline = UINT64_MAX;
+
+		for (r = 0; r < nruns; r++) {
+			uint64_t t;
+			unsigned int nreceived, nmissing;
+
+			bench_init(&bench, class);
+
+			t = run_notify(&bench, class, nevents);
+			best_notify = min(best_notify, t);
+			t = run_check(&bench, class, true, nevents);
+			best_exported = min(best_exported, t);
+			t = run_check(&bench, class, false, nevents);
+			best_inline = min(best_inline, t);
+
+			nreceived = bench.nreceived;
+			nmissing = bench.nmissing;
+			bench_fini(&bench);
+
+			if (nreceived != nevents || nmissing != 0) {
+				fprintf(stderr,
+					"Error: %s events were dropped\n",
+					class->name);
+				return 1;
+			}
+		}
+
+		printf("%s\t%u\t%.2f\t%.2f\t%.2f\n",
+		       class->name, nevents,
+		       (double)best_notify/nevents,
+		       (double)best_exported/nevents,
+		       (double)best_inline/nevents);
+	}
+
+	return 0;
+}
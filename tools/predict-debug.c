@@ -0,0 +1,418 @@
+/*
+ * Copyright © 2017 Red Hat, Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice (including the next
+ * paragraph) shall be included in all copies or substantial portions of the
+ * Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+
+#include "config.h"
+
+#include <errno.h>
+#include <getopt.h>
+#include <inttypes.h>
+#include <math.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "filter.h"
+#include "libinput-util.h"
+
+#define MAX_SLOTS 64
+#define MAX_INTERVALS 8
+
+struct sample {
+	struct device_float_coords point;
+	uint64_t time;
+};
+
+/* One touch or one burst of pointer motion */
+struct trace {
+	struct sample *samples;
+	size_t nsamples;
+	size_t size;
+};
+
+struct score {
+	uint64_t interval;
+	unsigned int count;
+	double sum, sumsq, max;
+	double sum_none, sumsq_none, max_none;
+};
+
+struct slot {
+	bool active;
+	bool dirty;
+	struct device_float_coords point;
+	struct trace trace;
+};
+
+struct context {
+	struct score scores[MAX_INTERVALS];
+	size_t nscores;
+
+	struct slot slots[MAX_SLOTS];
+	int current_slot;
+	bool is_mt;
+
+	/* ABS_X/ABS_Y and BTN_TOUCH for single-touch devices, REL_X/REL_Y
+	 * for pointer devices, both use slot 0 */
+	bool is_relative;
+};
+
+static void
+trace_append(struct trace *trace, const struct device_float_coords *point,
+	     uint64_t time)
+{
+	if (trace->nsamples == trace->size) {
+		trace->size = trace->size ? trace->size * 2 : 256;
+		trace->samples = realloc(trace->samples,
+					 trace->size * sizeof(*trace->samples));
+		if (!trace->samples) {
+			fprintf(stderr, "Out of memory\n");
+			exit(1);
+		}
+	}
+
+	trace->samples[trace->nsamples].point = *point;
+	trace->samples[trace->nsamples].time = time;
+	trace->nsamples++;
+}
+
+static struct device_float_coords
+trace_position_at(const struct trace *trace, size_t *idx, uint64_t time)
+{
+	const struct sample *a, *b;
+	struct device_float_coords p;
+	double frac;
+
+	while (*idx + 1 < trace->nsamples &&
+	       trace->samples[*idx + 1].time < time)
+		(*idx)++;
+
+	a = &trace->samples[*idx];
+	b = &trace->samples[*idx + 1];
+	if (b->time == a->time)
+		return b->point;
+
+	frac = (double)(time - a->time)/(b->time - a->time);
+
+	p.x = a->point.x + (b->point.x - a->point.x) * frac;
+	p.y = a->point.y + (b->point.y - a->point.y) * frac;
+
+	return p;
+}
+
+static void
+score_trace(struct context *ctx, struct trace *trace)
+{
+	struct motion_predictor predictor;
+	size_t cursor[MAX_INTERVALS] = {0};
+	size_t i, s;
+
+	motion_predictor_reset(&predictor);
+
+	for (i = 0; i < trace->nsamples; i++) {
+		const struct sample *sample = &trace->samples[i];
+		struct device_float_coords velocity;
+
+		motion_predictor_push(&predictor, &sample->point, sample->time);
+		velocity = motion_predictor_velocity(&predictor);
+
+		for (s = 0; s < ctx->nscores; s++) {
+			struct score *score = &ctx->scores[s];
+			uint64_t target = sample->time + score->interval;
+			struct device_float_coords actual;
+			double err, err_none;
+
+			/* We can only score what the trace still covers */
+			if (target > trace->samples[trace->nsamples - 1].time)
+				continue;
+
+			if (cursor[s] < i)
+				cursor[s] = i;
+			actual = trace_position_at(trace, &cursor[s], target);
+
+			err = hypot(sample->point.x + velocity.x * score->interval - actual.x,
+				    sample->point.y + velocity.y * score->interval - actual.y);
+			err_none = hypot(sample->point.x - actual.x,
+					 sample->point.y - actual.y);
+
+			score->count++;
+			score->sum += err;
+			score->sumsq += err * err;
+			score->max = max(score->max, err);
+			score->sum_none += err_none;
+			score->sumsq_none += err_none * err_none;
+			score->max_none = max(score->max_none, err_none);
+		}
+	}
+
+	trace->nsamples = 0;
+}
+
+static void
+slot_end(struct context *ctx, struct slot *slot)
+{
+	score_trace(ctx, &slot->trace);
+	slot->active = false;
+	slot->dirty = false;
+}
+
+static void
+handle_frame(struct context *ctx, uint64_t time)
+{
+	int i;
+
+	for (i = 0; i < MAX_SLOTS; i++) {
+		struct slot *slot = &ctx->slots[i];
+		struct trace *trace = &slot->trace;
+
+		if (!slot->active || !slot->dirty)
+			continue;
+
+		/* A pause ends the trace, we can't interpolate over it */
+		if (trace->nsamples > 0 &&
+		    time - trace->samples[trace->nsamples - 1].time > MOTION_PREDICTOR_TIMEOUT)
+			score_trace(ctx, trace);
+
+		trace_append(trace, &slot->point, time);
+		slot->dirty = false;
+	}
+}
+
+static void
+handle_event(struct context *ctx, uint64_t time,
+	     unsigned int type, unsigned int code, int value)
+{
+	struct slot *slot = &ctx->slots[ctx->current_slot];
+
+	switch (type) {
+	case EV_SYN:
+		if (code == SYN_REPORT)
+			handle_frame(ctx, time);
+		break;
+	case EV_REL:
+		if (code != REL_X && code != REL_Y)
+			break;
+		ctx->is_relative = true;
+		slot = &ctx->slots[0];
+		slot->active = true;
+		slot->dirty = true;
+		if (code == REL_X)
+			slot->point.x += value;
+		else
+			slot->point.y += value;
+		break;
+	case EV_KEY:
+		if (code != BTN_TOUCH || ctx->is_mt)
+			break;
+		slot = &ctx->slots[0];
+		if (value)
+			slot->active = true;
+		else
+			slot_end(ctx, slot);
+		break;
+	case EV_ABS:
+		switch (code) {
+		case ABS_MT_SLOT:
+			ctx->is_mt = true;
+			if (value >= 0 && value < MAX_SLOTS)
+				ctx->current_slot = value;
+			break;
+		case ABS_MT_TRACKING_ID:
+			ctx->is_mt = true;
+			if (value == -1)
+				slot_end(ctx, slot);
+			else
+				slot->active = true;
+			break;
+		case ABS_MT_POSITION_X:
+			slot->point.x = value;
+			slot->dirty = true;
+			break;
+		case ABS_MT_POSITION_Y:
+			slot->point.y = value;
+			slot->dirty = true;
+			break;
+		case ABS_X:
+		case ABS_Y:
+			if (ctx->is_mt)
+				break;
+			slot = &ctx->slots[0];
+			if (code == ABS_X)
+				slot->point.x = value;
+			else
+				slot->point.y = value;
+			slot->dirty = true;
+			break;
+		}
+		break;
+	}
+}
+
+static int
+read_recording(struct context *ctx, FILE *fp)
+{
+	char line[256];
+	int nevents = 0;
+
+	while (fgets(line, sizeof(line), fp)) {
+		unsigned long sec, usec;
+		unsigned int type, code;
+		int value;
+
+		/* evemu-record event lines, everything else is ignored */
+		if (sscanf(line, "E: %lu.%lu %x %x %d",
+			   &sec, &usec, &type, &code, &value) != 5)
+			continue;
+
+		handle_event(ctx, s2us(sec) + usec, type, code, value);
+		nevents++;
+	}
+
+	return nevents;
+}
+
+static void
+print_scores(struct context *ctx)
+{
+	size_t i;
+
+	printf("# Prediction error in %s, 'none' is the error without prediction\n",
+	       ctx->is_relative ? "accumulated REL_X/REL_Y counts" : "device units");
+	printf("# interval(ms)\tsamples\tmean\trms\tmax\tmean(none)\trms(none)\tmax(none)\n");
+
+	for (i = 0; i < ctx->nscores; i++) {
+		struct score *s = &ctx->scores[i];
+
+		if (s->count == 0) {
+			printf("%.1f\t0\n", s->interval/1000.0);
+			continue;
+		}
+
+		printf("%.1f\t%u\t%.3f\t%.3f\t%.3f\t%.3f\t%.3f\t%.3f\n",
+		       s->interval/1000.0,
+		       s->count,
+		       s->sum/s->count,
+		       sqrt(s->sumsq/s->count),
+		       s->max,
+		       s->sum_none/s->count,
+		       sqrt(s->sumsq_none/s->count),
+		       s->max_none);
+	}
+}
+
+static void
+usage(void)
+{
+	printf("Usage: %s [options] [recording]\n", program_invocation_short_name);
+	printf("\n"
+	       "Replays an evemu-record recording through the motion predictor and\n"
+	       "prints the prediction error for each interval. Touches are taken from\n"
+	       "ABS_MT_POSITION_X/Y or ABS_X/Y, pointer motion from REL_X/Y.\n"
+	       "If no recording is given, it is read from stdin.\n"
+	       "\n"
+	       "Options:\n"
+	       "--interval=<double> ... predict this many ms ahead, may be given up to\n"
+	       "                        %d times (default: 4, 8 and 16)\n",
+	       MAX_INTERVALS);
+}
+
+int
+main(int argc, char **argv)
+{
+	struct context ctx = { .current_slot = 0 };
+	FILE *fp = stdin;
+	int i;
+
+	enum {
+		OPT_HELP = 1,
+		OPT_INTERVAL,
+	};
+
+	while (1) {
+		int c;
+		int option_index = 0;
+		double ms;
+		static struct option long_options[] = {
+			{"help", 0, 0, OPT_HELP },
+			{"interval", 1, 0, OPT_INTERVAL },
+			{0, 0, 0, 0}
+		};
+
+		c = getopt_long(argc, argv, "",
+				long_options, &option_index);
+		if (c == -1)
+			break;
+
+		switch (c) {
+		case OPT_HELP:
+			usage();
+			exit(0);
+			break;
+		case OPT_INTERVAL:
+			ms = strtod(optarg, NULL);
+			if (ms <= 0.0 || ctx.nscores == MAX_INTERVALS) {
+				usage();
+				return 1;
+			}
+			ctx.scores[ctx.nscores++].interval = ms * 1000;
+			break;
+		default:
+			usage();
+			exit(1);
+			break;
+		}
+	}
+
+	if (ctx.nscores == 0) {
+		ctx.scores[0].interval = ms2us(4);
+		ctx.scores[1].interval = ms2us(8);
+		ctx.scores[2].interval = ms2us(16);
+		ctx.nscores = 3;
+	}
+
+	if (optind < argc) {
+		fp = fopen(argv[optind], "r");
+		if (!fp) {
+			fprintf(stderr, "Failed to open %s: %s\n",
+				argv[optind], strerror(errno));
+			return 1;
+		}
+	}
+
+	if (read_recording(&ctx, fp) == 0) {
+		fprintf(stderr, "No events found, expected an evemu-record recording\n");
+		return 1;
+	}
+
+	for (i = 0; i < MAX_SLOTS; i++) {
+		score_trace(&ctx, &ctx.slots[i].trace);
+		free(ctx.slots[i].trace.samples);
+	}
+
+	print_scores(&ctx);
+
+	if (fp != stdin)
+		fclose(fp);
+
+	return 0;
+}
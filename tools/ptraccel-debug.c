@@ -25,15 +25,18 @@
 
 #include <assert.h>
 #include <errno.h>
+#include <inttypes.h>
 #include <stdbool.h>
 #include <stdio.h>
 #include <getopt.h>
 #include <stdlib.h>
 #include <string.h>
+#include <time.h>
 #include <unistd.h>
 
 #include "filter.h"
 #include "libinput-util.h"
+#include "bench-util.h"
 
 static void
 print_ptraccel_deltas(struct motion_filter *filter, double step)
@@ -114,12 +117,14 @@ print_ptraccel_sequence(struct motion_filter *filter,
 			int nevents,
 			double *deltas)
 {
-	struct device_float_coords motion;
-	struct normalized_coords accel;
+	struct device_float_coords motion[1024];
+	struct normalized_coords accel[1024];
+	uint64_t times[1024];
 	uint64_t time = 0;
-	double *dx;
 	int i;
 
+	assert(nevents <= (int)ARRAY_LENGTH(motion));
+
 	printf("# gnuplot:\n");
 	printf("# set xlabel \"event number\"\n");
 	printf("# set ylabel \"delta motion\"\n");
@@ -128,17 +133,17 @@ print_ptraccel_sequence(struct motion_filter *filter,
 	printf("#      \"gnuplot.data\" using 1:3 title \"dx in\"\n");
 	printf("#\n");
 
-	dx = deltas;
-
-	for (i = 0; i < nevents; i++, dx++) {
-		motion.x = *dx;
-		motion.y = 0;
+	for (i = 0; i < nevents; i++) {
+		motion[i].x = deltas[i];
+		motion[i].y = 0;
 		time += us(12500); /* pretend 80Hz data */
+		times[i] = time;
+	}
 
-		accel = filter_dispatch(filter, &motion, NULL, time);
+	filter_dispatch_batch(filter, motion, NULL, times, accel, nevents);
 
-		printf("%d	%.3f	%.3f\n", i, accel.x, *dx);
-	}
+	for (i = 0; i < nevents; i++)
+		printf("%d	%.3f	%.3f\n", i, accel[i].x, deltas[i]);
 }
 
 /* mm/s → units/µs */
@@ -169,27 +174,299 @@ print_accel_func(struct motion_filter *filter,
 	}
 }
 
+static const struct filter_type {
+	const char *name;
+	struct motion_filter *(*create)(int dpi);
+	accel_profile_func_t profile;
+} filter_types[] = {
+	{ "linear", create_pointer_accelerator_filter_linear,
+	  pointer_accel_profile_linear },
+	{ "low-dpi", create_pointer_accelerator_filter_linear_low_dpi,
+	  pointer_accel_profile_linear_low_dpi },
+	{ "touchpad", create_pointer_accelerator_filter_touchpad,
+	  touchpad_accel_profile_linear },
+	{ "x230", create_pointer_accelerator_filter_lenovo_x230,
+	  touchpad_lenovo_x230_accel_profile },
+	{ "trackpoint", create_pointer_accelerator_filter_trackpoint,
+	  trackpoint_accel_profile },
+	{ "flat", create_pointer_accelerator_filter_flat, NULL },
+};
+
+static const struct filter_type *
+find_filter_type(const char *name)
+{
+	size_t i;
+
+	for (i = 0; i < ARRAY_LENGTH(filter_types); i++) {
+		if (streq(filter_types[i].name, name))
+			return &filter_types[i];
+	}
+
+	return NULL;
+}
+
+enum benchmark_stream {
+	STREAM_CONSTANT,
+	STREAM_ACCELERATING,
+	STREAM_JITTERY,
+	STREAM_8KHZ,
+	STREAM_RECORDED,
+};
+
+static const char *benchmark_stream_names[] = {
+	[STREAM_CONSTANT] = "constant",
+	[STREAM_ACCELERATING] = "accelerating",
+	[STREAM_JITTERY] = "jittery",
+	[STREAM_8KHZ] = "8khz",
+	[STREAM_RECORDED] = "recorded",
+};
+
+/* Deterministic so runs are comparable */
+static inline unsigned int
+benchmark_rand(unsigned int *seed)
+{
+	*seed = *seed * 1103515245 + 12345;
+	return (*seed >> 16) & 0x7fff;
+}
+
+static void
+benchmark_fill_stream(enum benchmark_stream stream,
+		      struct device_float_coords *motion,
+		      uint64_t *times,
+		      int nevents,
+		      const double *recorded,
+		      int nrecorded)
+{
+	unsigned int seed = 1;
+	uint64_t time = 0;
+	int i;
+
+	for (i = 0; i < nevents; i++) {
+		switch (stream) {
+		case STREAM_CONSTANT:
+			motion[i].x = 5;
+			motion[i].y = 0;
+			time += ms2us(1);
+			break;
+		case STREAM_ACCELERATING:
+			/* ramp from 0 to 40 units per event, then start over */
+			motion[i].x = (i % 400) / 10;
+			motion[i].y = 0;
+			time += ms2us(1);
+			break;
+		case STREAM_JITTERY:
+			motion[i].x = (int)(benchmark_rand(&seed) % 7) - 3;
+			motion[i].y = (int)(benchmark_rand(&seed) % 7) - 3;
+			time += 500 + benchmark_rand(&seed) % 1000;
+			break;
+		case STREAM_8KHZ:
+			motion[i].x = 1;
+			motion[i].y = i % 2;
+			time += 125;
+			break;
+		case STREAM_RECORDED:
+			motion[i].x = recorded[i % nrecorded];
+			motion[i].y = 0;
+			time += us(12500); /* pretend 80Hz data */
+			break;
+		}
+		times[i] = time;
+	}
+}
+
+/* Allocations made while counting. The tool is linked with
+ * -Wl,--wrap for the allocator, so only the calls from the tool and the
+ * statically linked filter end up in these wrappers, libinput and libc
+ * keep the real allocator. */
+static bool count_allocations;
+static long nallocations;
+
+void *__real_malloc(size_t size);
+void *__real_calloc(size_t nmemb, size_t size);
+void *__real_realloc(void *ptr, size_t size);
+
+void *__wrap_malloc(size_t size);
+void *__wrap_calloc(size_t nmemb, size_t size);
+void *__wrap_realloc(void *ptr, size_t size);
+
+void *
+__wrap_malloc(size_t size)
+{
+	if (count_allocations)
+		nallocations++;
+	return __real_malloc(size);
+}
+
+void *
+__wrap_calloc(size_t nmemb, size_t size)
+{
+	if (count_allocations)
+		nallocations++;
+	return __real_calloc(nmemb, size);
+}
+
+void *
+__wrap_realloc(void *ptr, size_t size)
+{
+	if (count_allocations)
+		nallocations++;
+	return __real_realloc(ptr, size);
+}
+
+static inline void
+allocations_start(void)
+{
+	nallocations = 0;
+	count_allocations = true;
+}
+
+static inline long
+allocations_stop(void)
+{
+	count_allocations = false;
+	return nallocations;
+}
+
+static void
+benchmark_run(const struct filter_type *type,
+	      enum benchmark_stream stream,
+	      int dpi,
+	      double speed,
+	      enum velocity_estimator estimator,
+	      const struct device_float_coords *motion,
+	      const uint64_t *times,
+	      int nevents)
+{
+	struct motion_filter *filter;
+	struct normalized_coords accel;
+	uint64_t start, ns;
+	double sum = 0.0;
+	long allocs;
+	int misses_fd, instructions_fd;
+	int64_t misses, instructions;
+	int i;
+
+	filter = type->create(dpi);
+	assert(filter != NULL);
+	filter_set_speed(filter, speed);
+	filter_set_velocity_estimator(filter, estimator);
+
+	misses_fd = perf_counter_open(PERF_COUNT_HW_CACHE_MISSES);
+	instructions_fd = perf_counter_open(PERF_COUNT_HW_INSTRUCTIONS);
+
+	perf_counter_ctl(misses_fd, PERF_EVENT_IOC_RESET);
+	perf_counter_ctl(instructions_fd, PERF_EVENT_IOC_RESET);
+	perf_counter_ctl(misses_fd, PERF_EVENT_IOC_ENABLE);
+	perf_counter_ctl(instructions_fd, PERF_EVENT_IOC_ENABLE);
+	allocations_start();
+	start = now_ns();
+
+	for (i = 0; i < nevents; i++) {
+		accel = filter_dispatch(filter, &motion[i], NULL, times[i]);
+		sum += accel.x + accel.y;
+	}
+
+	ns = now_ns() - start;
+	allocs = allocations_stop();
+	perf_counter_ctl(misses_fd, PERF_EVENT_IOC_DISABLE);
+	perf_counter_ctl(instructions_fd, PERF_EVENT_IOC_DISABLE);
+
+	misses = perf_counter_read(misses_fd);
+	instructions = perf_counter_read(instructions_fd);
+	perf_counter_close(misses_fd);
+	perf_counter_close(instructions_fd);
+
+	/* The sum is printed so the loop can't be optimized away */
+	printf("%s\t%s\t%d\t%.2f\t%ld\t%" PRId64 "\t%" PRId64 "\t%.1f\n",
+	       type->name,
+	       benchmark_stream_names[stream],
+	       nevents,
+	       (double)ns/nevents,
+	       allocs,
+	       misses,
+	       instructions,
+	       sum);
+
+	filter_destroy(filter);
+}
+
+static void
+print_benchmark(const struct filter_type *only,
+		int nevents,
+		int dpi,
+		double speed,
+		enum velocity_estimator estimator,
+		const double *recorded,
+		int nrecorded)
+{
+	struct device_float_coords *motion;
+	uint64_t *times;
+	enum benchmark_stream stream;
+	size_t i;
+
+	motion = zalloc(nevents * sizeof(*motion));
+	times = zalloc(nevents * sizeof(*times));
+	if (!motion || !times) {
+		fprintf(stderr, "Failed to allocate %d events\n", nevents);
+		free(motion);
+		free(times);
+		return;
+	}
+
+	printf("# ptraccel-debug benchmark, dpi %d speed %.2f estimator %s\n",
+	       dpi, speed,
+	       estimator == VELOCITY_ESTIMATOR_TRACKERS ? "trackers" : "incremental");
+	printf("# allocs: allocations during the run\n");
+	printf("# cache-misses, instructions: -1 if perf_event_open is unavailable\n");
+	printf("# filter\tstream\tevents\tns/event\tallocs\tcache-misses\tinstructions\tchecksum\n");
+
+	for (stream = STREAM_CONSTANT; stream <= STREAM_RECORDED; stream++) {
+		if (stream == STREAM_RECORDED && nrecorded == 0)
+			continue;
+
+		benchmark_fill_stream(stream, motion, times, nevents,
+				      recorded, nrecorded);
+
+		for (i = 0; i < ARRAY_LENGTH(filter_types); i++) {
+			if (only && only != &filter_types[i])
+				continue;
+
+			benchmark_run(&filter_types[i], stream, dpi, speed,
+				      estimator, motion, times, nevents);
+		}
+	}
+
+	free(motion);
+	free(times);
+}
+
 static void
 usage(void)
 {
 	printf("Usage: %s [options] [dx1] [dx2] [...] > gnuplot.data\n", program_invocation_short_name);
 	printf("\n"
 	       "Options:\n"
-	       "--mode=<motion|accel|delta|sequence> \n"
+	       "--mode=<motion|accel|delta|sequence|benchmark> \n"
 	       "	motion   ... print motion to accelerated motion (default)\n"
 	       "	delta    ... print delta to accelerated delta\n"
 	       "	accel    ... print accel factor\n"
 	       "	sequence ... print motion for custom delta sequence\n"
+	       "	benchmark... time the filters on synthetic delta streams\n"
+	       "--nevents=<int>   ... in motion and benchmark modes only. Number of events\n"
 	       "--maxdx=<double>  ... in motion mode only. Stop increasing dx at maxdx\n"
 	       "--steps=<double>  ... in motion and delta modes only. Increase dx by step each round\n"
 	       "--speed=<double>  ... accel speed [-1, 1], default 0\n"
 	       "--dpi=<int>	... device resolution in DPI (default: 1000)\n"
-	       "--filter=<linear|low-dpi|touchpad|x230|trackpoint> \n"
+	       "--filter=<linear|low-dpi|touchpad|x230|trackpoint|flat> \n"
 	       "	linear	  ... the default motion filter\n"
 	       "	low-dpi	  ... low-dpi filter, use --dpi with this argument\n"
 	       "	touchpad  ... the touchpad motion filter\n"
 	       "	x230  	  ... custom filter for the Lenovo x230 touchpad\n"
 	       "	trackpoint... trackpoint motion filter\n"
+	       "	flat      ... flat acceleration, not available in accel mode\n"
+	       "--estimator=<trackers|incremental> \n"
+	       "	trackers    ... walk the tracker history per event (default)\n"
+	       "	incremental ... running sums, O(1) per event\n"
 	       "\n"
 	       "If extra arguments are present and mode is not given, mode defaults to 'sequence'\n"
 	       "and the arguments are interpreted as sequence of delta x coordinates\n"
@@ -200,6 +477,13 @@ usage(void)
 	       "Delta coordinates passed into this tool must be in dpi as\n"
 	       "specified by the --dpi argument\n"
 	       "\n"
+	       "In benchmark mode, every filter (or the one given with --filter) is\n"
+	       "run on constant, accelerating, jittery and 8kHz delta streams and on\n"
+	       "the deltas read from stdin, if any. The output is one tab-separated\n"
+	       "line per filter and stream, lines starting with # are comments.\n"
+	       "Cache misses and instructions are counted with perf_event_open\n"
+	       "where the kernel permits it.\n"
+	       "\n"
 	       "Output best viewed with gnuplot. See output for gnuplot commands\n");
 }
 
@@ -213,11 +497,16 @@ main(int argc, char **argv)
 	bool print_accel = false,
 	     print_motion = true,
 	     print_delta = false,
-	     print_sequence = false;
+	     print_sequence = false,
+	     print_bench = false;
 	double custom_deltas[1024];
 	double speed = 0.0;
 	int dpi = 1000;
+	int bench_events;
 	const char *filter_type = "linear";
+	const struct filter_type *type;
+	bool filter_given = false;
+	enum velocity_estimator estimator = VELOCITY_ESTIMATOR_TRACKERS;
 	accel_profile_func_t profile = NULL;
 
 	enum {
@@ -229,6 +518,7 @@ main(int argc, char **argv)
 		OPT_SPEED,
 		OPT_DPI,
 		OPT_FILTER,
+		OPT_ESTIMATOR,
 	};
 
 	while (1) {
@@ -243,6 +533,7 @@ main(int argc, char **argv)
 			{"speed", 1, 0, OPT_SPEED },
 			{"dpi", 1, 0, OPT_DPI },
 			{"filter", 1, 0, OPT_FILTER },
+			{"estimator", 1, 0, OPT_ESTIMATOR },
 			{0, 0, 0, 0}
 		};
 
@@ -265,6 +556,8 @@ main(int argc, char **argv)
 				print_delta = true;
 			else if (streq(optarg, "sequence"))
 				print_sequence = true;
+			else if (streq(optarg, "benchmark"))
+				print_bench = true;
 			else {
 				usage();
 				return 1;
@@ -299,6 +592,17 @@ main(int argc, char **argv)
 			break;
 		case OPT_FILTER:
 			filter_type = optarg;
+			filter_given = true;
+			break;
+		case OPT_ESTIMATOR:
+			if (streq(optarg, "trackers"))
+				estimator = VELOCITY_ESTIMATOR_TRACKERS;
+			else if (streq(optarg, "incremental"))
+				estimator = VELOCITY_ESTIMATOR_INCREMENTAL;
+			else {
+				usage();
+				return 1;
+			}
 			break;
 		default:
 			usage();
@@ -307,28 +611,26 @@ main(int argc, char **argv)
 		}
 	}
 
-	if (streq(filter_type, "linear")) {
-		filter = create_pointer_accelerator_filter_linear(dpi);
-		profile = pointer_accel_profile_linear;
-	} else if (streq(filter_type, "low-dpi")) {
-		filter = create_pointer_accelerator_filter_linear_low_dpi(dpi);
-		profile = pointer_accel_profile_linear_low_dpi;
-	} else if (streq(filter_type, "touchpad")) {
-		filter = create_pointer_accelerator_filter_touchpad(dpi);
-		profile = touchpad_accel_profile_linear;
-	} else if (streq(filter_type, "x230")) {
-		filter = create_pointer_accelerator_filter_lenovo_x230(dpi);
-		profile = touchpad_lenovo_x230_accel_profile;
-	} else if (streq(filter_type, "trackpoint")) {
-		filter = create_pointer_accelerator_filter_trackpoint(dpi);
-		profile = trackpoint_accel_profile;
-	} else {
+	type = find_filter_type(filter_type);
+	if (!type) {
 		fprintf(stderr, "Invalid filter type %s\n", filter_type);
 		return 1;
 	}
 
+	if (print_accel && !type->profile) {
+		fprintf(stderr, "Filter type %s has no acceleration profile\n",
+			filter_type);
+		return 1;
+	}
+
+	bench_events = nevents ? nevents : 100000;
+
+	filter = type->create(dpi);
+	profile = type->profile;
+
 	assert(filter != NULL);
 	filter_set_speed(filter, speed);
+	filter_set_velocity_estimator(filter, estimator);
 
 	if (!isatty(STDIN_FILENO)) {
 		char buf[12];
@@ -349,7 +651,12 @@ main(int argc, char **argv)
 			custom_deltas[nevents++] = strtod(argv[optind++], NULL);
 	}
 
-	if (print_accel)
+	if (print_bench)
+		print_benchmark(filter_given ? type : NULL,
+				bench_events, dpi, speed, estimator,
+				custom_deltas,
+				print_sequence ? nevents : 0);
+	else if (print_accel)
 		print_accel_func(filter, profile, dpi);
 	else if (print_delta)
 		print_ptraccel_deltas(filter, step);
@@ -74,6 +74,9 @@ tools_init_options(struct tools_options *options)
 	options->left_handed = -1;
 	options->middlebutton = -1;
 	options->dwt = -1;
+	options->low_latency = -1;
+	options->smoothing = -1.0;
+	options->batching = -1;
 	options->click_method = -1;
 	options->scroll_method = -1;
 	options->scroll_button = -1;
@@ -141,6 +144,23 @@ tools_parse_option(int option,
 		case OPT_DWT_DISABLE:
 			options->dwt = LIBINPUT_CONFIG_DWT_DISABLED;
 			break;
+		case OPT_LOW_LATENCY_ENABLE:
+			options->low_latency = LIBINPUT_CONFIG_LOW_LATENCY_ENABLED;
+			break;
+		case OPT_LOW_LATENCY_DISABLE:
+			options->low_latency = LIBINPUT_CONFIG_LOW_LATENCY_DISABLED;
+			break;
+		case OPT_SMOOTHING:
+			if (!optarg)
+				return 1;
+			options->smoothing = atof(optarg);
+			break;
+		case OPT_BATCHING_ENABLE:
+			options->batching = LIBINPUT_CONFIG_BATCHING_ENABLED;
+			break;
+		case OPT_BATCHING_DISABLE:
+			options->batching = LIBINPUT_CONFIG_BATCHING_DISABLED;
+			break;
 		case OPT_CLICK_METHOD:
 			if (!optarg)
 				return 1;
@@ -350,6 +370,17 @@ tools_device_apply_config(struct libinput_device *device,
 	if (options->dwt != -1)
 		libinput_device_config_dwt_set_enabled(device, options->dwt);
 
+	if (options->low_latency != -1)
+		libinput_device_config_low_latency_set_enabled(device,
+							       options->low_latency);
+	if (options->smoothing >= 0.0)
+		libinput_device_config_low_latency_set_smoothing(device,
+								 options->smoothing);
+
+	if (options->batching != -1)
+		libinput_device_config_batching_set_enabled(device,
+							    options->batching);
+
 	if (options->click_method != (enum libinput_config_click_method)-1)
 		libinput_device_config_click_set_method(device, options->click_method);
 
@@ -44,6 +44,11 @@ enum configuration_options {
 	OPT_MIDDLEBUTTON_DISABLE,
 	OPT_DWT_ENABLE,
 	OPT_DWT_DISABLE,
+	OPT_LOW_LATENCY_ENABLE,
+	OPT_LOW_LATENCY_DISABLE,
+	OPT_SMOOTHING,
+	OPT_BATCHING_ENABLE,
+	OPT_BATCHING_DISABLE,
 	OPT_CLICK_METHOD,
 	OPT_SCROLL_METHOD,
 	OPT_SCROLL_BUTTON,
@@ -66,6 +71,11 @@ enum configuration_options {
 	{ "disable-middlebutton",      no_argument,       0, OPT_MIDDLEBUTTON_DISABLE }, \
 	{ "enable-dwt",                no_argument,       0, OPT_DWT_ENABLE }, \
 	{ "disable-dwt",               no_argument,       0, OPT_DWT_DISABLE }, \
+	{ "enable-low-latency",        no_argument,       0, OPT_LOW_LATENCY_ENABLE }, \
+	{ "disable-low-latency",       no_argument,       0, OPT_LOW_LATENCY_DISABLE }, \
+	{ "set-smoothing",             required_argument, 0, OPT_SMOOTHING }, \
+	{ "enable-batching",           no_argument,       0, OPT_BATCHING_ENABLE }, \
+	{ "disable-batching",          no_argument,       0, OPT_BATCHING_DISABLE }, \
 	{ "set-click-method",          required_argument, 0, OPT_CLICK_METHOD }, \
 	{ "set-scroll-method",         required_argument, 0, OPT_SCROLL_METHOD }, \
 	{ "set-scroll-button",         required_argument, 0, OPT_SCROLL_BUTTON }, \
@@ -91,6 +101,9 @@ struct tools_options {
 	int scroll_button;
 	double speed;
 	int dwt;
+	int low_latency;
+	double smoothing;
+	int batching;
 	enum libinput_config_accel_profile profile;
 };
 
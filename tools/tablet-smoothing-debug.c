@@ -0,0 +1,322 @@
+/*
+ * Copyright © 2017 Red Hat, Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice (including the next
+ * paragraph) shall be included in all copies or substantial portions of the
+ * Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+
+#include "config.h"
+
+#include <errno.h>
+#include <getopt.h>
+#include <inttypes.h>
+#include <math.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "libinput-private.h"
+#include "evdev-tablet-history.h"
+
+struct sample {
+	struct device_coords point;
+	uint64_t time;
+};
+
+/* The frames of one proximity in/out sequence */
+struct stroke {
+	struct sample *samples;
+	size_t nsamples;
+	size_t size;
+};
+
+struct score {
+	unsigned int count;
+	unsigned int jitter_count;
+	double sum, max;	/* distance smoothed vs. real position */
+	double jitter_sumsq;	/* second difference of the smoothed position */
+};
+
+struct context {
+	struct score scores[TABLET_HISTORY_MAX_LENGTH + 1];
+	int resolution[2];	/* units/mm, 1 if unknown */
+
+	uint64_t frame_interval_sum;
+	unsigned int nframe_intervals;
+
+	bool in_proximity;
+	bool dirty;
+	struct device_coords point;
+	struct stroke stroke;
+};
+
+static void
+stroke_append(struct stroke *stroke, const struct device_coords *point,
+	      uint64_t time)
+{
+	if (stroke->nsamples == stroke->size) {
+		stroke->size = stroke->size ? stroke->size * 2 : 256;
+		stroke->samples = realloc(stroke->samples,
+					  stroke->size * sizeof(*stroke->samples));
+		if (!stroke->samples) {
+			fprintf(stderr, "Out of memory\n");
+			exit(1);
+		}
+	}
+
+	stroke->samples[stroke->nsamples].point = *point;
+	stroke->samples[stroke->nsamples].time = time;
+	stroke->nsamples++;
+}
+
+/* Runs the stroke through the tablet's smoothing with the given window */
+static void
+score_window(struct context *ctx, const struct stroke *stroke, int window)
+{
+	struct score *score = &ctx->scores[window];
+	struct tablet_history history;
+	struct device_float_coords prev[2];
+	size_t i;
+
+	tablet_history_init(&history, window);
+
+	for (i = 0; i < stroke->nsamples; i++) {
+		const struct device_coords *p = &stroke->samples[i].point;
+		struct tablet_axes axes = { .point = *p };
+		struct device_float_coords smooth;
+		double dx, dy;
+
+		tablet_history_push(&history, &axes);
+		tablet_history_smoothen(&history, &axes);
+
+		/* in mm */
+		smooth.x = (double)axes.point.x/ctx->resolution[0];
+		smooth.y = (double)axes.point.y/ctx->resolution[1];
+
+		dx = smooth.x - (double)p->x/ctx->resolution[0];
+		dy = smooth.y - (double)p->y/ctx->resolution[1];
+		score->count++;
+		score->sum += hypot(dx, dy);
+		score->max = max(score->max, hypot(dx, dy));
+
+		if (i >= 2) {
+			dx = smooth.x - 2 * prev[1].x + prev[0].x;
+			dy = smooth.y - 2 * prev[1].y + prev[0].y;
+			score->jitter_count++;
+			score->jitter_sumsq += dx * dx + dy * dy;
+		}
+		if (i >= 1)
+			prev[0] = prev[1];
+		prev[1] = smooth;
+	}
+}
+
+static void
+stroke_end(struct context *ctx)
+{
+	struct stroke *stroke = &ctx->stroke;
+	size_t i;
+	int window;
+
+	if (stroke->nsamples == 0)
+		return;
+
+	for (i = 1; i < stroke->nsamples; i++) {
+		ctx->frame_interval_sum += stroke->samples[i].time -
+					   stroke->samples[i - 1].time;
+		ctx->nframe_intervals++;
+	}
+
+	for (window = 1; window <= TABLET_HISTORY_MAX_LENGTH; window++)
+		score_window(ctx, stroke, window);
+
+	stroke->nsamples = 0;
+}
+
+static void
+handle_event(struct context *ctx, uint64_t time,
+	     unsigned int type, unsigned int code, int value)
+{
+	switch (type) {
+	case EV_SYN:
+		if (code != SYN_REPORT)
+			break;
+		if (ctx->in_proximity && ctx->dirty)
+			stroke_append(&ctx->stroke, &ctx->point, time);
+		ctx->dirty = false;
+		break;
+	case EV_KEY:
+		/* Any tool going in or out of proximity */
+		if (code < BTN_TOOL_PEN || code > BTN_TOOL_LENS ||
+		    code == BTN_TOOL_FINGER)
+			break;
+		if (value) {
+			ctx->in_proximity = true;
+		} else {
+			ctx->in_proximity = false;
+			stroke_end(ctx);
+		}
+		break;
+	case EV_ABS:
+		if (code == ABS_X)
+			ctx->point.x = value;
+		else if (code == ABS_Y)
+			ctx->point.y = value;
+		else
+			break;
+		ctx->dirty = true;
+		break;
+	}
+}
+
+static int
+read_recording(struct context *ctx, FILE *fp)
+{
+	char line[256];
+	int nevents = 0;
+
+	while (fgets(line, sizeof(line), fp)) {
+		unsigned long sec, usec;
+		unsigned int type, code;
+		int value, minimum, maximum, fuzz, flat, res;
+
+		/* evemu-record absinfo lines, for the resolution */
+		if (sscanf(line, "A: %x %d %d %d %d %d",
+			   &code, &minimum, &maximum, &fuzz, &flat, &res) == 6) {
+			if (code <= ABS_Y && res > 0)
+				ctx->resolution[code] = res;
+			continue;
+		}
+
+		/* evemu-record event lines, everything else is ignored */
+		if (sscanf(line, "E: %lu.%lu %x %x %d",
+			   &sec, &usec, &type, &code, &value) != 5)
+			continue;
+
+		handle_event(ctx, s2us(sec) + usec, type, code, value);
+		nevents++;
+	}
+
+	return nevents;
+}
+
+static void
+print_scores(struct context *ctx)
+{
+	double frame_ms = 0.0;
+	int window;
+
+	if (ctx->nframe_intervals > 0)
+		frame_ms = ctx->frame_interval_sum/1000.0/ctx->nframe_intervals;
+
+	printf("# Smoothing window vs. latency and jitter, positions in %s\n",
+	       ctx->resolution[0] > 1 ? "mm" : "device units");
+	printf("# lag is the average delay of the window at %.2fms per frame,\n"
+	       "# error is the distance to the real position, jitter is the rms\n"
+	       "# of the second difference of the smoothed position\n",
+	       frame_ms);
+	printf("# window\tlag(ms)\tmean error\tmax error\tjitter\n");
+
+	for (window = 1; window <= TABLET_HISTORY_MAX_LENGTH; window++) {
+		struct score *s = &ctx->scores[window];
+
+		printf("%d\t%.2f\t%.3f\t%.3f\t%.3f\n",
+		       window,
+		       (window - 1) * frame_ms/2,
+		       s->count ? s->sum/s->count : 0.0,
+		       s->max,
+		       s->jitter_count ? sqrt(s->jitter_sumsq/s->jitter_count) : 0.0);
+	}
+}
+
+static void
+usage(void)
+{
+	printf("Usage: %s [options] [recording]\n", program_invocation_short_name);
+	printf("\n"
+	       "Replays an evemu-record recording of a tablet tool through the\n"
+	       "tablet's position smoothing for each window size from 1 to %d and\n"
+	       "prints the latency and the remaining jitter.\n"
+	       "If no recording is given, it is read from stdin.\n"
+	       "\n"
+	       "Options:\n"
+	       "--help ... show this help\n",
+	       TABLET_HISTORY_MAX_LENGTH);
+}
+
+int
+main(int argc, char **argv)
+{
+	struct context ctx = { .resolution = { 1, 1 } };
+	FILE *fp = stdin;
+
+	enum {
+		OPT_HELP = 1,
+	};
+
+	while (1) {
+		int c;
+		int option_index = 0;
+		static struct option long_options[] = {
+			{"help", 0, 0, OPT_HELP },
+			{0, 0, 0, 0}
+		};
+
+		c = getopt_long(argc, argv, "",
+				long_options, &option_index);
+		if (c == -1)
+			break;
+
+		switch (c) {
+		case OPT_HELP:
+			usage();
+			exit(0);
+			break;
+		default:
+			usage();
+			exit(1);
+			break;
+		}
+	}
+
+	if (optind < argc) {
+		fp = fopen(argv[optind], "r");
+		if (!fp) {
+			fprintf(stderr, "Failed to open %s: %s\n",
+				argv[optind], strerror(errno));
+			return 1;
+		}
+	}
+
+	if (read_recording(&ctx, fp) == 0) {
+		fprintf(stderr, "No events found, expected an evemu-record recording\n");
+		return 1;
+	}
+
+	stroke_end(&ctx);
+	free(ctx.stroke.samples);
+
+	print_scores(&ctx);
+
+	if (fp != stdin)
+		fclose(fp);
+
+	return 0;
+}
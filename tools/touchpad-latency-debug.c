@@ -0,0 +1,515 @@
+/*
+ * Copyright © 2017 Red Hat, Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice (including the next
+ * paragraph) shall be included in all copies or substantial portions of the
+ * Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+
+#include "config.h"
+
+#include <errno.h>
+#include <getopt.h>
+#include <inttypes.h>
+#include <math.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "evdev.h"
+#include "filter.h"
+#include "libinput-util.h"
+
+#define MAX_SLOTS 64
+#define MAX_CONFIGS 16
+
+/* Matches the touchpad's low-latency mode, see tp_low_latency_set_params */
+#define MAX_CUTOFF 30.0
+#define MIN_CUTOFF 0.5
+
+struct sample {
+	struct device_coords point;
+	uint64_t time;
+};
+
+struct trace {
+	struct sample *samples;
+	size_t nsamples;
+	size_t size;
+};
+
+/* One way of processing the touch positions, either the default
+ * hysteresis or the low-latency filter with some smoothing */
+struct config {
+	bool low_latency;
+	double smoothing;
+
+	unsigned int ntouches;
+	unsigned int nmoved;
+	uint64_t latency_sum, latency_max;
+	double lag_sum;
+	unsigned int nlag;
+	double rest_sum;
+	unsigned int nrest;
+};
+
+struct slot {
+	bool active;
+	bool dirty;
+	struct device_coords point;
+	struct trace trace;
+};
+
+struct context {
+	struct config configs[MAX_CONFIGS];
+	size_t nconfigs;
+
+	struct slot slots[MAX_SLOTS];
+	int current_slot;
+	bool is_mt;
+
+	int res_x, res_y;
+	/* Distance in mm that counts as the start of a motion */
+	double onset;
+	/* Raw motion below this many mm per frame counts as a resting
+	 * finger */
+	double rest_threshold;
+};
+
+static void
+trace_append(struct trace *trace, const struct device_coords *point,
+	     uint64_t time)
+{
+	if (trace->nsamples == trace->size) {
+		trace->size = trace->size ? trace->size * 2 : 256;
+		trace->samples = realloc(trace->samples,
+					 trace->size * sizeof(*trace->samples));
+		if (!trace->samples) {
+			fprintf(stderr, "Out of memory\n");
+			exit(1);
+		}
+	}
+
+	trace->samples[trace->nsamples].point = *point;
+	trace->samples[trace->nsamples].time = time;
+	trace->nsamples++;
+}
+
+static inline double
+distance_mm(struct context *ctx,
+	    const struct device_coords *a,
+	    const struct device_coords *b)
+{
+	return hypot((double)(a->x - b->x)/ctx->res_x,
+		     (double)(a->y - b->y)/ctx->res_y);
+}
+
+/* The position the pointer deltas are taken from, see tp_get_delta():
+ * tp_motion_hysteresis() by default, tp_motion_smooth() in low-latency
+ * mode */
+static struct device_coords
+process(struct context *ctx,
+	const struct config *config,
+	const struct one_euro_params *params,
+	struct one_euro_state *state,
+	struct device_coords *center,
+	const struct sample *sample,
+	bool first)
+{
+	struct device_coords p = sample->point;
+	struct device_float_coords mm;
+
+	if (!config->low_latency) {
+		if (first) {
+			*center = p;
+		} else {
+			p.x = evdev_hysteresis(p.x, center->x, ctx->res_x/2);
+			p.y = evdev_hysteresis(p.y, center->y, ctx->res_y/2);
+			*center = p;
+		}
+		return p;
+	}
+
+	if (first)
+		one_euro_reset(state);
+
+	mm.x = (double)p.x/ctx->res_x;
+	mm.y = (double)p.y/ctx->res_y;
+	mm = one_euro_filter(params, state, &mm, sample->time);
+	p.x = round(mm.x * ctx->res_x);
+	p.y = round(mm.y * ctx->res_y);
+
+	return p;
+}
+
+static void
+score_trace(struct context *ctx, struct trace *trace)
+{
+	size_t c, i;
+
+	if (trace->nsamples < 2)
+		goto out;
+
+	for (c = 0; c < ctx->nconfigs; c++) {
+		struct config *config = &ctx->configs[c];
+		struct one_euro_params params = {
+			.min_cutoff = MAX_CUTOFF *
+				pow(MIN_CUTOFF/MAX_CUTOFF, config->smoothing),
+			.beta = 0.1,
+			.dcutoff = 1.0,
+		};
+		struct one_euro_state state = { .initialized = false };
+		struct device_coords center = { 0, 0 },
+				     first_out = { 0, 0 },
+				     last_out = { 0, 0 };
+		uint64_t raw_moved = 0, out_moved = 0;
+
+		config->ntouches++;
+
+		for (i = 0; i < trace->nsamples; i++) {
+			const struct sample *s = &trace->samples[i];
+			struct device_coords out;
+
+			out = process(ctx, config, &params, &state, &center,
+				      s, i == 0);
+			if (i == 0) {
+				first_out = out;
+				last_out = out;
+				continue;
+			}
+
+			if (raw_moved == 0 &&
+			    distance_mm(ctx, &s->point, &trace->samples[0].point) >=
+			    ctx->onset)
+				raw_moved = s->time;
+			if (out_moved == 0 &&
+			    distance_mm(ctx, &out, &first_out) >= ctx->onset)
+				out_moved = s->time;
+
+			config->lag_sum += distance_mm(ctx, &s->point, &out);
+			config->nlag++;
+
+			if (distance_mm(ctx, &s->point, &trace->samples[i - 1].point) <
+			    ctx->rest_threshold) {
+				config->rest_sum += distance_mm(ctx, &out, &last_out);
+				config->nrest++;
+			}
+
+			last_out = out;
+		}
+
+		if (raw_moved && out_moved) {
+			uint64_t latency = 0;
+
+			/* jitter may move the output first */
+			if (out_moved > raw_moved)
+				latency = out_moved - raw_moved;
+
+			config->nmoved++;
+			config->latency_sum += latency;
+			config->latency_max = max(config->latency_max,
+						  latency);
+		}
+	}
+
+out:
+	trace->nsamples = 0;
+}
+
+static void
+handle_frame(struct context *ctx, uint64_t time)
+{
+	int i;
+
+	for (i = 0; i < MAX_SLOTS; i++) {
+		struct slot *slot = &ctx->slots[i];
+
+		if (!slot->active || !slot->dirty)
+			continue;
+
+		trace_append(&slot->trace, &slot->point, time);
+		slot->dirty = false;
+	}
+}
+
+static void
+slot_end(struct context *ctx, struct slot *slot)
+{
+	score_trace(ctx, &slot->trace);
+	slot->active = false;
+	slot->dirty = false;
+}
+
+static void
+handle_event(struct context *ctx, uint64_t time,
+	     unsigned int type, unsigned int code, int value)
+{
+	struct slot *slot = &ctx->slots[ctx->current_slot];
+
+	switch (type) {
+	case EV_SYN:
+		if (code == SYN_REPORT)
+			handle_frame(ctx, time);
+		break;
+	case EV_KEY:
+		if (code != BTN_TOUCH || ctx->is_mt)
+			break;
+		slot = &ctx->slots[0];
+		if (value)
+			slot->active = true;
+		else
+			slot_end(ctx, slot);
+		break;
+	case EV_ABS:
+		switch (code) {
+		case ABS_MT_SLOT:
+			ctx->is_mt = true;
+			if (value >= 0 && value < MAX_SLOTS)
+				ctx->current_slot = value;
+			break;
+		case ABS_MT_TRACKING_ID:
+			ctx->is_mt = true;
+			if (value == -1)
+				slot_end(ctx, slot);
+			else
+				slot->active = true;
+			break;
+		case ABS_MT_POSITION_X:
+			slot->point.x = value;
+			slot->dirty = true;
+			break;
+		case ABS_MT_POSITION_Y:
+			slot->point.y = value;
+			slot->dirty = true;
+			break;
+		case ABS_X:
+		case ABS_Y:
+			if (ctx->is_mt)
+				break;
+			slot = &ctx->slots[0];
+			if (code == ABS_X)
+				slot->point.x = value;
+			else
+				slot->point.y = value;
+			slot->dirty = true;
+			break;
+		}
+		break;
+	}
+}
+
+static int
+read_recording(struct context *ctx, FILE *fp)
+{
+	char line[256];
+	int nevents = 0;
+
+	while (fgets(line, sizeof(line), fp)) {
+		unsigned long sec, usec;
+		unsigned int type, code;
+		int value, min, max, fuzz, flat, res;
+
+		/* evemu-record absinfo lines: code min max fuzz flat res */
+		if (sscanf(line, "A: %x %d %d %d %d %d",
+			   &code, &min, &max, &fuzz, &flat, &res) == 6) {
+			if (res > 0 && (code == ABS_X || code == ABS_MT_POSITION_X))
+				ctx->res_x = res;
+			else if (res > 0 && (code == ABS_Y || code == ABS_MT_POSITION_Y))
+				ctx->res_y = res;
+			continue;
+		}
+
+		if (sscanf(line, "E: %lu.%lu %x %x %d",
+			   &sec, &usec, &type, &code, &value) != 5)
+			continue;
+
+		if (ctx->res_x == 0 || ctx->res_y == 0) {
+			fprintf(stderr, "Recording has no resolution for the x/y axes\n");
+			exit(1);
+		}
+
+		handle_event(ctx, s2us(sec) + usec, type, code, value);
+		nevents++;
+	}
+
+	return nevents;
+}
+
+static void
+print_results(struct context *ctx)
+{
+	size_t i;
+
+	printf("# first motion: from the raw position to the processed position moving\n"
+	       "#               %.2fmm from where the touch started, only touches that\n"
+	       "#               moved that far are counted\n"
+	       "# lag:          mean distance between raw and processed position\n"
+	       "# rest motion:  mean processed motion per frame while the raw motion is\n"
+	       "#               below %.2fmm\n",
+	       ctx->onset,
+	       ctx->rest_threshold);
+	printf("# mode\tsmoothing\ttouches\tmoved\tfirst motion mean(ms)\tmax(ms)\tlag(mm)\trest motion(mm)\n");
+
+	for (i = 0; i < ctx->nconfigs; i++) {
+		struct config *c = &ctx->configs[i];
+
+		printf("%s\t", c->low_latency ? "low-latency" : "default");
+		if (c->low_latency)
+			printf("%.2f\t", c->smoothing);
+		else
+			printf("-\t");
+		printf("%u\t%u\t%.2f\t%.2f\t%.3f\t%.4f\n",
+		       c->ntouches,
+		       c->nmoved,
+		       c->nmoved ? c->latency_sum/1000.0/c->nmoved : 0.0,
+		       c->latency_max/1000.0,
+		       c->nlag ? c->lag_sum/c->nlag : 0.0,
+		       c->nrest ? c->rest_sum/c->nrest : 0.0);
+	}
+}
+
+static void
+usage(void)
+{
+	printf("Usage: %s [options] [recording]\n", program_invocation_short_name);
+	printf("\n"
+	       "Replays the touches of an evemu-record touchpad recording through the\n"
+	       "default motion hysteresis and the low-latency filter and prints the\n"
+	       "first-motion latency, the lag and the motion of a resting finger for\n"
+	       "each. If no recording is given, it is read from stdin.\n"
+	       "\n"
+	       "Options:\n"
+	       "--smoothing=<double> ...... low-latency smoothing in [0, 1], may be given\n"
+	       "                            up to %d times (default: 0, 0.25, 0.5, 0.75, 1)\n"
+	       "--onset=<double> .......... distance in mm a touch has to move for a motion\n"
+	       "                            to start (default: 1.0)\n"
+	       "--rest-threshold=<double> . raw motion in mm per frame below which a finger\n"
+	       "                            counts as resting (default: 0.1)\n",
+	       MAX_CONFIGS - 1);
+}
+
+int
+main(int argc, char **argv)
+{
+	struct context ctx = {
+		.current_slot = 0,
+		.onset = 1.0,
+		.rest_threshold = 0.1,
+	};
+	FILE *fp = stdin;
+	double smoothing;
+	int i;
+
+	enum {
+		OPT_HELP = 1,
+		OPT_SMOOTHING,
+		OPT_ONSET,
+		OPT_REST_THRESHOLD,
+	};
+
+	/* the default mode always comes first */
+	ctx.configs[ctx.nconfigs++].low_latency = false;
+
+	while (1) {
+		int c;
+		int option_index = 0;
+		static struct option long_options[] = {
+			{"help", 0, 0, OPT_HELP },
+			{"smoothing", 1, 0, OPT_SMOOTHING },
+			{"onset", 1, 0, OPT_ONSET },
+			{"rest-threshold", 1, 0, OPT_REST_THRESHOLD },
+			{0, 0, 0, 0}
+		};
+
+		c = getopt_long(argc, argv, "",
+				long_options, &option_index);
+		if (c == -1)
+			break;
+
+		switch (c) {
+		case OPT_HELP:
+			usage();
+			exit(0);
+			break;
+		case OPT_SMOOTHING:
+			smoothing = strtod(optarg, NULL);
+			if (smoothing < 0.0 || smoothing > 1.0 ||
+			    ctx.nconfigs == MAX_CONFIGS) {
+				usage();
+				return 1;
+			}
+			ctx.configs[ctx.nconfigs].low_latency = true;
+			ctx.configs[ctx.nconfigs].smoothing = smoothing;
+			ctx.nconfigs++;
+			break;
+		case OPT_ONSET:
+			ctx.onset = strtod(optarg, NULL);
+			if (ctx.onset <= 0.0) {
+				usage();
+				return 1;
+			}
+			break;
+		case OPT_REST_THRESHOLD:
+			ctx.rest_threshold = strtod(optarg, NULL);
+			if (ctx.rest_threshold <= 0.0) {
+				usage();
+				return 1;
+			}
+			break;
+		default:
+			usage();
+			exit(1);
+			break;
+		}
+	}
+
+	if (ctx.nconfigs == 1) {
+		for (smoothing = 0.0; smoothing <= 1.0; smoothing += 0.25) {
+			ctx.configs[ctx.nconfigs].low_latency = true;
+			ctx.configs[ctx.nconfigs].smoothing = smoothing;
+			ctx.nconfigs++;
+		}
+	}
+
+	if (optind < argc) {
+		fp = fopen(argv[optind], "r");
+		if (!fp) {
+			fprintf(stderr, "Failed to open %s: %s\n",
+				argv[optind], strerror(errno));
+			return 1;
+		}
+	}
+
+	if (read_recording(&ctx, fp) == 0) {
+		fprintf(stderr, "No events found, expected an evemu-record recording\n");
+		return 1;
+	}
+
+	for (i = 0; i < MAX_SLOTS; i++) {
+		score_trace(&ctx, &ctx.slots[i].trace);
+		free(ctx.slots[i].trace.samples);
+	}
+
+	print_results(&ctx);
+
+	if (fp != stdin)
+		fclose(fp);
+
+	return 0;
+}
@@ -0,0 +1,612 @@
+/*
+ * Copyright © 2017 Red Hat, Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice (including the next
+ * paragraph) shall be included in all copies or substantial portions of the
+ * Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+
+#include "config.h"
+
+#include <errno.h>
+#include <getopt.h>
+#include <inttypes.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include <libevdev/libevdev.h>
+
+#include "bench-context.h"
+#include "bench-util.h"
+
+/* Time between two generated frames */
+#define FRAME_INTERVAL ms2us(12)
+/* Idle time after each sequence, long enough for all touchpad timeouts */
+#define IDLE_INTERVAL ms2us(1000)
+
+/* A device as described by evemu-record */
+struct description {
+	char name[256];
+	struct input_id id;
+	unsigned char props[NCHARS(INPUT_PROP_CNT)];
+	size_t nprops;
+	unsigned char bits[EV_CNT][NCHARS(KEY_CNT)];
+	size_t nbits[EV_CNT];
+	struct input_absinfo abs[ABS_CNT];
+};
+
+/* Timestamps are relative to the first event */
+struct stream {
+	struct input_event *events;
+	size_t nevents;
+	size_t size;
+	unsigned int nframes;
+};
+
+/* One finger sequence, repeated with an idle gap in between: nfingers go
+ * down at x/y, spacing apart from each other, move by dx/dy per frame for
+ * nframes and go up again. With click, the clickpad is held down while the
+ * fingers move */
+struct scenario {
+	const char *name;
+	int nfingers;
+	int nframes;
+	int x, y;
+	int dx, dy;
+	int spacing;
+	int repeat;
+	bool click;
+};
+
+static const struct scenario scenarios[] = {
+	{ "tap",	1, 2, 2000, 1200, 0, 0, 0, 50, false },
+	{ "motion",	1, 200, 500, 500, 10, 5, 0, 5, false },
+	{ "scroll",	2, 200, 1000, 300, 0, 10, 800, 5, false },
+	{ "swipe",	3, 200, 500, 1000, 10, 0, 600, 5, false },
+	/* inside the left palm edge */
+	{ "palm",	1, 200, 100, 300, 0, 10, 0, 5, false },
+	/* one finger in each of the bottom software buttons */
+	{ "clickpad",	3, 200, 500, 2400, 2, 0, 1500, 5, true },
+};
+
+struct context {
+	struct bench_context bench;
+	struct evdev_device *device;
+	/* The virtual clock, see libinput_timer_advance() */
+	uint64_t now;
+};
+
+static void
+builtin_description(struct description *d)
+{
+	static const unsigned int keys[] = {
+		BTN_LEFT,
+		BTN_TOOL_FINGER,
+		BTN_TOOL_DOUBLETAP,
+		BTN_TOOL_TRIPLETAP,
+		BTN_TOOL_QUADTAP,
+		BTN_TOOL_QUINTTAP,
+		BTN_TOUCH,
+	};
+	static const struct {
+		unsigned int code;
+		struct input_absinfo abs;
+	} axes[] = {
+		{ ABS_X, { .maximum = 4000, .resolution = 40 } },
+		{ ABS_Y, { .maximum = 2500, .resolution = 40 } },
+		{ ABS_MT_SLOT, { .maximum = 4 } },
+		{ ABS_MT_POSITION_X, { .maximum = 4000, .resolution = 40 } },
+		{ ABS_MT_POSITION_Y, { .maximum = 2500, .resolution = 40 } },
+		{ ABS_MT_TRACKING_ID, { .maximum = 65535 } },
+	};
+	unsigned int i;
+
+	memset(d, 0, sizeof(*d));
+	snprintf(d->name, sizeof(d->name), "touchpad-replay-bench clickpad");
+	/* Anything but USB and Bluetooth is an internal touchpad */
+	d->id.bustype = BUS_I8042;
+
+	set_bit(d->props, INPUT_PROP_POINTER);
+	set_bit(d->props, INPUT_PROP_BUTTONPAD);
+
+	set_bit(d->bits[EV_SYN], EV_KEY);
+	set_bit(d->bits[EV_SYN], EV_ABS);
+	for (i = 0; i < ARRAY_LENGTH(keys); i++)
+		set_bit(d->bits[EV_KEY], keys[i]);
+	for (i = 0; i < ARRAY_LENGTH(axes); i++) {
+		set_bit(d->bits[EV_ABS], axes[i].code);
+		d->abs[axes[i].code] = axes[i].abs;
+	}
+}
+
+static bool
+parse_bytes(const char *str, unsigned char *bytes, size_t *offset, size_t max)
+{
+	unsigned int byte;
+	int n;
+
+	while (sscanf(str, " %2x%n", &byte, &n) == 1) {
+		if (*offset >= max)
+			return false;
+		bytes[(*offset)++] = byte;
+		str += n;
+	}
+
+	return true;
+}
+
+/* Parses the N:, I:, P:, B: and A: lines of an evemu-record description */
+static bool
+parse_description_line(struct description *d, const char *line)
+{
+	unsigned int type, code;
+	struct input_absinfo abs = { 0 };
+	int n;
+
+	if (strneq(line, "N: ", 3)) {
+		snprintf(d->name, sizeof(d->name), "%s", line + 3);
+		d->name[strcspn(d->name, "\n")] = '\0';
+	} else if (strneq(line, "I: ", 3)) {
+		if (sscanf(line, "I: %hx %hx %hx %hx",
+			   &d->id.bustype, &d->id.vendor,
+			   &d->id.product, &d->id.version) != 4)
+			return false;
+	} else if (strneq(line, "P: ", 3)) {
+		return parse_bytes(line + 2, d->props, &d->nprops,
+				   sizeof(d->props));
+	} else if (strneq(line, "B: ", 3)) {
+		if (sscanf(line, "B: %2x%n", &type, &n) != 1 ||
+		    type >= EV_CNT)
+			return false;
+		return parse_bytes(line + n, d->bits[type], &d->nbits[type],
+				   sizeof(d->bits[type]));
+	} else if (strneq(line, "A: ", 3)) {
+		n = sscanf(line, "A: %x %d %d %d %d %d",
+			   &code,
+			   &abs.minimum,
+			   &abs.maximum,
+			   &abs.fuzz,
+			   &abs.flat,
+			   &abs.resolution);
+		if (n < 5 || code >= ABS_CNT)
+			return false;
+		d->abs[code] = abs;
+	}
+
+	return true;
+}
+
+static struct libevdev *
+description_create_evdev(const struct description *d)
+{
+	struct libevdev *evdev;
+	unsigned int type, code;
+
+	evdev = libevdev_new();
+	if (!evdev)
+		return NULL;
+
+	libevdev_set_name(evdev, d->name);
+	libevdev_set_id_bustype(evdev, d->id.bustype);
+	libevdev_set_id_vendor(evdev, d->id.vendor);
+	libevdev_set_id_product(evdev, d->id.product);
+	libevdev_set_id_version(evdev, d->id.version);
+
+	for (code = 0; code < INPUT_PROP_CNT; code++) {
+		if (bit_is_set(d->props, code))
+			libevdev_enable_property(evdev, code);
+	}
+
+	/* EV_REP needs the repeat values, a touchpad doesn't have it */
+	for (type = EV_KEY; type < EV_CNT; type++) {
+		int max = libevdev_event_type_get_max(type);
+
+		if (type == EV_REP || max == -1 ||
+		    !bit_is_set(d->bits[EV_SYN], type))
+			continue;
+
+		for (code = 0; code <= (unsigned int)max; code++) {
+			if (!bit_is_set(d->bits[type], code))
+				continue;
+
+			libevdev_enable_event_code(evdev, type, code,
+						   type == EV_ABS ? &d->abs[code] : NULL);
+		}
+	}
+
+	return evdev;
+}
+
+static void
+stream_append(struct stream *s, uint64_t time,
+	      unsigned int type, unsigned int code, int value)
+{
+	struct input_event *ev;
+
+	if (s->nevents == s->size) {
+		s->size = s->size ? s->size * 2 : 1024;
+		s->events = realloc(s->events, s->size * sizeof(*s->events));
+		if (!s->events) {
+			fprintf(stderr, "Out of memory\n");
+			exit(1);
+		}
+	}
+
+	ev = &s->events[s->nevents++];
+	ev->time.tv_sec = time / ms2us(1000);
+	ev->time.tv_usec = time % ms2us(1000);
+	ev->type = type;
+	ev->code = code;
+	ev->value = value;
+
+	if (type == EV_SYN && code == SYN_REPORT)
+		s->nframes++;
+}
+
+static void
+scenario_append_frame(struct stream *s,
+		      const struct scenario *scenario,
+		      uint64_t time,
+		      int frame,
+		      bool down, bool up)
+{
+	static const unsigned int tools[] = {
+		BTN_TOOL_FINGER,
+		BTN_TOOL_DOUBLETAP,
+		BTN_TOOL_TRIPLETAP,
+		BTN_TOOL_QUADTAP,
+		BTN_TOOL_QUINTTAP,
+	};
+	int i;
+
+	for (i = 0; i < scenario->nfingers; i++) {
+		int x, y;
+
+		x = min(scenario->x + i * scenario->spacing +
+			frame * scenario->dx, 4000);
+		y = min(scenario->y + frame * scenario->dy, 2500);
+
+		stream_append(s, time, EV_ABS, ABS_MT_SLOT, i);
+		if (up) {
+			stream_append(s, time, EV_ABS, ABS_MT_TRACKING_ID, -1);
+			continue;
+		}
+		if (down)
+			stream_append(s, time, EV_ABS, ABS_MT_TRACKING_ID, i + 1);
+		stream_append(s, time, EV_ABS, ABS_MT_POSITION_X, x);
+		stream_append(s, time, EV_ABS, ABS_MT_POSITION_Y, y);
+		if (i == 0) {
+			stream_append(s, time, EV_ABS, ABS_X, x);
+			stream_append(s, time, EV_ABS, ABS_Y, y);
+		}
+	}
+
+	if (down || up) {
+		stream_append(s, time, EV_KEY, BTN_TOUCH, down);
+		stream_append(s, time, EV_KEY,
+			      tools[scenario->nfingers - 1], down);
+	}
+	if (scenario->click) {
+		if (frame == 1)
+			stream_append(s, time, EV_KEY, BTN_LEFT, 1);
+		else if (frame == scenario->nframes - 1)
+			stream_append(s, time, EV_KEY, BTN_LEFT, 0);
+	}
+	stream_append(s, time, EV_SYN, SYN_REPORT, 0);
+}
+
+static void
+scenario_create_stream(const struct scenario *scenario, struct stream *s)
+{
+	uint64_t time = 0;
+	int r, frame;
+
+	for (r = 0; r < scenario->repeat; r++) {
+		for (frame = 0; frame <= scenario->nframes; frame++) {
+			scenario_append_frame(s, scenario, time, frame,
+					      frame == 0,
+					      frame == scenario->nframes);
+			time += FRAME_INTERVAL;
+		}
+		time += IDLE_INTERVAL;
+	}
+}
+
+static int
+read_recording(FILE *fp, struct description *d, struct stream *s)
+{
+	char line[1024];
+	uint64_t first = 0;
+
+	memset(d, 0, sizeof(*d));
+
+	while (fgets(line, sizeof(line), fp)) {
+		unsigned long sec, usec;
+		unsigned int type, code;
+		int value;
+		uint64_t time;
+
+		if (sscanf(line, "E: %lu.%lu %x %x %d",
+			   &sec, &usec, &type, &code, &value) == 5) {
+			time = s2us(sec) + usec;
+			if (s->nevents == 0)
+				first = time;
+			stream_append(s, time - first, type, code, value);
+			continue;
+		}
+
+		if (!parse_description_line(d, line)) {
+			fprintf(stderr, "Invalid line: %s", line);
+			return -1;
+		}
+	}
+
+	if (!bit_is_set(d->bits[EV_ABS], ABS_MT_SLOT)) {
+		fprintf(stderr, "Not a multitouch device description\n");
+		return -1;
+	}
+
+	return s->nframes;
+}
+
+static unsigned int
+drain(struct libinput *li)
+{
+	struct libinput_event *ev;
+	unsigned int nevents = 0;
+
+	while ((ev = libinput_get_event(li))) {
+		libinput_event_destroy(ev);
+		nevents++;
+	}
+
+	return nevents;
+}
+
+static int
+context_init(struct context *ctx, const struct description *d)
+{
+	struct libevdev *evdev;
+
+	bench_context_init(&ctx->bench);
+
+	/* From here on the timers run on the virtual clock */
+	ctx->now = s2us(10);
+	libinput_timer_advance(ctx->bench.li, ctx->now);
+
+	evdev = description_create_evdev(d);
+	if (evdev)
+		ctx->device = evdev_device_create_touchpad(ctx->bench.seat,
+							   evdev);
+	if (!ctx->device) {
+		fprintf(stderr, "Failed to create a touchpad from the description\n");
+		return -1;
+	}
+
+	libinput_device_config_tap_set_enabled(&ctx->device->base,
+					       LIBINPUT_CONFIG_TAP_ENABLED);
+	drain(ctx->bench.li);
+
+	return 0;
+}
+
+static void
+context_fini(struct context *ctx)
+{
+	if (ctx->device)
+		evdev_device_remove(ctx->device);
+	bench_context_fini(&ctx->bench);
+}
+
+/* Replays the stream and returns the time it took in ns */
+static uint64_t
+replay(struct context *ctx, const struct stream *s, uint64_t *nevents)
+{
+	struct evdev_dispatch *dispatch = ctx->device->dispatch;
+	uint64_t base = ctx->now + FRAME_INTERVAL;
+	uint64_t start, elapsed;
+	size_t i;
+
+	start = now_ns();
+
+	for (i = 0; i < s->nevents; i++) {
+		struct input_event ev = s->events[i];
+		uint64_t time = base + tv2us(&ev.time);
+
+		/* Timers expire before the frame that comes after them,
+		 * the same as if libinput_dispatch() ran in between */
+		if (time > ctx->now) {
+			ctx->now = time;
+			libinput_timer_advance(ctx->bench.li, time);
+		}
+
+		ev.time.tv_sec = time / ms2us(1000);
+		ev.time.tv_usec = time % ms2us(1000);
+		dispatch->interface->process(dispatch, ctx->device, &ev, time);
+
+		if (ev.type == EV_SYN && ev.code == SYN_REPORT)
+			*nevents += drain(ctx->bench.li);
+	}
+
+	*nevents += drain(ctx->bench.li);
+
+	elapsed = now_ns() - start;
+
+	/* Let the remaining timeouts expire outside the measurement so
+	 * every replay starts idle */
+	ctx->now += IDLE_INTERVAL;
+	libinput_timer_advance(ctx->bench.li, ctx->now);
+	drain(ctx->bench.li);
+
+	return elapsed;
+}
+
+static void
+run(struct context *ctx, const char *name, const struct stream *s, int nruns)
+{
+	uint64_t total = 0, best = UINT64_MAX;
+	uint64_t nevents = 0;
+	int r;
+
+	if (s->nframes == 0)
+		return;
+
+	for (r = 0; r < nruns; r++) {
+		uint64_t elapsed = replay(ctx, s, &nevents);
+
+		total += elapsed;
+		best = min(best, elapsed/s->nframes);
+	}
+
+	printf("%s\t%u\t%.2f\t%" PRIu64 "\t%" PRIu64 "\n",
+	       name,
+	       s->nframes,
+	       (double)nevents/(s->nframes * nruns),
+	       total/(s->nframes * nruns),
+	       best);
+}
+
+static void
+usage(void)
+{
+	unsigned int i;
+
+	printf("Usage: %s [options] [recording]\n", program_invocation_short_name);
+	printf("\n"
+	       "Replays touchpad frames straight into the touchpad dispatch,\n"
+	       "without uinput or the kernel, and prints the time it takes to\n"
+	       "process one frame. Timers run on a virtual clock that follows\n"
+	       "the event timestamps.\n"
+	       "\n"
+	       "If an evemu-record recording is given, the touchpad is created\n"
+	       "from its device description and the recorded events are\n"
+	       "replayed. Otherwise a built-in clickpad replays the built-in\n"
+	       "scenarios. udev properties are not available, all property-based\n"
+	       "quirks use their defaults.\n"
+	       "\n"
+	       "Options:\n"
+	       "--runs=<int> ........ number of runs per scenario (default: 5)\n"
+	       "--scenario=<name> ... only replay this scenario, one of:\n");
+	for (i = 0; i < ARRAY_LENGTH(scenarios); i++)
+		printf("                       %s\n", scenarios[i].name);
+}
+
+int
+main(int argc, char **argv)
+{
+	struct context ctx = { 0 };
+	struct description description;
+	struct stream stream = { 0 };
+	const char *only = NULL;
+	FILE *fp = NULL;
+	int nruns = 5;
+	int rc = 1;
+	unsigned int i;
+
+	enum {
+		OPT_HELP = 1,
+		OPT_RUNS,
+		OPT_SCENARIO,
+	};
+
+	while (1) {
+		int c;
+		int option_index = 0;
+		static struct option long_options[] = {
+			{"help", 0, 0, OPT_HELP },
+			{"runs", 1, 0, OPT_RUNS },
+			{"scenario", 1, 0, OPT_SCENARIO },
+			{0, 0, 0, 0}
+		};
+
+		c = getopt_long(argc, argv, "",
+				long_options, &option_index);
+		if (c == -1)
+			break;
+
+		switch (c) {
+		case OPT_HELP:
+			usage();
+			exit(0);
+			break;
+		case OPT_RUNS:
+			nruns = atoi(optarg);
+			if (nruns <= 0) {
+				usage();
+				return 1;
+			}
+			break;
+		case OPT_SCENARIO:
+			only = optarg;
+			break;
+		default:
+			usage();
+			exit(1);
+			break;
+		}
+	}
+
+	if (optind < argc) {
+		fp = fopen(argv[optind], "r");
+		if (!fp) {
+			fprintf(stderr, "Failed to open %s: %s\n",
+				argv[optind], strerror(errno));
+			return 1;
+		}
+
+		if (read_recording(fp, &description, &stream) <= 0) {
+			fprintf(stderr, "No frames found, expected an evemu-record recording\n");
+			goto out;
+		}
+	} else {
+		builtin_description(&description);
+	}
+
+	if (context_init(&ctx, &description) != 0)
+		goto out;
+
+	printf("# ns per frame, virtual clock\n");
+	printf("# scenario\tframes\tevents/frame\tmean\tbest run\n");
+
+	if (fp) {
+		run(&ctx, "recording", &stream, nruns);
+	} else {
+		for (i = 0; i < ARRAY_LENGTH(scenarios); i++) {
+			if (only && !streq(only, scenarios[i].name))
+				continue;
+
+			stream.nevents = 0;
+			stream.nframes = 0;
+			scenario_create_stream(&scenarios[i], &stream);
+			run(&ctx, scenarios[i].name, &stream, nruns);
+		}
+	}
+
+	rc = 0;
+out:
+	if (ctx.bench.li)
+		context_fini(&ctx);
+	free(stream.events);
+	if (fp)
+		fclose(fp);
+
+	return rc;
+}
@@ -117,13 +117,28 @@ def property_grammar():
                       Suppress('=') -
                       Group(pressure_range('SETTINGS*')) ]
 
+    motion_coalesce = INTEGER('X') + Suppress(':') + INTEGER('Y')
+    motion_coalesce_prop = [ Literal('LIBINPUT_ATTR_MOTION_COALESCE')('NAME') -
+                             Suppress('=') -
+                             Group(motion_coalesce('SETTINGS*')) ]
+
+    palm_prop = [ Or((Literal('LIBINPUT_ATTR_PALM_SIZE_THRESHOLD'),
+                      Literal('LIBINPUT_ATTR_PALM_PRESSURE_THRESHOLD')))('NAME') -
+                  Suppress('=') -
+                  INTEGER('VALUE') ]
+
+    tablet_smoothing_prop = [ Literal('LIBINPUT_ATTR_TABLET_SMOOTHING_WINDOW')('NAME') -
+                              Suppress('=') -
+                              INTEGER('VALUE') ]
+
     kbintegration_tags = Or(('internal', 'external'))
     kbintegration = [Literal('LIBINPUT_ATTR_KEYBOARD_INTEGRATION')('NAME') -
                          Suppress('=') -
                          kbintegration_tags('VALUE')]
 
     grammar = Or(model_props + size_props + reliability + tpkbcombo +
-                 pressure_prop + kbintegration)
+                 pressure_prop + motion_coalesce_prop + palm_prop +
+                 tablet_smoothing_prop + kbintegration)
 
     return grammar
 